@@ -0,0 +1,69 @@
+# Arrow Insert Benchmark
+#
+# Compares inserting the same data from Elixir lists (insert_cols, one
+# append_bulk per column) with inserting it from an Arrow IPC stream
+# (insert_arrow, columns filled straight from the Arrow buffers).
+#
+# The Arrow stream is produced with select_arrow, so Explorer is not needed.
+#
+# Usage:
+#   mix run bench/arrow_insert_bench.exs
+#
+# Requires ClickHouse running:
+#   docker-compose up -d
+
+defmodule ArrowInsertBench do
+  @rows 1_000_000
+
+  @schema [
+    id: :uint64,
+    value: :float64,
+    name: :string,
+    score: {:nullable, :int64},
+    ts: :datetime
+  ]
+
+  @source """
+  SELECT
+    number AS id,
+    number / 7 AS value,
+    concat('name_', toString(number % 1000)) AS name,
+    if(number % 5 = 0, NULL, toInt64(number)) AS score,
+    toDateTime(1700000000 + number, 'UTC') AS ts
+  FROM numbers(#{@rows})
+  """
+
+  def run do
+    IO.puts("\n=== Arrow Insert Benchmark ===")
+    IO.puts("#{@rows} rows x #{length(@schema)} columns\n")
+
+    {:ok, conn} = Natch.start_link(host: "localhost", port: 9000)
+
+    table = "bench_arrow_insert_#{System.unique_integer([:positive])}"
+
+    Natch.execute!(conn, """
+    CREATE TABLE #{table} (
+      id UInt64, value Float64, name String, score Nullable(Int64), ts DateTime
+    ) ENGINE = Null
+    """)
+
+    {:ok, ipc} = Natch.select_arrow(conn, @source)
+    {:ok, columns} = Natch.select_cols(conn, @source)
+
+    IO.puts("Arrow stream: #{Float.round(byte_size(ipc) / 1_048_576, 1)} MiB\n")
+
+    Benchee.run(
+      %{
+        "insert_cols (lists)" => fn -> :ok = Natch.insert_cols(conn, table, columns, @schema) end,
+        "insert_arrow (IPC)" => fn -> :ok = Natch.insert_arrow(conn, table, ipc, @schema) end
+      },
+      time: 10,
+      memory_time: 2,
+      formatters: [Benchee.Formatters.Console]
+    )
+
+    Natch.execute(conn, "DROP TABLE #{table}")
+  end
+end
+
+ArrowInsertBench.run()
@@ -0,0 +1,61 @@
+# Nullable Select Benchmark
+#
+# Measures select_cols on Nullable columns of several nested types at 10%,
+# 50% and 90% NULL rows, against the same columns without Nullable. NULL
+# rows are written as nil without converting the nested value, so the cost
+# should fall as the NULL ratio grows.
+#
+# Usage:
+#   mix run bench/nullable_select_bench.exs
+#
+# Requires ClickHouse running:
+#   docker-compose up -d
+
+defmodule NullableSelectBench do
+  @rows 500_000
+
+  @types [
+    # {name, expression of number}
+    {"Int32", "toInt32(number)"},
+    {"Float64", "number / 3"},
+    {"Date", "toDate(number % 30000)"},
+    {"DateTime64", "toDateTime64(number, 3, 'UTC')"},
+    {"Decimal64", "toDecimal64(number, 4)"},
+    {"UUID", "generateUUIDv4(number)"},
+    {"String", "toString(number)"}
+  ]
+
+  @null_percents [10, 50, 90]
+
+  def run do
+    IO.puts("\n=== Nullable Select Benchmark ===")
+    IO.puts("#{@rows} rows, Nullable(T) at #{Enum.join(@null_percents, "/")}% NULL\n")
+
+    {:ok, conn} = Natch.start_link(host: "localhost", port: 9000)
+
+    for {type, expr} <- @types do
+      IO.puts("\n--- #{type} ---\n")
+
+      plain = {"#{type} (not Nullable)", select_fun(conn, expr)}
+
+      nullable =
+        for percent <- @null_percents do
+          value = "if(rand(number) % 100 < #{percent}, NULL, #{expr})"
+          {"Nullable(#{type}) #{percent}% NULL", select_fun(conn, value)}
+        end
+
+      Benchee.run(Map.new([plain | nullable]),
+        time: 5,
+        memory_time: 1,
+        formatters: [Benchee.Formatters.Console]
+      )
+    end
+  end
+
+  defp select_fun(conn, expr) do
+    sql = "SELECT #{expr} AS v FROM numbers(#{@rows})"
+    fn -> {:ok, _} = Natch.select_cols(conn, sql) end
+  end
+end
+
+NullableSelectBench.run()
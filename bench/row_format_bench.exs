@@ -0,0 +1,88 @@
+# Row Format Benchmark
+#
+# Compares select_rows output shapes: one map per row (the default) against
+# {column_names, rows} with tuple or list rows, on a narrow and a wide
+# result. Also compares converting maps with struct!/2 afterwards against
+# building the structs natively with the :struct option.
+#
+# Usage:
+#   mix run bench/row_format_bench.exs
+#
+# Requires ClickHouse running:
+#   docker-compose up -d
+
+defmodule RowFormatBench.Narrow do
+  defstruct [:c1, :c2, :c3]
+end
+
+defmodule RowFormatBench.Wide do
+  defstruct Enum.map(1..20, &:"c#{&1}")
+end
+
+defmodule RowFormatBench do
+  @rows 200_000
+
+  @shapes [
+    # {name, column count, struct}
+    {"narrow", 3, RowFormatBench.Narrow},
+    {"wide", 20, RowFormatBench.Wide}
+  ]
+
+  def run do
+    IO.puts("\n=== Row Format Benchmark ===")
+    IO.puts("#{@rows} rows, maps vs tuples vs lists\n")
+
+    {:ok, conn} = Natch.start_link(host: "localhost", port: 9000)
+
+    format_jobs =
+      for {shape, columns, _struct} <- @shapes, format <- [:maps, :tuples, :lists], into: %{} do
+        sql = select_sql(columns)
+
+        {"#{shape} (#{columns} cols) #{format}",
+         fn -> {:ok, _} = Natch.select_rows(conn, sql, [], format: format) end}
+      end
+
+    struct_jobs =
+      for {shape, columns, struct} <- @shapes, into: %{} do
+        sql = select_sql(columns)
+
+        {"#{shape} (#{columns} cols) struct!",
+         fn ->
+           {:ok, rows} = Natch.select_rows(conn, sql)
+           Enum.map(rows, &struct!(struct, &1))
+         end}
+      end
+
+    native_struct_jobs =
+      for {shape, columns, struct} <- @shapes, into: %{} do
+        sql = select_sql(columns)
+
+        {"#{shape} (#{columns} cols) struct: option",
+         fn -> {:ok, _} = Natch.select_rows(conn, sql, [], struct: struct) end}
+      end
+
+    jobs = format_jobs |> Map.merge(struct_jobs) |> Map.merge(native_struct_jobs)
+
+    Benchee.run(jobs,
+      time: 10,
+      memory_time: 2,
+      formatters: [Benchee.Formatters.Console]
+    )
+  end
+
+  # Alternating integer, float and string columns
+  defp select_sql(columns) do
+    exprs =
+      for c <- 1..columns do
+        case rem(c, 3) do
+          0 -> "number * #{c} AS c#{c}"
+          1 -> "number / #{c} AS c#{c}"
+          2 -> "toString(number % #{c * 100}) AS c#{c}"
+        end
+      end
+
+    "SELECT #{Enum.join(exprs, ", ")} FROM numbers(#{@rows})"
+  end
+end
+
+RowFormatBench.run()
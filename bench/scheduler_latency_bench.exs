@@ -0,0 +1,154 @@
+# Scheduler Latency Benchmark
+#
+# Measures how a long-running query affects unrelated processes on the node.
+# While a SELECT runs, one "ticker" process per normal scheduler sleeps for
+# 1ms in a loop and records how late it wakes up. Scheduler utilization is
+# sampled over the same window.
+#
+# With NIFs on dirty schedulers the tickers keep waking up on time; with
+# NIFs on normal schedulers every ticker sharing a scheduler with the query
+# stalls for the whole network round-trip and decode. The convert: :yielding
+# scenario converts on a normal scheduler but yields every ~1ms, so tickers
+# stay on time there as well.
+#
+# Usage:
+#   mix run bench/scheduler_latency_bench.exs
+#
+# To get the "before" numbers, rebuild with dirty schedulers disabled:
+#   NATCH_DIRTY_SCHEDULERS=OFF mix compile --force
+#   mix run bench/scheduler_latency_bench.exs
+#
+# Requires ClickHouse running:
+#   docker-compose up -d
+
+defmodule SchedulerLatencyBench do
+  @moduledoc """
+  Latency of unrelated processes while long SELECTs are in flight.
+  """
+
+  @tick_ms 1
+
+  def run do
+    IO.puts("\n=== Scheduler Latency Benchmark ===\n")
+
+    mode = if Natch.Native.dirty_schedulers_enabled(), do: "dirty", else: "normal"
+    IO.puts("NIF scheduler mode:   #{mode}")
+    IO.puts("Normal schedulers:    #{System.schedulers_online()}")
+    IO.puts("Dirty IO schedulers:  #{:erlang.system_info(:dirty_io_schedulers)}")
+    IO.puts("Dirty CPU schedulers: #{:erlang.system_info(:dirty_cpu_schedulers)}\n")
+
+    {:ok, conn} = Natch.start_link(host: "localhost", port: 9000, database: "default")
+
+    scenarios = [
+      {"idle (baseline)", fn -> Process.sleep(2_000) end},
+      {"server-bound SELECT (~2s aggregation)",
+       fn ->
+         {:ok, _} = Natch.select_rows(conn, "SELECT sum(number) FROM numbers(3000000000)")
+       end},
+      {"decode-bound SELECT (5M rows, columnar)",
+       fn ->
+         {:ok, _} =
+           Natch.select_cols(
+             conn,
+             "SELECT number, toString(number) AS s FROM numbers(5000000)"
+           )
+       end},
+      {"decode-bound SELECT (1M rows, row-major)",
+       fn ->
+         {:ok, _} =
+           Natch.select_rows(
+             conn,
+             "SELECT number, toString(number) AS s FROM numbers(1000000)"
+           )
+       end},
+      {"decode-bound SELECT (5M rows, columnar, convert: :yielding)",
+       fn ->
+         {:ok, _} =
+           Natch.select_cols(
+             conn,
+             "SELECT number, toString(number) AS s FROM numbers(5000000)",
+             [],
+             convert: :yielding
+           )
+       end}
+    ]
+
+    for {name, fun} <- scenarios do
+      report(name, measure(fun))
+    end
+
+    GenServer.stop(conn)
+    IO.puts("✓ Benchmark complete!\n")
+  end
+
+  defp measure(fun) do
+    parent = self()
+
+    tickers =
+      for _ <- 1..System.schedulers_online() do
+        spawn_link(fn -> tick_loop(parent, []) end)
+      end
+
+    before = :scheduler.sample_all()
+    {elapsed_us, _} = :timer.tc(fun)
+    after_sample = :scheduler.sample_all()
+
+    lateness =
+      Enum.flat_map(tickers, fn pid ->
+        send(pid, :stop)
+
+        receive do
+          {:lateness, ^pid, samples} -> samples
+        end
+      end)
+
+    %{
+      elapsed_ms: div(elapsed_us, 1000),
+      lateness: Enum.sort(lateness),
+      utilization: :scheduler.utilization(before, after_sample)
+    }
+  end
+
+  defp tick_loop(parent, acc) do
+    start = System.monotonic_time(:microsecond)
+
+    receive do
+      :stop -> send(parent, {:lateness, self(), acc})
+    after
+      @tick_ms ->
+        late = System.monotonic_time(:microsecond) - start - @tick_ms * 1000
+        tick_loop(parent, [max(late, 0) | acc])
+    end
+  end
+
+  defp report(name, %{elapsed_ms: elapsed, lateness: lateness, utilization: util}) do
+    IO.puts("--- #{name} (#{elapsed} ms) ---")
+
+    IO.puts(
+      "  ticker lateness µs: p50=#{pct(lateness, 0.50)} p99=#{pct(lateness, 0.99)} " <>
+        "max=#{List.last(lateness) || 0} samples=#{length(lateness)}"
+    )
+
+    for {kind, label} <- [normal: "normal", cpu: "dirty cpu", io: "dirty io"] do
+      usage =
+        util
+        |> Enum.filter(&match?({^kind, _, _, _}, &1))
+        |> Enum.map(fn {_, _, u, _} -> u end)
+
+      if usage != [] do
+        avg = Enum.sum(usage) / length(usage)
+        IO.puts("  #{String.pad_trailing(label, 9)} utilization: #{Float.round(avg * 100, 1)}%")
+      end
+    end
+
+    IO.puts("")
+  end
+
+  defp pct([], _), do: 0
+
+  defp pct(sorted, p) do
+    Enum.at(sorted, min(length(sorted) - 1, trunc(length(sorted) * p)))
+  end
+end
+
+SchedulerLatencyBench.run()
@@ -0,0 +1,84 @@
+# String Result Benchmark
+#
+# Measures SELECT on 1M-row string tables: time, and how many off-heap
+# (refc) binaries the result holds. Short strings are returned as heap
+# binaries; longer strings are sub-binaries of one refc binary per column
+# per block, so the refc count tracks blocks rather than rows.
+#
+# Usage:
+#   mix run bench/string_select_bench.exs
+#
+# Requires ClickHouse running:
+#   docker-compose up -d
+
+defmodule StringSelectBench do
+  @rows 1_000_000
+
+  @tables [
+    # {name suffix, column expression, description}
+    {"short", "concat('user_', toString(number % 100000))", "short strings (<= 64 bytes)"},
+    {"long", "repeat(toString(number % 10), 200)", "long strings (200 bytes)"},
+    {"mixed", "if(number % 2 = 0, 'ok', repeat('x', 100 + number % 50))",
+     "50/50 short and long"},
+    {"lowcard", "toLowCardinality(concat('region_', toString(number % 20)))", "LowCardinality"}
+  ]
+
+  def run do
+    IO.puts("\n=== String Result Benchmark (#{@rows} rows) ===\n")
+
+    {:ok, conn} = Natch.start_link(host: "localhost", port: 9000)
+
+    tables =
+      for {suffix, expr, desc} <- @tables do
+        table = "bench_strings_#{suffix}_#{System.unique_integer([:positive])}"
+
+        Natch.execute(
+          conn,
+          "CREATE TABLE #{table} ENGINE = Memory AS SELECT #{expr} AS s FROM numbers(#{@rows})"
+        )
+
+        {table, desc}
+      end
+
+    IO.puts("Off-heap binaries held by the result:\n")
+
+    for {table, desc} <- tables do
+      {refc_count, refc_bytes} = measure_refc(conn, table)
+
+      IO.puts(
+        "  #{String.pad_trailing(desc, 30)} #{refc_count} refc binaries, " <>
+          "#{Float.round(refc_bytes / 1_048_576, 1)} MB"
+      )
+    end
+
+    IO.puts("")
+
+    Benchee.run(
+      Map.new(tables, fn {table, desc} ->
+        {"select_cols #{desc}",
+         fn -> {:ok, _} = Natch.select_cols(conn, "SELECT s FROM #{table}") end}
+      end),
+      time: 10,
+      memory_time: 2,
+      formatters: [Benchee.Formatters.Console]
+    )
+
+    for {table, _} <- tables, do: Natch.execute(conn, "DROP TABLE #{table}")
+  end
+
+  # Counts refc binaries referenced by a fresh process holding the result
+  defp measure_refc(conn, table) do
+    task =
+      Task.async(fn ->
+        {:ok, %{s: values}} = Natch.select_cols(conn, "SELECT s FROM #{table}")
+        {:binary, bins} = Process.info(self(), :binary)
+        # Keep the result alive until after measuring
+        _ = length(values)
+        {length(bins), bins |> Enum.map(&elem(&1, 1)) |> Enum.sum()}
+      end)
+
+    Task.await(task, :infinity)
+  end
+end
+
+StringSelectBench.run()
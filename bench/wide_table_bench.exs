@@ -0,0 +1,78 @@
+# Wide Table Conversion Benchmark
+#
+# Measures SELECT on wide tables (many columns of mixed types), comparing
+# sequential block conversion with conversion fanned out over the native
+# conversion thread pool.
+#
+# Usage:
+#   mix run bench/wide_table_bench.exs
+#
+# Requires ClickHouse running:
+#   docker-compose up -d
+
+defmodule WideTableBench do
+  @rows 500_000
+
+  # Repeated groups of mixed column types
+  @column_groups 8
+  @group [
+    {"u", "number"},
+    {"i", "toInt32(number) - 1000"},
+    {"f", "number / 7"},
+    {"s", "concat('value_', toString(number % 1000))"},
+    {"n", "if(number % 5 = 0, NULL, number)"},
+    {"d", "toDateTime(1700000000 + number)"}
+  ]
+
+  @configs [
+    # {name, min_rows, threads}
+    {"sequential", 0, 1},
+    {"parallel x2", 1, 2},
+    {"parallel x4", 1, 4},
+    {"parallel x8", 1, 8}
+  ]
+
+  def run do
+    columns =
+      for g <- 1..@column_groups, {prefix, expr} <- @group do
+        "#{expr} AS #{prefix}#{g}"
+      end
+
+    IO.puts("\n=== Wide Table Conversion Benchmark ===")
+    IO.puts("#{@rows} rows x #{length(columns)} columns\n")
+
+    {:ok, conn} = Natch.start_link(host: "localhost", port: 9000)
+
+    table = "bench_wide_#{System.unique_integer([:positive])}"
+
+    Natch.execute(
+      conn,
+      "CREATE TABLE #{table} ENGINE = Memory AS " <>
+        "SELECT #{Enum.join(columns, ", ")} FROM numbers(#{@rows})"
+    )
+
+    jobs =
+      for {name, min_rows, threads} <- @configs, format <- [:cols, :rows], into: %{} do
+        {"#{format} #{name}",
+         {fn _ -> run_select(conn, table, format) end,
+          before_scenario: fn _ -> Natch.Native.set_parallel_conversion(min_rows, threads) end}}
+      end
+
+    Benchee.run(jobs,
+      time: 10,
+      memory_time: 2,
+      formatters: [Benchee.Formatters.Console]
+    )
+
+    Natch.Native.set_parallel_conversion(20_000, min(System.schedulers_online(), 8))
+    Natch.execute(conn, "DROP TABLE #{table}")
+  end
+
+  defp run_select(conn, table, :cols),
+    do: {:ok, _} = Natch.select_cols(conn, "SELECT * FROM #{table}")
+
+  defp run_select(conn, table, :rows),
+    do: {:ok, _} = Natch.select_rows(conn, "SELECT * FROM #{table}")
+end
+
+WideTableBench.run()
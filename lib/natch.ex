@@ -59,6 +59,23 @@ defmodule Natch do
 
   alias Natch.Connection
 
+  # Nx is an optional dependency used only by select_tensors/3 and
+  # insert_tensors/4
+  @compile {:no_warn_undefined, Nx}
+
+  @tensor_types [
+    uint64: {:u, 64},
+    uint32: {:u, 32},
+    uint16: {:u, 16},
+    uint8: {:u, 8},
+    int64: {:s, 64},
+    int32: {:s, 32},
+    int16: {:s, 16},
+    int8: {:s, 8},
+    float64: {:f, 64},
+    float32: {:f, 32}
+  ]
+
   @type conn :: pid() | atom()
   @type row :: map()
   @type schema :: [{atom(), atom()}]
@@ -126,6 +143,16 @@ defmodule Natch do
     end)
   end
 
+  # Builds a bound Query from SQL, inferring types for untyped placeholders.
+  # Shared with Natch.Async.
+  @doc false
+  def build_query(sql, params) do
+    sql
+    |> add_parameter_types(params)
+    |> Natch.Query.new()
+    |> Natch.Query.bind_all(params)
+  end
+
   # Connection Management
 
   @doc """
@@ -257,6 +284,127 @@ defmodule Natch do
     select_rows(conn, query)
   end
 
+  @doc """
+  Executes a SELECT query in row format with options.
+
+  Pass `[]` as `params` for a query without parameters or a `Natch.Query`.
+
+  ## Options
+
+  - `:format` - the shape of each row:
+    - `:maps` (default) returns `[%{column => value}]` like `select_rows/3`
+    - `:tuples` returns `{column_names, rows}` where each row is a tuple in
+      column order. Column names are sent once instead of as keys of every
+      row, so this is faster and smaller for wide results
+    - `:lists` returns `{column_names, rows}` where each row is a list
+
+  - `:struct` - a struct module. Each row is built natively as that struct,
+    with columns assigned to the fields of the same name and fields without
+    a column left at their defaults, so no `struct!/2` pass over the result
+    is needed. A column that matches no field returns a validation error.
+    Only with the default `:format` and `convert: :dirty`
+
+  - `:fields` - with `:struct`, a keyword list mapping column names to field
+    names where they differ (e.g. `[user_id: :id]`)
+
+  - `:enum` - how `Enum8`/`Enum16` values are returned: `:binary` (default)
+    or `:atom`. Enum names are bounded by the table schema, so atoms do not
+    grow unboundedly. The enum terms are part of the cached conversion plan,
+    so both formats can be used on the same connection
+
+  - `:convert` - where the result is converted to terms:
+    - `:dirty` (default) converts while receiving, in the connection's dirty
+      I/O NIF call
+    - `:yielding` receives the result natively first, then converts it in the
+      calling process on a normal scheduler. Conversion runs in chunks that
+      report their cost to the VM and yield when the timeslice is used up,
+      so multi-million-row results never block a scheduler for more than
+      about a millisecond at a time and the connection is released as soon
+      as the data has arrived
+
+  ## Examples
+
+      {:ok, rows} = Natch.select_rows(conn, "SELECT * FROM events", [], convert: :yielding)
+
+      {:ok, {[:id, :name], [{1, "Alice"}, {2, "Bob"}]}} =
+        Natch.select_rows(conn, "SELECT id, name FROM users", [], format: :tuples)
+
+      {:ok, [%User{id: 1, name: "Alice"} | _]} =
+        Natch.select_rows(conn, "SELECT user_id, name FROM events", [],
+          struct: User,
+          fields: [user_id: :id]
+        )
+  """
+  @spec select_rows(conn(), String.t() | Natch.Query.t(), keyword() | map(), keyword()) ::
+          {:ok, [row()] | [struct()] | {[atom()], [tuple()] | [list()]}} | {:error, term()}
+  def select_rows(conn, query_or_sql, params, opts) do
+    case Keyword.fetch(opts, :struct) do
+      {:ok, module} -> select_structs(conn, query_or_sql, params, module, opts)
+      :error -> select_rows_as(conn, query_or_sql, params, opts)
+    end
+  end
+
+  defp select_rows_as(conn, query_or_sql, params, opts) do
+    enum = enum_option!(opts)
+
+    case {row_format_option!(opts), convert_option!(opts)} do
+      {:maps, :dirty} when enum == :binary ->
+        select_rows_with_params(conn, query_or_sql, params)
+
+      {:maps, :yielding} ->
+        select_yielding(conn, build_select_query(query_or_sql, params), :rows, enum)
+
+      {format, :dirty} ->
+        query = build_select_query(query_or_sql, params)
+        Connection.select_rows_format(conn, query, format, enum)
+
+      {format, :yielding} ->
+        select_yielding(conn, build_select_query(query_or_sql, params), format, enum)
+    end
+  end
+
+  defp select_structs(conn, query_or_sql, params, module, opts) do
+    unless row_format_option!(opts) == :maps and convert_option!(opts) == :dirty do
+      raise ArgumentError, ":struct only supports format: :maps and convert: :dirty"
+    end
+
+    unless is_atom(module) and Code.ensure_loaded?(module) and
+             function_exported?(module, :__struct__, 0) do
+      raise ArgumentError, "#{inspect(module)} is not a struct module"
+    end
+
+    fields = module.__struct__() |> Map.from_struct() |> Map.to_list()
+    mapping = Keyword.get(opts, :fields, [])
+    query = build_select_query(query_or_sql, params)
+    Connection.select_structs(conn, query, module, fields, mapping, enum_option!(opts))
+  end
+
+  defp row_format_option!(opts) do
+    case Keyword.get(opts, :format, :maps) do
+      format when format in [:maps, :tuples, :lists] ->
+        format
+
+      other ->
+        raise ArgumentError,
+              "invalid :format #{inspect(other)}, expected :maps, :tuples or :lists"
+    end
+  end
+
+  defp enum_option!(opts) do
+    case Keyword.get(opts, :enum, :binary) do
+      enum when enum in [:binary, :atom] ->
+        enum
+
+      other ->
+        raise ArgumentError, "invalid :enum #{inspect(other)}, expected :binary or :atom"
+    end
+  end
+
+  defp select_rows_with_params(conn, query_or_sql, params) when params in [[], %{}],
+    do: select_rows(conn, query_or_sql)
+
+  defp select_rows_with_params(conn, sql, params), do: select_rows(conn, sql, params)
+
   @doc """
   Executes a SELECT query and returns results in row format, raising on error.
 
@@ -353,6 +501,110 @@ defmodule Natch do
     select_cols(conn, query)
   end
 
+  @doc """
+  Executes a SELECT query in columnar format with options.
+
+  Pass `[]` as `params` for a query without parameters or a `Natch.Query`.
+
+  ## Options
+
+  - `:format` - `:lists` (default) returns `%{column => [values]}` like
+    `select_cols/3`. `:binary` returns each fixed-width column as a single
+    native-endian binary instead of a list, which costs one term per column
+    rather than one per value:
+    - integers and floats of every width are packed at their ClickHouse width
+    - `Date` as UInt16 days, `DateTime` as UInt32 seconds, `DateTime64` as
+      Int64 ticks and `Decimal` as the Int64 scaled value
+    - `Nullable` fixed-width columns become `{values, null_map}` where
+      `null_map` has one byte per row (1 = NULL) and NULL slots in `values`
+      hold zero
+    - `LowCardinality` columns become `{dictionary, indices}`: the distinct
+      values as a list (with `nil` for `LowCardinality(Nullable(T))`) and a
+      binary of one UInt32 dictionary index per row
+    - other types (strings, arrays, maps, ...) are returned as lists
+
+  Integer and float binaries reference the native column buffer directly, so
+  no copy is made on the way to Elixir.
+
+  - `:convert` - `:dirty` (default) or `:yielding`, as in `select_rows/4`.
+    Only applies to the `:lists` format.
+
+  - `:enum` - `:binary` (default) or `:atom`, as in `select_rows/4`. Only
+    applies to the `:lists` format.
+
+  ## Examples
+
+      {:ok, %{id: ids, price: prices}} =
+        Natch.select_cols(conn, "SELECT id, price FROM trades", [], format: :binary)
+
+      for <<id::unsigned-native-64 <- ids>>, do: id
+
+      # Nx.from_binary(prices, :f64)
+  """
+  @spec select_cols(conn(), String.t() | Natch.Query.t(), keyword() | map(), keyword()) ::
+          {:ok, map()} | {:error, term()}
+  def select_cols(conn, query_or_sql, params, opts) do
+    enum = enum_option!(opts)
+
+    case Keyword.get(opts, :format, :lists) do
+      :lists ->
+        case {convert_option!(opts), enum} do
+          {:dirty, :binary} ->
+            select_cols_with_params(conn, query_or_sql, params)
+
+          {:dirty, enum} ->
+            select_cols_enum(conn, build_select_query(query_or_sql, params), enum)
+
+          {:yielding, enum} ->
+            select_yielding(conn, build_select_query(query_or_sql, params), :columns, enum)
+        end
+
+      :binary when enum == :binary ->
+        Connection.select_cols_binary(conn, build_select_query(query_or_sql, params))
+
+      :binary ->
+        raise ArgumentError, ":enum only supports format: :lists"
+
+      other ->
+        raise ArgumentError, "invalid :format #{inspect(other)}, expected :lists or :binary"
+    end
+  end
+
+  defp select_cols_with_params(conn, query_or_sql, params) when params in [[], %{}],
+    do: select_cols(conn, query_or_sql)
+
+  defp select_cols_with_params(conn, sql, params), do: select_cols(conn, sql, params)
+
+  defp select_cols_enum(conn, %Natch.Query{} = query, enum),
+    do: Connection.select_cols_parameterized(conn, query, enum)
+
+  defp select_cols_enum(conn, sql, enum), do: Connection.select_cols(conn, sql, enum)
+
+  defp convert_option!(opts) do
+    case Keyword.get(opts, :convert, :dirty) do
+      convert when convert in [:dirty, :yielding] ->
+        convert
+
+      other ->
+        raise ArgumentError, "invalid :convert #{inspect(other)}, expected :dirty or :yielding"
+    end
+  end
+
+  # Receive the result on the connection, then convert it in the caller
+  defp select_yielding(conn, query, format, enum) do
+    with {:ok, blocks} <- Connection.select_blocks(conn, query, enum) do
+      try do
+        {:ok, Natch.Native.result_blocks_to_terms(blocks, format)}
+      rescue
+        e -> Natch.Error.handle_callback_error(e)
+      end
+    end
+  end
+
+  defp build_select_query(%Natch.Query{} = query, _params), do: query
+  defp build_select_query(sql, params) when is_binary(sql) and params in [[], %{}], do: sql
+  defp build_select_query(sql, params) when is_binary(sql), do: build_query(sql, params)
+
   @doc """
   Executes a SELECT query and returns results in columnar format, raising on error.
 
@@ -375,6 +627,177 @@ defmodule Natch do
     end
   end
 
+  @doc """
+  Executes a SELECT query and keeps the result in native memory as a
+  `Natch.ResultSet`, decoding nothing up front.
+
+  Use it when only part of a result is read: a few columns of a wide table,
+  the row count, or pages of rows. See `Natch.ResultSet` for the accessors.
+  `params` works as in `select_rows/3`.
+
+  ## Examples
+
+      {:ok, result} = Natch.select_result(conn, "SELECT * FROM events")
+      ids = Natch.ResultSet.column(result, :id)
+
+      {:ok, result} =
+        Natch.select_result(conn, "SELECT * FROM events WHERE day = {day}",
+          day: ~D[2024-01-01]
+        )
+
+      Natch.ResultSet.slice(result, 0, 100)
+  """
+  @spec select_result(conn(), String.t() | Natch.Query.t(), keyword() | map()) ::
+          {:ok, Natch.ResultSet.t()} | {:error, term()}
+  def select_result(conn, query_or_sql, params \\ []) do
+    with {:ok, ref} <- Connection.select_blocks(conn, build_select_query(query_or_sql, params)) do
+      {:ok, Natch.ResultSet.wrap(ref)}
+    end
+  end
+
+  @doc """
+  Executes a SELECT query and returns the result as an
+  [Arrow IPC stream](https://arrow.apache.org/docs/format/Columnar.html#ipc-streaming-format)
+  binary, encoded natively without creating a term per value.
+
+  Each ClickHouse block becomes one record batch. The binary can be loaded
+  with `Explorer.DataFrame.load_ipc_stream!/1` or any Arrow reader.
+  `params` works as in `select_rows/3`.
+
+  Supported column types:
+
+  - `(U)Int8`..`(U)Int64`, `Float32`, `Float64`
+  - `String`, `UUID` and `Enum8`/`Enum16` (as strings)
+  - `Date` (date32), `DateTime` (timestamp in seconds with the column's
+    timezone) and `DateTime64` (timestamp in ms, us or ns)
+  - `Decimal` (decimal128)
+  - `Nullable(T)`, `Array(T)` (list) and `LowCardinality(String)`
+    (dictionary-encoded string)
+
+  Other types return `{:error, %{type: "validation", message: ...}}`.
+
+  ## Examples
+
+      {:ok, ipc} = Natch.select_arrow(conn, "SELECT * FROM events")
+      df = Explorer.DataFrame.load_ipc_stream!(ipc)
+  """
+  @spec select_arrow(conn(), String.t() | Natch.Query.t(), keyword() | map()) ::
+          {:ok, binary()} | {:error, term()}
+  def select_arrow(conn, query_or_sql, params \\ []) do
+    Connection.select_arrow(conn, build_select_query(query_or_sql, params))
+  end
+
+  @doc """
+  Executes a SELECT query and returns each column as a one-dimensional
+  `Nx.Tensor`.
+
+  Blocks are appended into a single contiguous buffer per column natively and
+  handed to `Nx.from_binary/2` without creating a term per value. Only
+  `(U)Int8`..`(U)Int64`, `Float32` and `Float64` columns are supported; other
+  types return `{:error, %{type: "validation", message: ...}}`.
+
+  Nx is an optional dependency of Natch; add `{:nx, "~> 0.7"}` to your own deps to
+  use this function. `params` works as in `select_rows/3`.
+
+  ## Examples
+
+      {:ok, %{x: x, y: y}} =
+        Natch.select_tensors(conn, "SELECT x, y FROM points WHERE id < {n}", n: 1000)
+
+      Nx.dot(x, y)
+  """
+  @spec select_tensors(conn(), String.t() | Natch.Query.t(), keyword() | map()) ::
+          {:ok, %{atom() => Nx.Tensor.t()}} | {:error, term()}
+  def select_tensors(conn, query_or_sql, params \\ []) do
+    ensure_nx!()
+
+    with {:ok, columns} <-
+           Connection.select_tensors(conn, build_select_query(query_or_sql, params)) do
+      {:ok, Map.new(columns, fn {name, {type, data}} -> {name, Nx.from_binary(data, type)} end)}
+    end
+  end
+
+  @doc """
+  Streams the results of a SELECT query one block at a time.
+
+  Returns a lazy `Stream`. The query starts when the stream is first consumed
+  and ClickHouse blocks are converted only as they are pulled, so memory stays
+  proportional to a block (typically ~65k rows) instead of the whole result.
+  Halting the stream early (e.g. `Enum.take/2`) cancels the query.
+
+  While the stream is open the connection is busy: other queries on the same
+  connection return `{:error, %{type: "validation", message: message}}`,
+  with a message saying the connection is busy, until the stream is
+  finished. Use a separate connection to run queries while consuming a
+  stream.
+
+  ## Options
+
+  - `:format` - `:rows` (default) emits one map per row; `:columns` emits one
+    columnar map (`%{column => [values]}`) per block
+  - `:params` - Query parameters (keyword list or map), as in `select_rows/3`
+
+  ## Examples
+
+      # Export a large table without holding it in memory
+      Natch.stream(conn, "SELECT * FROM events")
+      |> Stream.map(&Jason.encode!/1)
+      |> Stream.into(File.stream!("events.jsonl"))
+      |> Stream.run()
+
+      # Process column blocks
+      conn
+      |> Natch.stream("SELECT value FROM metrics WHERE day = {day}",
+        params: [day: ~D[2024-01-01]],
+        format: :columns
+      )
+      |> Enum.reduce(0, fn %{value: values}, acc -> acc + Enum.sum(values) end)
+  """
+  @spec stream(conn(), String.t() | Natch.Query.t(), keyword()) :: Enumerable.t()
+  def stream(conn, query_or_sql, opts \\ []) do
+    format = Keyword.get(opts, :format, :rows)
+
+    unless format in [:rows, :columns] do
+      raise ArgumentError, "Invalid :format #{inspect(format)}, expected :rows or :columns"
+    end
+
+    query =
+      case {query_or_sql, Keyword.get(opts, :params)} do
+        {sql, params} when is_binary(sql) and params not in [nil, [], %{}] ->
+          build_query(sql, params)
+
+        {query, _} ->
+          query
+      end
+
+    Stream.resource(
+      fn -> open_cursor(conn, query, format) end,
+      fn cursor -> next_block(cursor, format) end,
+      &Natch.Native.cursor_close/1
+    )
+  end
+
+  defp open_cursor(conn, query, format) do
+    {:ok, client} = Connection.get_client(conn)
+
+    case query do
+      %Natch.Query{ref: ref} -> Natch.Native.client_select_open_parameterized(client, ref, format)
+      sql when is_binary(sql) -> Natch.Native.client_select_open(client, sql, format)
+    end
+  rescue
+    e -> Natch.Error.handle_nif_error(e)
+  end
+
+  defp next_block(cursor, format) do
+    case Natch.Native.cursor_next_block(cursor) do
+      :done -> {:halt, cursor}
+      rows when format == :rows -> {rows, cursor}
+      columns -> {[columns], cursor}
+    end
+  rescue
+    e -> Natch.Error.handle_nif_error(e)
+  end
+
   @doc """
   Executes a DDL or DML statement without returning results.
 
@@ -469,13 +892,16 @@ defmodule Natch do
   # Insert Operations
 
   @doc """
-  Inserts data in row format (list of maps).
+  Inserts data in row format (list of maps or tuples).
 
-  Convenience wrapper that converts rows to columnar format before inserting.
+  Rows are walked once in native code and each value is decoded straight into
+  its typed column, so there is no intermediate transposition into column
+  lists. Tuple rows list their values in schema order. Columns of nested
+  types (arrays, tuples, maps, enums, decimals) are still extracted in Elixir
+  and built with the columnar path. See `Natch.Block.build_block_from_rows/2`.
 
-  **Performance Note:** For bulk operations (1000+ rows), prefer `insert_cols/4`
-  which avoids the O(N*M) conversion overhead. The conversion from rows to columns
-  requires touching every value, making it less efficient for large datasets.
+  **Performance Note:** `insert_cols/4` remains the fastest option when the data
+  is already columnar, and it accepts packed binaries for fixed-width types.
 
   ## Examples
 
@@ -493,11 +919,19 @@ defmodule Natch do
         %{"id" => 2, "name" => "Bob"}
       ]
       :ok = Natch.insert_rows(conn, "users", rows, schema)
+
+      # Tuples in schema order
+      rows = [{1, "Alice"}, {2, "Bob"}]
+      :ok = Natch.insert_rows(conn, "users", rows, schema)
   """
-  @spec insert_rows(conn(), String.t(), [map()], schema()) :: :ok | {:error, term()}
+  @spec insert_rows(conn(), String.t(), [map() | tuple()], schema()) :: :ok | {:error, term()}
   def insert_rows(conn, table, rows, schema) when is_list(rows) and is_list(schema) do
-    columns = Natch.Conversion.rows_to_columns(rows, schema)
-    insert_cols(conn, table, columns, schema)
+    # Built in the caller so the rows are not copied into the connection
+    # process; only the block reference is sent
+    block = Natch.Block.build_block_from_rows(rows, schema)
+    GenServer.call(conn, {:insert_block, table, block}, :infinity)
+  rescue
+    e -> Natch.Error.handle_callback_error(e)
   end
 
   @doc """
@@ -509,7 +943,7 @@ defmodule Natch do
       schema = [id: :uint64, name: :string]
       Natch.insert_rows!(conn, "users", rows, schema)
   """
-  @spec insert_rows!(conn(), String.t(), [map()], schema()) :: :ok
+  @spec insert_rows!(conn(), String.t(), [map() | tuple()], schema()) :: :ok
   def insert_rows!(conn, table, rows, schema) do
     case insert_rows(conn, table, rows, schema) do
       :ok -> :ok
@@ -535,7 +969,7 @@ defmodule Natch do
 
   For 10,000 rows × 10 columns:
   - `insert_cols`: 10 NIF calls (one per column)
-  - `insert_rows`: 10 NIF calls + 100,000 cell conversions
+  - `insert_rows`: 1 NIF call that decodes all 100,000 cells from the row terms
 
   ## Examples
 
@@ -593,4 +1027,200 @@ defmodule Natch do
       {:error, reason} -> raise "Insert failed: #{inspect(reason)}"
     end
   end
+
+  @doc """
+  Inserts an Arrow IPC stream binary, such as one produced by
+  `Explorer.DataFrame.dump_ipc_stream!/1`, into a table.
+
+  The schema lists the columns to insert with their ClickHouse types, as in
+  `insert_cols/4`; each is filled from the Arrow field with the same name and
+  other fields are ignored. All record batches are inserted as one block.
+
+  Values are read straight from the Arrow buffers without creating Elixir
+  terms:
+
+  - integer and float fields go into numeric columns with one memcpy when
+    the widths match and are cast otherwise (booleans become 0/1); float
+    fields only go into float columns, and integers that do not fit the
+    column are an error
+  - utf8, binary, their large and view variants, fixed-size binary and
+    string dictionaries go into `String`, `FixedString`, `Enum` and
+    `LowCardinality` columns
+  - date32/date64 and timestamps in any unit go into `Date`, `DateTime` and
+    `DateTime64` columns, rescaled to the column's unit (dates and times
+    outside the column's range are an error)
+  - decimal128 goes into `Decimal` columns of the same or a larger scale, as
+    long as the rescaled value fits the column's precision
+  - lists (list, large_list, fixed_size_list) go into `Array` columns
+  - validity bitmaps become the null map of `Nullable` columns; NULLs in a
+    field inserted into a non-Nullable column are an error
+
+  ## Examples
+
+      ipc = Explorer.DataFrame.dump_ipc_stream!(df)
+
+      :ok =
+        Natch.insert_arrow(conn, "events", ipc,
+          id: :uint64,
+          name: :string,
+          score: {:nullable, :float64},
+          tags: {:array, :string}
+        )
+  """
+  @spec insert_arrow(conn(), String.t(), binary(), schema()) :: :ok | {:error, term()}
+  def insert_arrow(conn, table, ipc, schema) when is_binary(ipc) and is_list(schema) do
+    GenServer.call(conn, {:insert_arrow, table, ipc, schema}, :infinity)
+  end
+
+  @doc """
+  Inserts one-dimensional `Nx.Tensor`s as columns of a table.
+
+  Each tensor's binary is copied into its column with a single memcpy (the
+  packed binary path of `insert_cols/4`). When `schema` is omitted it is
+  derived from the tensor types (`{:u, 64}` -> `:uint64`, `{:s, 32}` ->
+  `:int32`, `{:f, 64}` -> `:float64`, ...). A tensor whose type does not match
+  its schema type raises `ArgumentError`; convert it with `Nx.as_type/2`
+  first.
+
+  Nx is an optional dependency of Natch; add `{:nx, "~> 0.7"}` to your own deps to
+  use this function.
+
+  ## Examples
+
+      :ok = Natch.insert_tensors(conn, "points", %{x: Nx.iota({1000}), y: Nx.iota({1000})})
+  """
+  @spec insert_tensors(conn(), String.t(), map(), schema() | nil) :: :ok | {:error, term()}
+  def insert_tensors(conn, table, tensors, schema \\ nil) when is_map(tensors) do
+    ensure_nx!()
+    schema = schema || Enum.map(tensors, fn {name, t} -> {name, schema_type(Nx.type(t))} end)
+
+    columns =
+      Map.new(schema, fn {name, type} ->
+        tensor = Map.fetch!(tensors, name)
+        {name, tensor_binary(name, tensor, type)}
+      end)
+
+    insert_cols(conn, table, columns, schema)
+  end
+
+  defp ensure_nx! do
+    unless Code.ensure_loaded?(Nx) do
+      raise "Nx is not available, add {:nx, \"~> 0.7\"} to your dependencies"
+    end
+  end
+
+  defp schema_type(nx_type) do
+    case List.keyfind(@tensor_types, nx_type, 1) do
+      {type, _} -> type
+      nil -> raise ArgumentError, "tensors of type #{inspect(nx_type)} cannot be inserted"
+    end
+  end
+
+  defp tensor_binary(name, tensor, type) do
+    expected = Keyword.get(@tensor_types, type)
+
+    cond do
+      expected == nil ->
+        raise ArgumentError, "column #{name} has type #{inspect(type)}, not a numeric type"
+
+      Nx.type(tensor) != expected ->
+        raise ArgumentError,
+              "column #{name} expects a #{inspect(expected)} tensor, " <>
+                "got #{inspect(Nx.type(tensor))} (use Nx.as_type/2)"
+
+      Nx.rank(tensor) != 1 ->
+        raise ArgumentError, "column #{name} expects a one-dimensional tensor"
+
+      true ->
+        Nx.to_binary(tensor)
+    end
+  end
+
+  @doc """
+  Inserts data from an enumerable as a single streaming INSERT.
+
+  One INSERT statement is opened and the enumerable is consumed lazily: each
+  batch is built into a block and sent to the server before the next one is
+  pulled, so memory stays proportional to a block and the server sees one
+  INSERT with many blocks (instead of one query and one part per chunk).
+
+  The INSERT runs in the calling process. While it is open the connection is
+  busy: other queries on the same connection return
+  `{:error, %{type: "validation", message: message}}` until it completes.
+  If building or sending a block fails, or the enumerable raises, the INSERT
+  is aborted by resetting the connection and an error is returned. Blocks
+  the server has already received may still be written to the table, so a
+  failed stream can leave part of its data behind; use a staging table or
+  deduplication if that matters.
+
+  ## Options
+
+  - `:format` - `:rows` (default) takes rows (maps or tuples, as in
+    `insert_rows/4`) and groups them into blocks of `:batch_size` rows;
+    `:columns` takes columnar maps (as in `insert_cols/4`), one block each
+  - `:batch_size` - Rows per block in `:rows` format (default: 65_536)
+
+  ## Examples
+
+      # Load a large file with bounded memory
+      File.stream!("events.jsonl")
+      |> Stream.map(&Jason.decode!/1)
+      |> then(&Natch.insert_stream(conn, "events", &1, [id: :uint64, name: :string]))
+
+      # Send pre-built column chunks
+      chunks = Stream.map(1..100, fn i -> %{id: Enum.to_list((i * 1000)..(i * 1000 + 999))} end)
+      :ok = Natch.insert_stream(conn, "ids", chunks, [id: :uint64], format: :columns)
+  """
+  @spec insert_stream(conn(), String.t(), Enumerable.t(), schema(), keyword()) ::
+          :ok | {:error, term()}
+  def insert_stream(conn, table, enumerable, schema, opts \\ []) when is_list(schema) do
+    format = Keyword.get(opts, :format, :rows)
+    batch_size = Keyword.get(opts, :batch_size, 65_536)
+
+    unless format in [:rows, :columns] do
+      raise ArgumentError, "Invalid :format #{inspect(format)}, expected :rows or :columns"
+    end
+
+    blocks =
+      case format do
+        :rows ->
+          enumerable
+          |> Stream.chunk_every(batch_size)
+          |> Stream.map(&Natch.Block.build_block_from_rows(&1, schema))
+
+        :columns ->
+          Stream.map(enumerable, &Natch.Block.build_block(&1, schema))
+      end
+
+    send_insert_stream(conn, table, blocks, schema)
+  end
+
+  defp send_insert_stream(conn, table, blocks, schema) do
+    {:ok, client} = Connection.get_client(conn)
+    columns = Enum.map(schema, fn {name, _type} -> to_string(name) end)
+    session = Natch.Native.client_insert_begin(client, table, columns)
+
+    try do
+      Enum.each(blocks, &Natch.Native.insert_session_send_block(session, &1))
+      Natch.Native.insert_session_finish(session)
+      :ok
+    after
+      Natch.Native.insert_session_close(session)
+    end
+  rescue
+    e -> Natch.Error.handle_callback_error(e)
+  end
+
+  @doc """
+  Inserts data from an enumerable as a single streaming INSERT, raising on error.
+
+  See `insert_stream/5`.
+  """
+  @spec insert_stream!(conn(), String.t(), Enumerable.t(), schema(), keyword()) :: :ok
+  def insert_stream!(conn, table, enumerable, schema, opts \\ []) do
+    case insert_stream(conn, table, enumerable, schema, opts) do
+      :ok -> :ok
+      {:error, reason} -> raise "Insert failed: #{inspect(reason)}"
+    end
+  end
 end
@@ -7,6 +7,8 @@ defmodule Natch.Application do
 
   @impl true
   def start(_type, _args) do
+    configure_parallel_conversion(Application.get_env(:natch, :parallel_conversion, []))
+
     children = [
       # Starts a worker by calling: Natch.Worker.start_link(arg)
       # {Natch.Worker, arg}
@@ -17,4 +19,14 @@ defmodule Natch.Application do
     opts = [strategy: :one_for_one, name: Natch.Supervisor]
     Supervisor.start_link(children, opts)
   end
+
+  # Result blocks with at least :min_rows rows are converted to terms on
+  # :threads native threads. Unset keys fall back to the defaults.
+  defp configure_parallel_conversion([]), do: :ok
+
+  defp configure_parallel_conversion(opts) do
+    min_rows = Keyword.get(opts, :min_rows, 20_000)
+    threads = Keyword.get(opts, :threads, min(System.schedulers_online(), 8))
+    Natch.Native.set_parallel_conversion(min_rows, threads)
+  end
 end
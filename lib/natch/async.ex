@@ -0,0 +1,115 @@
+defmodule Natch.Async do
+  @moduledoc """
+  Asynchronous query execution.
+
+  Each function queues the request on the connection's native worker thread
+  and returns a request reference immediately. The worker runs the query,
+  builds the result and sends it directly to the calling process, so results
+  are never copied through the `Natch.Connection` GenServer and the caller's
+  scheduler is free while the query runs.
+
+  Requests on one connection run one at a time in submission order, so a
+  single connection can pipeline requests from many processes.
+
+  Use `await/2` in the calling process to receive the result. The reply is a
+  message of the form `{:natch_async, ref, result}`, which can also be
+  matched directly in a `receive` or `handle_info/2`.
+
+  ## Examples
+
+      ref = Natch.Async.select_rows(conn, "SELECT * FROM events WHERE id > {id}", id: 100)
+      # ... do other work ...
+      {:ok, rows} = Natch.Async.await(ref)
+
+      # Fan out several queries on one connection
+      refs = for day <- days, do: Natch.Async.select_cols(conn, query_for(day))
+      results = Enum.map(refs, &Natch.Async.await/1)
+  """
+
+  alias Natch.{Connection, Native}
+
+  @doc """
+  Queues a SELECT returning rows (list of maps). See `Natch.select_rows/3`.
+  """
+  @spec select_rows(Natch.conn(), String.t() | Natch.Query.t(), keyword() | map()) :: reference()
+  def select_rows(conn, query_or_sql, params \\ []) do
+    select(conn, query_or_sql, params, :rows)
+  end
+
+  @doc """
+  Queues a SELECT returning columns (map of lists). See `Natch.select_cols/3`.
+  """
+  @spec select_cols(Natch.conn(), String.t() | Natch.Query.t(), keyword() | map()) ::
+          reference()
+  def select_cols(conn, query_or_sql, params \\ []) do
+    select(conn, query_or_sql, params, :columns)
+  end
+
+  @doc """
+  Queues a DDL or DML statement. See `Natch.execute/3`.
+  """
+  @spec execute(Natch.conn(), String.t() | Natch.Query.t(), keyword() | map()) :: reference()
+  def execute(conn, query_or_sql, params \\ []) do
+    client = client!(conn)
+
+    case build(query_or_sql, params) do
+      %Natch.Query{ref: ref} -> Native.client_execute_async_parameterized(client, ref)
+      sql -> Native.client_execute_async(client, sql)
+    end
+  end
+
+  @doc """
+  Queues an insert of columnar data. See `Natch.insert_cols/4`.
+
+  The block is built in the calling process before the request is queued,
+  so validation errors are raised immediately.
+  """
+  @spec insert_cols(Natch.conn(), String.t(), map(), Natch.schema()) :: reference()
+  def insert_cols(conn, table, columns, schema) when is_map(columns) and is_list(schema) do
+    client = client!(conn)
+    block = Natch.Block.build_block(columns, schema)
+    Native.client_insert_async(client, table, block)
+  end
+
+  @doc """
+  Waits for the result of an async request.
+
+  Must be called from the process that issued the request. Returns the same
+  shapes as the synchronous API: `{:ok, result}` for selects, `:ok` for
+  execute and insert, `{:error, reason}` on failure. Exits if no reply
+  arrives within `timeout`.
+  """
+  @spec await(reference(), timeout()) :: :ok | {:ok, term()} | {:error, term()}
+  def await(ref, timeout \\ :infinity) when is_reference(ref) do
+    receive do
+      {:natch_async, ^ref, result} -> handle_reply(result)
+    after
+      timeout -> exit({:timeout, {__MODULE__, :await, [ref, timeout]}})
+    end
+  end
+
+  defp select(conn, query_or_sql, params, format) do
+    client = client!(conn)
+
+    case build(query_or_sql, params) do
+      %Natch.Query{ref: ref} -> Native.client_select_async_parameterized(client, ref, format)
+      sql -> Native.client_select_async(client, sql, format)
+    end
+  end
+
+  defp build(%Natch.Query{} = query, _params), do: query
+  defp build(sql, params) when is_binary(sql) and params in [[], %{}], do: sql
+  defp build(sql, params) when is_binary(sql), do: Natch.build_query(sql, params)
+
+  defp client!(conn) do
+    {:ok, client} = Connection.get_client(conn)
+    client
+  end
+
+  defp handle_reply({:ok, :ok}), do: :ok
+  defp handle_reply({:ok, result}), do: {:ok, result}
+
+  defp handle_reply({:error, json}) do
+    Natch.Error.handle_callback_error(%RuntimeError{message: json})
+  end
+end
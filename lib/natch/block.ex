@@ -25,7 +25,8 @@ defmodule Natch.Block do
   - **Matches ClickHouse native format** (no transposition needed)
   - **Natural for analytics** (operate on columns, not rows)
 
-  If you have row-oriented data, use `Natch.Conversion.rows_to_columns/2`.
+  If you have row-oriented data, use `build_block_from_rows/2`, which decodes
+  rows natively without transposing them first.
   """
 
   alias Natch.{Column, Native}
@@ -39,7 +40,9 @@ defmodule Natch.Block do
 
   ## Parameters
 
-  - `columns` - Map of column_name => [values]
+  - `columns` - Map of column_name => [values], or a packed native-endian
+    binary for fixed-width columns (`{values, null_map}` for Nullable ones,
+    see `Natch.Column.append_binary/2`)
   - `schema` - Keyword list mapping column names to types
 
   ## Schema Types
@@ -76,6 +79,84 @@ defmodule Natch.Block do
     e -> Natch.Error.handle_nif_error(e)
   end
 
+  @doc """
+  Builds a Block from row-oriented data and schema.
+
+  Rows may be maps (atom or string keys) or tuples whose elements follow the
+  schema order. Scalar columns (see `Natch.Column.row_type?/1`) are decoded in
+  a single native pass over the rows, without transposing them into column
+  lists first. Remaining columns (arrays, tuples, maps, decimals, ...)
+  are extracted in Elixir and built with `build_columns_bulk/2`. Either way
+  the block's columns follow the schema order.
+
+  ## Examples
+
+      rows = [%{id: 1, name: "Alice"}, {2, "Bob"}]
+      schema = [id: :uint64, name: :string]
+      block = Natch.Block.build_block_from_rows(rows, schema)
+  """
+  @spec build_block_from_rows([map() | tuple()], keyword()) :: reference()
+  def build_block_from_rows(rows, schema) when is_list(rows) and is_list(schema) do
+    {native, fallback} =
+      schema
+      |> Enum.with_index()
+      |> Enum.split_with(fn {{_name, type}, _position} -> Column.row_type?(type) end)
+
+    native_columns =
+      for {{name, type}, position} <- native do
+        {name, position, Column.clickhouse_type(type)}
+      end
+
+    columns =
+      Map.new(fallback, fn {{name, _type}, position} ->
+        {name, Enum.map(rows, &row_value(&1, name, position))}
+      end)
+
+    fallback_schema = Enum.map(fallback, fn {column, _position} -> column end)
+
+    # Built before the native pass, which places every column at its schema
+    # position
+    prebuilt_columns =
+      for {{name, column_ref}, {_column, position}} <-
+            Enum.zip(build_columns_bulk(columns, fallback_schema), fallback) do
+        {name, position, column_ref}
+      end
+
+    Native.block_from_rows(rows, native_columns, prebuilt_columns, length(schema))
+  rescue
+    e -> Natch.Error.handle_nif_error(e)
+  end
+
+  @doc """
+  Builds a block from an Arrow IPC stream binary.
+
+  Each schema column is filled from the Arrow field with the same name, with
+  the values of every record batch appended in order; other fields are
+  ignored. Values are read directly from the Arrow buffers in native code.
+  See `Natch.insert_arrow/4` for the supported types.
+
+  ## Examples
+
+      ipc = Explorer.DataFrame.dump_ipc_stream!(df)
+      block = Natch.Block.build_block_from_arrow(ipc, id: :uint64, name: :string)
+  """
+  @spec build_block_from_arrow(binary(), keyword()) :: reference()
+  def build_block_from_arrow(ipc, schema) when is_binary(ipc) and is_list(schema) do
+    columns = for {name, type} <- schema, do: {to_string(name), Column.clickhouse_type(type)}
+    Native.block_from_arrow(ipc, columns)
+  rescue
+    e -> Natch.Error.handle_nif_error(e)
+  end
+
+  defp row_value(row, _name, position) when is_tuple(row), do: elem(row, position)
+
+  defp row_value(row, name, _position) when is_map(row) do
+    case Map.fetch(row, name) do
+      {:ok, value} -> value
+      :error -> Map.fetch!(row, to_string(name))
+    end
+  end
+
   @doc """
   Builds columns from columnar data using bulk append operations.
 
@@ -111,6 +192,13 @@ defmodule Natch.Block do
           raise ArgumentError,
                 "Missing column #{inspect(name)} in columns #{inspect(Map.keys(columns))}"
 
+        (is_binary(values) or is_tuple(values)) and Column.binary_type?(type) ->
+          # Packed native-endian values for fixed-width types, with a null
+          # map for Nullable ones
+          column = Column.new(type)
+          Column.append_binary(column, values)
+          {name, column.ref}
+
         not is_list(values) ->
           raise ArgumentError,
                 "Column #{inspect(name)} must be a list, got: #{inspect(values)}"
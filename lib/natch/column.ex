@@ -24,6 +24,7 @@ defmodule Natch.Column do
   - `:uint64` - UInt64
   - `:uint32` - UInt32
   - `:uint16` - UInt16
+  - `:uint8` - UInt8
   - `:int64` - Int64
   - `:int32` - Int32
   - `:int16` - Int16
@@ -77,11 +78,18 @@ defmodule Natch.Column do
     }
   end
 
+  @legacy_nullable_types [:nullable_uint64, :nullable_int64, :nullable_string, :nullable_float64]
+
+  defguardp is_nullable_type(type)
+            when type in @legacy_nullable_types or
+                   (is_tuple(type) and tuple_size(type) == 2 and elem(type, 0) == :nullable)
+
   @doc """
   Appends multiple values to the column in bulk (single NIF call).
 
   This is the primary, high-performance API. Values must be a list matching
-  the column type.
+  the column type. `Nullable(T)` columns of any supported `T` take `nil` for
+  NULL rows; the other values go through the bulk append of `T`.
 
   ## Examples
 
@@ -208,6 +216,14 @@ defmodule Natch.Column do
     Native.column_uint16_append_bulk(ref, values)
   end
 
+  def append_bulk(%__MODULE__{type: :uint8, ref: ref}, values) when is_list(values) do
+    unless Enum.all?(values, &(is_integer(&1) and &1 >= 0 and &1 <= 255)) do
+      raise ArgumentError, "All values must be non-negative integers 0..255 for UInt8 column"
+    end
+
+    Native.column_uint8_append_bulk(ref, values)
+  end
+
   def append_bulk(%__MODULE__{type: :int32, ref: ref}, values) when is_list(values) do
     unless Enum.all?(values, &(is_integer(&1) and &1 >= -2_147_483_648 and &1 <= 2_147_483_647)) do
       raise ArgumentError,
@@ -299,52 +315,15 @@ defmodule Natch.Column do
     Native.column_decimal_append_bulk(ref, scaled_values)
   end
 
-  # Nullable type handlers
-  def append_bulk(%__MODULE__{type: :nullable_uint64, ref: ref}, values) when is_list(values) do
-    {actual_values, nulls} = split_nullable_values(values, 0)
-    Native.column_nullable_uint64_append_bulk(ref, actual_values, nulls)
-  end
-
-  def append_bulk(%__MODULE__{type: :nullable_int64, ref: ref}, values) when is_list(values) do
-    {actual_values, nulls} = split_nullable_values(values, 0)
-    Native.column_nullable_int64_append_bulk(ref, actual_values, nulls)
-  end
-
-  def append_bulk(%__MODULE__{type: :nullable_string, ref: ref}, values) when is_list(values) do
-    {actual_values, nulls} = split_nullable_values(values, "")
-    Native.column_nullable_string_append_bulk(ref, actual_values, nulls)
-  end
-
-  def append_bulk(%__MODULE__{type: :nullable_float64, ref: ref}, values) when is_list(values) do
-    {actual_values, nulls} = split_nullable_values(values, 0.0)
-    Native.column_nullable_float64_append_bulk(ref, actual_values, nulls)
-  end
-
-  # Generic Nullable(T) for any inner type
-  def append_bulk(%__MODULE__{type: {:nullable, inner_type}, ref: ref}, values)
-      when is_list(values) do
-    # Determine default value and NIF based on inner type
-    case inner_type do
-      :uint64 ->
-        {actual_values, nulls} = split_nullable_values(values, 0)
-        Native.column_nullable_uint64_append_bulk(ref, actual_values, nulls)
-
-      :int64 ->
-        {actual_values, nulls} = split_nullable_values(values, 0)
-        Native.column_nullable_int64_append_bulk(ref, actual_values, nulls)
-
-      :string ->
-        {actual_values, nulls} = split_nullable_values(values, "")
-        Native.column_nullable_string_append_bulk(ref, actual_values, nulls)
-
-      :float64 ->
-        {actual_values, nulls} = split_nullable_values(values, 0.0)
-        Native.column_nullable_float64_append_bulk(ref, actual_values, nulls)
-
-      other ->
-        raise ArgumentError,
-              "Nullable is only supported for UInt64, Int64, String, Float64. Got: #{inspect(other)}"
-    end
+  # Nullable type handlers - any inner type. NULL rows get a placeholder in
+  # the nested column, which is filled by the inner type's own bulk append,
+  # then the null map is written in one NIF call.
+  def append_bulk(%__MODULE__{type: type} = col, values)
+      when is_list(values) and is_nullable_type(type) do
+    inner_type = nullable_inner_type(type)
+    placeholder = null_placeholder(inner_type, values)
+    {inner_values, null_map} = split_nullable_values(values, placeholder)
+    append_nullable(col, inner_values, null_map, &append_bulk/2)
   end
 
   # Array type - always use generic path
@@ -376,71 +355,53 @@ defmodule Natch.Column do
   end
 
   # Enum8 type - stored as Int8 with named values
-  def append_bulk(%__MODULE__{type: {:enum8, items}, ref: ref}, values) when is_list(values) do
-    # Convert string names to integers if needed
-    int_values =
-      if values == [] do
-        # Empty list, no conversion needed
-        []
-      else
-        case hd(values) do
-          val when is_integer(val) ->
-            # Already integers, validate range
-            unless Enum.all?(values, &(is_integer(&1) and &1 >= -128 and &1 <= 127)) do
-              raise ArgumentError, "All values must be integers -128..127 for Enum8 column"
-            end
-
-            values
-
-          val when is_binary(val) ->
-            # String names, look up values from items definition
-            enum_map = Map.new(items)
-
-            Enum.map(values, fn name ->
-              case Map.fetch(enum_map, name) do
-                {:ok, val} -> val
-                :error -> raise ArgumentError, "Unknown enum name: #{name}"
-              end
-            end)
+  def append_bulk(%__MODULE__{type: {:enum8, _items}, ref: ref}, values) when is_list(values) do
+    case values do
+      [] ->
+        :ok
+
+      [val | _] when is_integer(val) ->
+        # Already integers, validate range
+        unless Enum.all?(values, &(is_integer(&1) and &1 >= -128 and &1 <= 127)) do
+          raise ArgumentError, "All values must be integers -128..127 for Enum8 column"
         end
-      end
 
-    Native.column_int8_append_bulk(ref, int_values)
+        Native.column_int8_append_bulk(ref, values)
+
+      _ ->
+        # Names (binaries or atoms) are mapped to values natively
+        ref |> Native.column_enum8_append_names(values) |> check_enum_names()
+    end
   end
 
   # Enum16 type - stored as Int16 with named values
-  def append_bulk(%__MODULE__{type: {:enum16, items}, ref: ref}, values) when is_list(values) do
-    # Convert string names to integers if needed
-    int_values =
-      if values == [] do
-        # Empty list, no conversion needed
-        []
-      else
-        case hd(values) do
-          val when is_integer(val) ->
-            # Already integers, validate range
-            unless Enum.all?(values, &(is_integer(&1) and &1 >= -32_768 and &1 <= 32_767)) do
-              raise ArgumentError, "All values must be integers -32768..32767 for Enum16 column"
-            end
-
-            values
-
-          val when is_binary(val) ->
-            # String names, look up values from items definition
-            enum_map = Map.new(items)
-
-            Enum.map(values, fn name ->
-              case Map.fetch(enum_map, name) do
-                {:ok, val} -> val
-                :error -> raise ArgumentError, "Unknown enum name: #{name}"
-              end
-            end)
+  def append_bulk(%__MODULE__{type: {:enum16, _items}, ref: ref}, values) when is_list(values) do
+    case values do
+      [] ->
+        :ok
+
+      [val | _] when is_integer(val) ->
+        # Already integers, validate range
+        unless Enum.all?(values, &(is_integer(&1) and &1 >= -32_768 and &1 <= 32_767)) do
+          raise ArgumentError, "All values must be integers -32768..32767 for Enum16 column"
         end
-      end
 
-    Native.column_int16_append_bulk(ref, int_values)
+        Native.column_int16_append_bulk(ref, values)
+
+      _ ->
+        # Names (binaries or atoms) are mapped to values natively
+        ref |> Native.column_enum16_append_names(values) |> check_enum_names()
+    end
   end
 
+  defp check_enum_names(:ok), do: :ok
+
+  defp check_enum_names({:unknown, name}) when is_binary(name) or is_atom(name),
+    do: raise(ArgumentError, "Unknown enum name: #{name}")
+
+  defp check_enum_names({:unknown, value}),
+    do: raise(ArgumentError, "Unknown enum name: #{inspect(value)}")
+
   # Tuple type - transpose list of tuples and call append_tuple_columns
   def append_bulk(%__MODULE__{type: {:tuple, element_types}} = col, values) when is_list(values) do
     if values == [] do
@@ -474,6 +435,154 @@ defmodule Natch.Column do
     raise ArgumentError, "append_bulk/2 requires a list of values, got: #{inspect(values)}"
   end
 
+  @doc """
+  Appends packed values from a native-endian binary (single NIF call).
+
+  For producers that already hold packed data (Nx tensors, Explorer series,
+  file readers), this skips building and decoding a list: the binary is
+  copied straight into the column's storage. The layout per type matches
+  `Natch.select_cols/4` with `format: :binary`:
+
+  - `:uint64`, `:uint32`, `:uint16`, `:uint8`, `:int64`, `:int32`, `:int16`, `:int8`,
+    `:float64`, `:float32` - values at their native width
+  - `:bool` - one byte per value (0 or 1)
+  - `:date` - UInt16 days since epoch
+  - `:datetime` - UInt32 Unix seconds
+  - `:datetime64` - Int64 microseconds
+  - `:decimal` - Int64 scaled values
+
+  `{:nullable, type}` columns of these types take `{values, null_map}`, again
+  as returned by `Natch.select_cols/4`: the packed values (anything in NULL
+  rows) and one byte per row, nonzero for NULL.
+
+  Raises `Natch.ValidationError` if the binary size is not a multiple of the
+  value width, or if the null map does not have one byte per value.
+
+  ## Examples
+
+      col = Natch.Column.new(:uint64)
+      :ok = Natch.Column.append_binary(col, <<1::native-64, 2::native-64>>)
+
+      col = Natch.Column.new(:float32)
+      :ok = Natch.Column.append_binary(col, Nx.to_binary(tensor))
+
+      col = Natch.Column.new({:nullable, :int32})
+      :ok = Natch.Column.append_binary(col, {<<1::native-32, 0::native-32>>, <<0, 1>>})
+  """
+  @spec append_binary(column(), binary() | {binary(), binary()}) :: :ok
+  def append_binary(%__MODULE__{type: {:nullable, inner_type}} = col, {values, null_map})
+      when is_binary(values) and is_binary(null_map) do
+    # Checked before anything is appended, so a mismatch leaves the nested
+    # column and the null map the same length
+    width = binary_width(inner_type)
+
+    if width != nil and byte_size(values) != byte_size(null_map) * width do
+      raise Natch.ValidationError,
+            "null map has #{byte_size(null_map)} rows but #{byte_size(values)} bytes of " <>
+              "values were given (#{width} bytes per value)"
+    end
+
+    append_nullable(col, values, null_map, &append_binary/2)
+  rescue
+    e in RuntimeError -> Natch.Error.handle_nif_error(e)
+  end
+
+  def append_binary(%__MODULE__{type: type, ref: ref}, values) when is_binary(values) do
+    case type do
+      :uint64 -> Native.column_uint64_append_binary(ref, values)
+      :uint32 -> Native.column_uint32_append_binary(ref, values)
+      :uint16 -> Native.column_uint16_append_binary(ref, values)
+      :uint8 -> Native.column_uint8_append_binary(ref, values)
+      :bool -> Native.column_uint8_append_binary(ref, values)
+      :int64 -> Native.column_int64_append_binary(ref, values)
+      :int32 -> Native.column_int32_append_binary(ref, values)
+      :int16 -> Native.column_int16_append_binary(ref, values)
+      :int8 -> Native.column_int8_append_binary(ref, values)
+      :float64 -> Native.column_float64_append_binary(ref, values)
+      :float32 -> Native.column_float32_append_binary(ref, values)
+      :date -> Native.column_date_append_binary(ref, values)
+      :datetime -> Native.column_datetime_append_binary(ref, values)
+      :datetime64 -> Native.column_datetime64_append_binary(ref, values)
+      :decimal -> Native.column_decimal_append_binary(ref, values)
+      _ -> raise ArgumentError, "append_binary/2 does not support column type #{inspect(type)}"
+    end
+  rescue
+    e in RuntimeError -> Natch.Error.handle_nif_error(e)
+  end
+
+  def append_binary(%__MODULE__{}, values) do
+    raise ArgumentError,
+          "append_binary/2 requires a binary (or {values, null_map} for Nullable columns), " <>
+            "got: #{inspect(values)}"
+  end
+
+  @binary_types [
+    :uint64,
+    :uint32,
+    :uint16,
+    :uint8,
+    :bool,
+    :int64,
+    :int32,
+    :int16,
+    :int8,
+    :float64,
+    :float32,
+    :date,
+    :datetime,
+    :datetime64,
+    :decimal
+  ]
+
+  @doc """
+  Returns true if `append_binary/2` accepts packed values for `type`.
+  """
+  @spec binary_type?(atom() | tuple()) :: boolean()
+  def binary_type?({:nullable, inner_type}), do: inner_type in @binary_types
+  def binary_type?(type), do: type in @binary_types
+
+  @row_types [
+    :uint64,
+    :uint32,
+    :uint16,
+    :uint8,
+    :bool,
+    :int64,
+    :int32,
+    :int16,
+    :int8,
+    :float64,
+    :float32,
+    :string,
+    :date,
+    :datetime,
+    :datetime64,
+    :uuid
+  ]
+
+  @doc """
+  Returns true if `Natch.Native.block_from_rows/3` can decode values of `type`
+  directly from rows (scalar types, enums and their Nullable forms).
+  """
+  @spec row_type?(atom() | tuple()) :: boolean()
+  def row_type?({:nullable, inner_type}), do: inner_type in @row_types or enum_type?(inner_type)
+
+  def row_type?(type) when type in @legacy_nullable_types, do: true
+
+  def row_type?(type), do: type in @row_types or enum_type?(type)
+
+  defp enum_type?({kind, items}) when kind in [:enum8, :enum16], do: is_list(items)
+  defp enum_type?(_type), do: false
+
+  @doc """
+  Returns the ClickHouse type name for a schema type.
+
+      iex> Natch.Column.clickhouse_type({:nullable, :uint32})
+      "Nullable(UInt32)"
+  """
+  @spec clickhouse_type(atom() | tuple()) :: String.t()
+  def clickhouse_type(type), do: elixir_type_to_clickhouse(type)
+
   @doc """
   Appends tuple values using columnar API (high performance).
 
@@ -636,6 +745,7 @@ defmodule Natch.Column do
   defp elixir_type_to_clickhouse(:uint64), do: "UInt64"
   defp elixir_type_to_clickhouse(:uint32), do: "UInt32"
   defp elixir_type_to_clickhouse(:uint16), do: "UInt16"
+  defp elixir_type_to_clickhouse(:uint8), do: "UInt8"
   defp elixir_type_to_clickhouse(:int64), do: "Int64"
   defp elixir_type_to_clickhouse(:int32), do: "Int32"
   defp elixir_type_to_clickhouse(:int16), do: "Int16"
@@ -692,14 +802,58 @@ defmodule Natch.Column do
     raise ArgumentError, "Unsupported column type: #{inspect(type)}"
   end
 
-  # Helper function to split nullable values into actual values and null flags
-  # Returns {[values], [nulls]} where null flags are UInt8 (0 = not null, 1 = null)
-  defp split_nullable_values(values, default_value) do
-    Enum.map_reduce(values, [], fn
-      nil, nulls -> {default_value, [1 | nulls]}
-      value, nulls -> {value, [0 | nulls]}
-    end)
-    |> then(fn {vals, nulls} -> {vals, Enum.reverse(nulls)} end)
+  # Splits nullable values into the inner values (nil replaced by `placeholder`)
+  # and the null map, one byte per row (0 = not null, 1 = null)
+  defp split_nullable_values(values, placeholder) do
+    {inner_values, nulls} =
+      Enum.map_reduce(values, [], fn
+        nil, nulls -> {placeholder, [1 | nulls]}
+        value, nulls -> {value, [0 | nulls]}
+      end)
+
+    {inner_values, nulls |> Enum.reverse() |> :erlang.list_to_binary()}
+  end
+
+  # Bytes per value in append_binary/2 input, nil for unsupported types
+  defp binary_width(type) when type in [:uint64, :int64, :float64, :datetime64, :decimal], do: 8
+  defp binary_width(type) when type in [:uint32, :int32, :float32, :datetime], do: 4
+  defp binary_width(type) when type in [:uint16, :int16, :date], do: 2
+  defp binary_width(type) when type in [:uint8, :int8, :bool], do: 1
+  defp binary_width(_type), do: nil
+
+  defp nullable_inner_type({:nullable, inner_type}), do: inner_type
+  defp nullable_inner_type(:nullable_uint64), do: :uint64
+  defp nullable_inner_type(:nullable_int64), do: :int64
+  defp nullable_inner_type(:nullable_string), do: :string
+  defp nullable_inner_type(:nullable_float64), do: :float64
+
+  # Value stored in the nested column for NULL rows; it must pass the inner
+  # type's own validation. Enum values are either all names or all integers,
+  # so the placeholder follows the first non-nil value.
+  defp null_placeholder(:string, _values), do: ""
+  defp null_placeholder(type, _values) when type in [:float64, :float32], do: 0.0
+  defp null_placeholder(:bool, _values), do: false
+  defp null_placeholder(:uuid, _values), do: <<0::128>>
+
+  defp null_placeholder({enum, [{name, value} | _]}, values) when enum in [:enum8, :enum16] do
+    if is_integer(Enum.find(values, &(&1 != nil))), do: value, else: name
+  end
+
+  defp null_placeholder(_type, _values), do: 0
+
+  # Appends `inner_values` to the nested column of a Nullable with `append`
+  # (append_bulk/2 or append_binary/2), then writes its null map
+  defp append_nullable(%__MODULE__{type: type, ref: ref}, inner_values, null_map, append) do
+    inner_type = nullable_inner_type(type)
+
+    nested = %__MODULE__{
+      ref: Native.column_nullable_nested(ref),
+      type: inner_type,
+      clickhouse_type: elixir_type_to_clickhouse(inner_type)
+    }
+
+    append.(nested, inner_values)
+    Native.column_nullable_append_bulk(ref, null_map)
   end
 
   # Parse UUID string like "550e8400-e29b-41d4-a716-446655440000" to {high, low} uint64 pair
@@ -90,7 +90,8 @@ defmodule Natch.Connection do
 
   Each column is represented as a list of values, with column names as map keys.
   This format is more efficient for large result sets and enables easier integration
-  with data analysis tools.
+  with data analysis tools. Enum values are returned as binaries, or as atoms
+  with `enum` set to `:atom`.
 
   ## Examples
 
@@ -98,9 +99,10 @@ defmodule Natch.Connection do
       # => {:ok, %{id: [1, 2], name: ["Alice", "Bob"]}}
 
   """
-  @spec select_cols(GenServer.server(), String.t()) :: {:ok, map()} | {:error, term()}
-  def select_cols(conn, query) do
-    GenServer.call(conn, {:select_cols, query}, :infinity)
+  @spec select_cols(GenServer.server(), String.t(), :binary | :atom) ::
+          {:ok, map()} | {:error, term()}
+  def select_cols(conn, query, enum \\ :binary) do
+    GenServer.call(conn, {:select_cols, query, enum}, :infinity)
   end
 
   # Phase 6C - Parameterized Query API
@@ -125,10 +127,89 @@ defmodule Natch.Connection do
   @doc """
   Executes a parameterized SELECT query and returns results in columnar format.
   """
-  @spec select_cols_parameterized(GenServer.server(), Natch.Query.t()) ::
+  @spec select_cols_parameterized(GenServer.server(), Natch.Query.t(), :binary | :atom) ::
           {:ok, map()} | {:error, term()}
-  def select_cols_parameterized(conn, query) do
-    GenServer.call(conn, {:select_cols_parameterized, query}, :infinity)
+  def select_cols_parameterized(conn, query, enum \\ :binary) do
+    GenServer.call(conn, {:select_cols_parameterized, query, enum}, :infinity)
+  end
+
+  @doc """
+  Executes a SELECT query and returns rows in the given format: `:maps`, or
+  `{column_names, rows}` with each row a tuple (`:tuples`) or a list
+  (`:lists`), with enum values as binaries or atoms (`enum`). Accepts a SQL
+  string or a `Natch.Query`.
+  """
+  @spec select_rows_format(GenServer.server(), String.t() | Natch.Query.t(), atom(), atom()) ::
+          {:ok, [map()] | {[atom()], [tuple()] | [list()]}} | {:error, term()}
+  def select_rows_format(conn, query, format, enum \\ :binary) do
+    GenServer.call(conn, {:select_rows_format, query, format, enum}, :infinity)
+  end
+
+  @doc """
+  Executes a SELECT query and returns each row as a `module` struct.
+
+  `fields` are the struct's `{field, default}` pairs and `mapping` the
+  `{column, field}` pairs for columns named differently from their field.
+  See the `:struct` option of `Natch.select_rows/4`.
+  """
+  @spec select_structs(
+          GenServer.server(),
+          String.t() | Natch.Query.t(),
+          module(),
+          [{atom(), term()}],
+          [{atom(), atom()}],
+          :binary | :atom
+        ) :: {:ok, [struct()]} | {:error, term()}
+  def select_structs(conn, query, module, fields, mapping, enum \\ :binary) do
+    GenServer.call(conn, {:select_structs, query, module, fields, mapping, enum}, :infinity)
+  end
+
+  @doc """
+  Executes a SELECT query and returns fixed-width columns as packed binaries.
+
+  Accepts a SQL string or a `Natch.Query`. See `Natch.select_cols/4`.
+  """
+  @spec select_cols_binary(GenServer.server(), String.t() | Natch.Query.t()) ::
+          {:ok, map()} | {:error, term()}
+  def select_cols_binary(conn, query) do
+    GenServer.call(conn, {:select_cols_binary, query}, :infinity)
+  end
+
+  @doc """
+  Executes a SELECT query and returns numeric columns as `{nx_type, binary}`.
+
+  Accepts a SQL string or a `Natch.Query`. See `Natch.select_tensors/3`.
+  """
+  @spec select_tensors(GenServer.server(), String.t() | Natch.Query.t()) ::
+          {:ok, map()} | {:error, term()}
+  def select_tensors(conn, query) do
+    GenServer.call(conn, {:select_tensors, query}, :infinity)
+  end
+
+  @doc """
+  Executes a SELECT query and returns the unconverted result (a native
+  result set reference).
+
+  Accepts a SQL string or a `Natch.Query`. The caller decodes the result,
+  see `Natch.select_result/3` and `Natch.select_rows/4`; enum values will be
+  decoded as binaries or atoms (`enum`).
+  """
+  @spec select_blocks(GenServer.server(), String.t() | Natch.Query.t(), :binary | :atom) ::
+          {:ok, reference()} | {:error, term()}
+  def select_blocks(conn, query, enum \\ :binary) do
+    GenServer.call(conn, {:select_blocks, query, enum}, :infinity)
+  end
+
+  @doc """
+  Executes a SELECT query and returns the result as an Arrow IPC stream
+  binary.
+
+  Accepts a SQL string or a `Natch.Query`. See `Natch.select_arrow/3`.
+  """
+  @spec select_arrow(GenServer.server(), String.t() | Natch.Query.t()) ::
+          {:ok, binary()} | {:error, term()}
+  def select_arrow(conn, query) do
+    GenServer.call(conn, {:select_arrow, query}, :infinity)
   end
 
   # GenServer callbacks
@@ -189,6 +270,30 @@ defmodule Natch.Connection do
     end
   end
 
+  @impl true
+  def handle_call({:insert_block, table, block}, _from, state) do
+    try do
+      # Block already built by the caller
+      Native.client_insert(state.client, table, block)
+
+      {:reply, :ok, state}
+    rescue
+      e -> {:reply, error_tuple(e), state}
+    end
+  end
+
+  @impl true
+  def handle_call({:insert_arrow, table, ipc, schema}, _from, state) do
+    try do
+      block = Natch.Block.build_block_from_arrow(ipc, schema)
+      Native.client_insert(state.client, table, block)
+
+      {:reply, :ok, state}
+    rescue
+      e -> {:reply, error_tuple(e), state}
+    end
+  end
+
   @impl true
   def handle_call({:select_rows, query}, _from, state) do
     try do
@@ -202,10 +307,53 @@ defmodule Natch.Connection do
   end
 
   @impl true
-  def handle_call({:select_cols, query}, _from, state) do
+  def handle_call({:select_rows_format, query, format, enum}, _from, state) do
+    try do
+      rows =
+        case query do
+          %Natch.Query{ref: ref} ->
+            Native.client_select_rows_format_parameterized(state.client, ref, format, enum)
+
+          sql ->
+            Native.client_select_rows_format(state.client, sql, format, enum)
+        end
+
+      {:reply, {:ok, rows}, state}
+    rescue
+      e -> {:reply, error_tuple(e), state}
+    end
+  end
+
+  @impl true
+  def handle_call({:select_structs, query, module, fields, mapping, enum}, _from, state) do
+    try do
+      rows =
+        case query do
+          %Natch.Query{ref: ref} ->
+            Native.client_select_structs_parameterized(
+              state.client,
+              ref,
+              module,
+              fields,
+              mapping,
+              enum
+            )
+
+          sql ->
+            Native.client_select_structs(state.client, sql, module, fields, mapping, enum)
+        end
+
+      {:reply, {:ok, rows}, state}
+    rescue
+      e -> {:reply, error_tuple(e), state}
+    end
+  end
+
+  @impl true
+  def handle_call({:select_cols, query, enum}, _from, state) do
     try do
       # client_select_cols returns map of column lists
-      cols = Native.client_select_cols(state.client, query)
+      cols = Native.client_select_cols(state.client, query, enum)
 
       {:reply, {:ok, cols}, state}
     rescue
@@ -236,15 +384,81 @@ defmodule Natch.Connection do
   end
 
   @impl true
-  def handle_call({:select_cols_parameterized, query}, _from, state) do
+  def handle_call({:select_cols_parameterized, query, enum}, _from, state) do
     try do
-      cols = Native.client_select_cols_parameterized(state.client, query.ref)
+      cols = Native.client_select_cols_parameterized(state.client, query.ref, enum)
+      {:reply, {:ok, cols}, state}
+    rescue
+      e -> {:reply, error_tuple(e), state}
+    end
+  end
+
+  @impl true
+  def handle_call({:select_cols_binary, query}, _from, state) do
+    try do
+      cols =
+        case query do
+          %Natch.Query{ref: ref} ->
+            Native.client_select_cols_binary_parameterized(state.client, ref)
+
+          sql ->
+            Native.client_select_cols_binary(state.client, sql)
+        end
+
       {:reply, {:ok, cols}, state}
     rescue
       e -> {:reply, error_tuple(e), state}
     end
   end
 
+  @impl true
+  def handle_call({:select_tensors, query}, _from, state) do
+    try do
+      cols =
+        case query do
+          %Natch.Query{ref: ref} -> Native.client_select_tensors_parameterized(state.client, ref)
+          sql -> Native.client_select_tensors(state.client, sql)
+        end
+
+      {:reply, {:ok, cols}, state}
+    rescue
+      e -> {:reply, error_tuple(e), state}
+    end
+  end
+
+  @impl true
+  def handle_call({:select_blocks, query, enum}, _from, state) do
+    try do
+      blocks =
+        case query do
+          %Natch.Query{ref: ref} ->
+            Native.client_select_blocks_parameterized(state.client, ref, enum)
+
+          sql ->
+            Native.client_select_blocks(state.client, sql, enum)
+        end
+
+      {:reply, {:ok, blocks}, state}
+    rescue
+      e -> {:reply, error_tuple(e), state}
+    end
+  end
+
+  @impl true
+  def handle_call({:select_arrow, query}, _from, state) do
+    try do
+      ipc =
+        case query do
+          %Natch.Query{ref: ref} -> Native.client_select_arrow_parameterized(state.client, ref)
+          sql -> Native.client_select_arrow(state.client, sql)
+        end
+
+      {:reply, {:ok, ipc}, state}
+    rescue
+      e -> {:reply, error_tuple(e), state}
+    end
+  end
+
   # Private functions
 
   # Delegate to shared error handling
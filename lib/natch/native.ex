@@ -31,6 +31,7 @@ defmodule Natch.Native do
   def client_ping(_client), do: :erlang.nif_error(:nif_not_loaded)
   def client_execute(_client, _sql), do: :erlang.nif_error(:nif_not_loaded)
   def client_reset_connection(_client), do: :erlang.nif_error(:nif_not_loaded)
+  def dirty_schedulers_enabled(), do: :erlang.nif_error(:nif_not_loaded)
 
   # Phase 2 - Column NIFs
   def column_create(_type_name), do: :erlang.nif_error(:nif_not_loaded)
@@ -64,6 +65,22 @@ defmodule Natch.Native do
   def column_float32_append_bulk(_col, _values), do: :erlang.nif_error(:nif_not_loaded)
   def column_uuid_append_bulk(_col, _highs, _lows), do: :erlang.nif_error(:nif_not_loaded)
 
+  # Packed binary bulk appends (native-endian values)
+  def column_uint64_append_binary(_col, _values), do: :erlang.nif_error(:nif_not_loaded)
+  def column_uint32_append_binary(_col, _values), do: :erlang.nif_error(:nif_not_loaded)
+  def column_uint16_append_binary(_col, _values), do: :erlang.nif_error(:nif_not_loaded)
+  def column_uint8_append_binary(_col, _values), do: :erlang.nif_error(:nif_not_loaded)
+  def column_int64_append_binary(_col, _values), do: :erlang.nif_error(:nif_not_loaded)
+  def column_int32_append_binary(_col, _values), do: :erlang.nif_error(:nif_not_loaded)
+  def column_int16_append_binary(_col, _values), do: :erlang.nif_error(:nif_not_loaded)
+  def column_int8_append_binary(_col, _values), do: :erlang.nif_error(:nif_not_loaded)
+  def column_float64_append_binary(_col, _values), do: :erlang.nif_error(:nif_not_loaded)
+  def column_float32_append_binary(_col, _values), do: :erlang.nif_error(:nif_not_loaded)
+  def column_date_append_binary(_col, _values), do: :erlang.nif_error(:nif_not_loaded)
+  def column_datetime_append_binary(_col, _values), do: :erlang.nif_error(:nif_not_loaded)
+  def column_datetime64_append_binary(_col, _values), do: :erlang.nif_error(:nif_not_loaded)
+  def column_decimal_append_binary(_col, _values), do: :erlang.nif_error(:nif_not_loaded)
+
   # Array column NIF
   def column_array_append_from_column(_array_col, _nested_col, _offsets),
     do: :erlang.nif_error(:nif_not_loaded)
@@ -76,33 +93,29 @@ defmodule Natch.Native do
   def column_map_append_from_array(_map_col, _array_tuple_col),
     do: :erlang.nif_error(:nif_not_loaded)
 
+  # Enum column NIFs (names or item values, mapped natively)
+  def column_enum8_append_names(_col, _values), do: :erlang.nif_error(:nif_not_loaded)
+  def column_enum16_append_names(_col, _values), do: :erlang.nif_error(:nif_not_loaded)
+
   # LowCardinality column NIF
   def column_lowcardinality_append_from_column(_lc_col, _source_col),
     do: :erlang.nif_error(:nif_not_loaded)
 
-  # Nullable type NIFs
-  def column_nullable_uint64_append_bulk(_col, _values, _nulls),
-    do: :erlang.nif_error(:nif_not_loaded)
-
-  def column_nullable_int64_append_bulk(_col, _values, _nulls),
-    do: :erlang.nif_error(:nif_not_loaded)
-
-  def column_nullable_string_append_bulk(_col, _values, _nulls),
-    do: :erlang.nif_error(:nif_not_loaded)
-
-  def column_nullable_float64_append_bulk(_col, _values, _nulls),
-    do: :erlang.nif_error(:nif_not_loaded)
+  # Nullable type NIFs (values go through the nested column's typed appends)
+  def column_nullable_nested(_col), do: :erlang.nif_error(:nif_not_loaded)
+  def column_nullable_append_bulk(_col, _null_map), do: :erlang.nif_error(:nif_not_loaded)
 
   # Phase 3 - Block NIFs
   def block_create(), do: :erlang.nif_error(:nif_not_loaded)
   def block_append_column(_block, _name, _column), do: :erlang.nif_error(:nif_not_loaded)
   def block_row_count(_block), do: :erlang.nif_error(:nif_not_loaded)
   def block_column_count(_block), do: :erlang.nif_error(:nif_not_loaded)
+  def block_from_rows(_rows, _columns, _prebuilt, _arity), do: :erlang.nif_error(:nif_not_loaded)
   def client_insert(_client, _table_name, _block), do: :erlang.nif_error(:nif_not_loaded)
 
   # Phase 4 - SELECT NIFs
   def client_select(_client, _query), do: :erlang.nif_error(:nif_not_loaded)
-  def client_select_cols(_client, _query), do: :erlang.nif_error(:nif_not_loaded)
+  def client_select_cols(_client, _query, _enum), do: :erlang.nif_error(:nif_not_loaded)
 
   # Phase 6C - Parameterized Query NIFs
   def query_create(_sql), do: :erlang.nif_error(:nif_not_loaded)
@@ -131,5 +144,108 @@ defmodule Natch.Native do
   # Parameterized query execution
   def client_execute_parameterized(_client, _query), do: :erlang.nif_error(:nif_not_loaded)
   def client_select_parameterized(_client, _query), do: :erlang.nif_error(:nif_not_loaded)
-  def client_select_cols_parameterized(_client, _query), do: :erlang.nif_error(:nif_not_loaded)
+
+  def client_select_rows_format(_client, _query, _format, _enum),
+    do: :erlang.nif_error(:nif_not_loaded)
+
+  def client_select_rows_format_parameterized(_client, _query, _format, _enum),
+    do: :erlang.nif_error(:nif_not_loaded)
+
+  def client_select_structs(_client, _query, _module, _fields, _mapping, _enum),
+    do: :erlang.nif_error(:nif_not_loaded)
+
+  def client_select_structs_parameterized(_client, _query, _module, _fields, _mapping, _enum),
+    do: :erlang.nif_error(:nif_not_loaded)
+
+  def client_select_cols_parameterized(_client, _query, _enum),
+    do: :erlang.nif_error(:nif_not_loaded)
+
+  # Packed binary columnar results (format: :binary)
+  def client_select_cols_binary(_client, _query), do: :erlang.nif_error(:nif_not_loaded)
+
+  def client_select_cols_binary_parameterized(_client, _query),
+    do: :erlang.nif_error(:nif_not_loaded)
+
+  def client_select_tensors(_client, _query), do: :erlang.nif_error(:nif_not_loaded)
+
+  def client_select_tensors_parameterized(_client, _query),
+    do: :erlang.nif_error(:nif_not_loaded)
+
+  # Streaming SELECT cursors
+  def client_select_open(_client, _sql, _format), do: :erlang.nif_error(:nif_not_loaded)
+
+  def client_select_open_parameterized(_client, _query, _format),
+    do: :erlang.nif_error(:nif_not_loaded)
+
+  def cursor_next_block(_cursor), do: :erlang.nif_error(:nif_not_loaded)
+  def cursor_close(_cursor), do: :erlang.nif_error(:nif_not_loaded)
+
+  # Streaming INSERT sessions
+  def client_insert_begin(_client, _table, _columns), do: :erlang.nif_error(:nif_not_loaded)
+  def insert_session_send_block(_session, _block), do: :erlang.nif_error(:nif_not_loaded)
+  def insert_session_finish(_session), do: :erlang.nif_error(:nif_not_loaded)
+  def insert_session_close(_session), do: :erlang.nif_error(:nif_not_loaded)
+
+  # Result sets: SELECT results kept natively and decoded on demand
+  def client_select_blocks(_client, _sql, _enum), do: :erlang.nif_error(:nif_not_loaded)
+
+  def client_select_blocks_parameterized(_client, _query, _enum),
+    do: :erlang.nif_error(:nif_not_loaded)
+  def result_row_count(_result), do: :erlang.nif_error(:nif_not_loaded)
+  def result_column_names(_result), do: :erlang.nif_error(:nif_not_loaded)
+  def result_column(_result, _name), do: :erlang.nif_error(:nif_not_loaded)
+  def result_slice(_result, _offset, _length, _format), do: :erlang.nif_error(:nif_not_loaded)
+  def result_row(_result, _index), do: :erlang.nif_error(:nif_not_loaded)
+
+  # Arrow IPC stream import and export
+  def block_from_arrow(_ipc, _columns), do: :erlang.nif_error(:nif_not_loaded)
+  def client_select_arrow(_client, _sql), do: :erlang.nif_error(:nif_not_loaded)
+  def client_select_arrow_parameterized(_client, _query), do: :erlang.nif_error(:nif_not_loaded)
+
+  # Converts a whole result on a normal scheduler, yielding between chunks
+  def result_blocks_to_terms(_result, _format), do: :erlang.nif_error(:nif_not_loaded)
+
+  # Result conversion settings (see Natch.Application)
+  def set_parallel_conversion(_min_rows, _threads), do: :erlang.nif_error(:nif_not_loaded)
+
+  # Async requests (reply sent as {:natch_async, ref, result})
+  def client_select_async(_client, _sql, _format), do: :erlang.nif_error(:nif_not_loaded)
+
+  def client_select_async_parameterized(_client, _query, _format),
+    do: :erlang.nif_error(:nif_not_loaded)
+
+  def client_execute_async(_client, _sql), do: :erlang.nif_error(:nif_not_loaded)
+
+  def client_execute_async_parameterized(_client, _query),
+    do: :erlang.nif_error(:nif_not_loaded)
+
+  def client_insert_async(_client, _table_name, _block), do: :erlang.nif_error(:nif_not_loaded)
+
+  # Native connection pool
+  def pool_create(
+        _host,
+        _port,
+        _database,
+        _user,
+        _password,
+        _compression,
+        _ssl,
+        _connect_timeout,
+        _recv_timeout,
+        _send_timeout,
+        _size,
+        _checkout_timeout,
+        _health_check_interval
+      ),
+      do: :erlang.nif_error(:nif_not_loaded)
+
+  def pool_status(_pool), do: :erlang.nif_error(:nif_not_loaded)
+  def pool_select(_pool, _sql, _format), do: :erlang.nif_error(:nif_not_loaded)
+
+  def pool_select_parameterized(_pool, _query, _format),
+    do: :erlang.nif_error(:nif_not_loaded)
+
+  def pool_execute(_pool, _sql), do: :erlang.nif_error(:nif_not_loaded)
+  def pool_execute_parameterized(_pool, _query), do: :erlang.nif_error(:nif_not_loaded)
+  def pool_insert(_pool, _table_name, _block), do: :erlang.nif_error(:nif_not_loaded)
 end
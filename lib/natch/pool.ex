@@ -0,0 +1,194 @@
+defmodule Natch.Pool do
+  @moduledoc """
+  Native connection pool.
+
+  A pool holds `:size` ClickHouse connections created from one set of
+  connection options. Queries check a connection out inside the NIF and run
+  in the calling process, so concurrent callers are not serialized through a
+  GenServer and throughput scales with the pool size.
+
+  Checkout is lock-free while a connection is free. When every connection is
+  busy, callers wait up to `:checkout_timeout` milliseconds and then get a
+  validation error. A connection whose last request failed with a network or
+  protocol error is reconnected before it is handed out again, and
+  connections idle for longer than `:health_check_interval` milliseconds are
+  pinged (and reconnected if the ping fails) on checkout.
+
+  Pooled queries run on dirty IO schedulers, of which the VM starts 10 by
+  default. Pools larger than that need a matching `+SDio` setting
+  (for example `ERL_FLAGS="+SDio 32"`) to run every connection at once.
+
+  ## Options
+
+  Accepts every `Natch.start_link/1` connection option, plus:
+
+  - `:size` - Number of connections (default: 10)
+  - `:checkout_timeout` - Milliseconds to wait for a free connection
+    (default: 5000)
+  - `:health_check_interval` - Idle milliseconds after which a connection is
+    pinged on checkout; `0` disables the check (default: 30000)
+
+  ## Examples
+
+      {:ok, pool} = Natch.Pool.start_link(host: "localhost", size: 16, name: MyApp.Pool)
+
+      {:ok, rows} = Natch.Pool.select_rows(MyApp.Pool, "SELECT * FROM events WHERE id > {id}", id: 100)
+      :ok = Natch.Pool.insert_cols(MyApp.Pool, "events", columns, schema)
+
+      Natch.Pool.status(MyApp.Pool)
+      # => %{size: 16, in_use: 0, resets: 0}
+  """
+
+  use GenServer
+  alias Natch.Native
+
+  @type pool :: GenServer.server()
+
+  @doc """
+  Starts a pool process that owns the native connections.
+  """
+  @spec start_link(keyword()) :: GenServer.on_start()
+  def start_link(opts \\ []) do
+    {gen_opts, pool_opts} = Keyword.split(opts, [:name])
+    GenServer.start_link(__MODULE__, pool_opts, gen_opts)
+  end
+
+  @doc """
+  Returns a child specification for starting a pool under a supervisor.
+  """
+  def child_spec(opts) do
+    %{id: Keyword.get(opts, :name, __MODULE__), start: {__MODULE__, :start_link, [opts]}}
+  end
+
+  @doc """
+  Stops the pool and closes its connections.
+  """
+  @spec stop(pool()) :: :ok
+  def stop(pool) do
+    GenServer.stop(pool)
+  end
+
+  @doc """
+  Returns `%{size: n, in_use: n, resets: n}`.
+
+  `resets` counts reconnections performed by health checks since the pool
+  was started.
+  """
+  @spec status(pool()) :: %{
+          size: pos_integer(),
+          in_use: non_neg_integer(),
+          resets: non_neg_integer()
+        }
+  def status(pool) do
+    Native.pool_status(get_ref(pool))
+  end
+
+  @doc """
+  Executes a SELECT on a pooled connection, returning rows. See `Natch.select_rows/3`.
+  """
+  @spec select_rows(pool(), String.t() | Natch.Query.t(), keyword() | map()) ::
+          {:ok, [map()]} | {:error, term()}
+  def select_rows(pool, query_or_sql, params \\ []) do
+    select(pool, query_or_sql, params, :rows)
+  end
+
+  @doc """
+  Executes a SELECT on a pooled connection, returning columns. See `Natch.select_cols/3`.
+  """
+  @spec select_cols(pool(), String.t() | Natch.Query.t(), keyword() | map()) ::
+          {:ok, %{atom() => list()}} | {:error, term()}
+  def select_cols(pool, query_or_sql, params \\ []) do
+    select(pool, query_or_sql, params, :columns)
+  end
+
+  @doc """
+  Executes a DDL or DML statement on a pooled connection. See `Natch.execute/3`.
+  """
+  @spec execute(pool(), String.t() | Natch.Query.t(), keyword() | map()) :: :ok | {:error, term()}
+  def execute(pool, query_or_sql, params \\ []) do
+    ref = get_ref(pool)
+
+    try do
+      case build(query_or_sql, params) do
+        %Natch.Query{ref: query} -> Native.pool_execute_parameterized(ref, query)
+        sql -> Native.pool_execute(ref, sql)
+      end
+    rescue
+      e -> Natch.Error.handle_callback_error(e)
+    end
+  end
+
+  @doc """
+  Inserts columnar data on a pooled connection. See `Natch.insert_cols/4`.
+  """
+  @spec insert_cols(pool(), String.t(), map(), Natch.schema()) :: :ok | {:error, term()}
+  def insert_cols(pool, table, columns, schema) when is_map(columns) and is_list(schema) do
+    ref = get_ref(pool)
+
+    try do
+      block = Natch.Block.build_block(columns, schema)
+      Native.pool_insert(ref, table, block)
+    rescue
+      e -> Natch.Error.handle_callback_error(e)
+    end
+  end
+
+  @impl true
+  def init(opts) do
+    size = Keyword.get(opts, :size, 10)
+    checkout_timeout = Keyword.get(opts, :checkout_timeout, 5000)
+    health_check_interval = Keyword.get(opts, :health_check_interval, 30_000)
+
+    try do
+      ref =
+        Native.pool_create(
+          Keyword.get(opts, :host, "localhost"),
+          Keyword.get(opts, :port, 9000),
+          Keyword.get(opts, :database, "default"),
+          Keyword.get(opts, :user, "default"),
+          Keyword.get(opts, :password, ""),
+          Keyword.get(opts, :compression, true),
+          Keyword.get(opts, :ssl, false),
+          Keyword.get(opts, :connect_timeout, 5000),
+          Keyword.get(opts, :recv_timeout, 0),
+          Keyword.get(opts, :send_timeout, 0),
+          size,
+          checkout_timeout,
+          health_check_interval
+        )
+
+      {:ok, %{ref: ref}}
+    rescue
+      e ->
+        {:error, reason} = Natch.Error.handle_callback_error(e)
+        {:stop, reason}
+    end
+  end
+
+  @impl true
+  def handle_call(:get_ref, _from, state) do
+    {:reply, state.ref, state}
+  end
+
+  defp get_ref(pool), do: GenServer.call(pool, :get_ref)
+
+  defp select(pool, query_or_sql, params, format) do
+    ref = get_ref(pool)
+
+    try do
+      result =
+        case build(query_or_sql, params) do
+          %Natch.Query{ref: query} -> Native.pool_select_parameterized(ref, query, format)
+          sql -> Native.pool_select(ref, sql, format)
+        end
+
+      {:ok, result}
+    rescue
+      e -> Natch.Error.handle_callback_error(e)
+    end
+  end
+
+  defp build(%Natch.Query{} = query, _params), do: query
+  defp build(sql, params) when is_binary(sql) and params in [[], %{}], do: sql
+  defp build(sql, params) when is_binary(sql), do: Natch.build_query(sql, params)
+end
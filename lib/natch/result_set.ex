@@ -0,0 +1,97 @@
+defmodule Natch.ResultSet do
+  @moduledoc """
+  A SELECT result kept in native memory and decoded on demand.
+
+  `Natch.select_result/3` receives the whole result but converts nothing to
+  Elixir terms. The functions in this module decode only what they return,
+  so reading two columns of a wide result, or just its row count, costs a
+  fraction of `Natch.select_rows/2` or `Natch.select_cols/2`.
+
+  The result memory is released when the `ResultSet` is garbage collected.
+  Values are returned in the same shapes as `select_rows` and `select_cols`.
+
+  ## Examples
+
+      {:ok, result} = Natch.select_result(conn, "SELECT * FROM events")
+
+      Natch.ResultSet.row_count(result)
+      # => 1_000_000
+
+      Natch.ResultSet.column_names(result)
+      # => [:id, :user_id, :event_type, ...]
+
+      user_ids = Natch.ResultSet.column(result, :user_id)
+      first_page = Natch.ResultSet.slice(result, 0, 50)
+      Natch.ResultSet.row(result, 10)
+      # => %{id: 10, user_id: 42, ...}
+  """
+
+  alias Natch.Native
+
+  defstruct [:ref]
+
+  @type t :: %__MODULE__{ref: reference()}
+
+  @doc false
+  def wrap(ref), do: %__MODULE__{ref: ref}
+
+  @doc """
+  Returns the number of rows in the result.
+  """
+  @spec row_count(t()) :: non_neg_integer()
+  def row_count(%__MODULE__{ref: ref}), do: Native.result_row_count(ref)
+
+  @doc """
+  Returns the column names in result order.
+  """
+  @spec column_names(t()) :: [atom()]
+  def column_names(%__MODULE__{ref: ref}), do: Native.result_column_names(ref)
+
+  @doc """
+  Decodes one column and returns all of its values.
+
+  Raises `Natch.ValidationError` if the result has no such column.
+  """
+  @spec column(t(), atom() | String.t()) :: [term()]
+  def column(%__MODULE__{ref: ref}, name) when is_atom(name) or is_binary(name) do
+    decode(fn -> Native.result_column(ref, to_string(name)) end)
+  end
+
+  @doc """
+  Decodes up to `length` rows starting at `offset` (zero-based).
+
+  Ranges past the end of the result are truncated.
+
+  ## Options
+
+  - `:format` - `:rows` (default) returns a list of maps like
+    `Natch.select_rows/2`; `:columns` returns `%{column => [values]}` like
+    `Natch.select_cols/2`
+  """
+  @spec slice(t(), non_neg_integer(), non_neg_integer(), keyword()) :: [map()] | map()
+  def slice(%__MODULE__{ref: ref}, offset, length, opts \\ [])
+      when is_integer(offset) and offset >= 0 and is_integer(length) and length >= 0 do
+    format = Keyword.get(opts, :format, :rows)
+
+    unless format in [:rows, :columns] do
+      raise ArgumentError, "invalid :format #{inspect(format)}, expected :rows or :columns"
+    end
+
+    decode(fn -> Native.result_slice(ref, offset, length, format) end)
+  end
+
+  @doc """
+  Decodes row `index` (zero-based) as a map, or returns `nil` if the result
+  has fewer rows.
+  """
+  @spec row(t(), non_neg_integer()) :: map() | nil
+  def row(%__MODULE__{ref: ref}, index) when is_integer(index) and index >= 0 do
+    decode(fn -> Native.result_row(ref, index) end)
+  end
+
+  defp decode(fun) do
+    fun.()
+  rescue
+    e -> Natch.Error.handle_nif_error(e)
+  end
+end
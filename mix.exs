@@ -62,6 +62,7 @@ defmodule Natch.MixProject do
       {:cc_precompiler, "~> 0.1.0", runtime: false},
       {:jason, "~> 1.4"},
       {:decimal, "~> 2.0"},
+      {:nx, "~> 0.7", optional: true},
       {:ex_doc, "~> 0.34", only: :dev, runtime: false},
       {:benchee, "~> 1.3", only: :dev},
       {:benchee_html, "~> 1.0", only: :dev},
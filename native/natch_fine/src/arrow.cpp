@@ -0,0 +1,526 @@
+// arrow.cpp - Arrow IPC stream export of SELECT results
+//
+// client_select_arrow runs a SELECT and encodes the received columns into
+// one Arrow IPC stream binary (schema, dictionaries, one record batch per
+// ClickHouse block) without creating any per-value terms. The stream can be
+// loaded with Explorer.DataFrame.load_ipc_stream/2 or any Arrow reader.
+//
+// Type mapping:
+//   (U)Int8..64, Float32/64  -> Int / FloatingPoint (copied as-is)
+//   String, Enum8/16, UUID   -> Utf8 (Enum names, UUIDs as 36-char strings)
+//   Date                     -> Date32 (days)
+//   DateTime                 -> Timestamp(s) with the column's timezone
+//   DateTime64(p)            -> Timestamp(s/ms/us/ns), the finest unit <= p
+//   Decimal                  -> Decimal128(precision, scale)
+//   Nullable(T)              -> T with a validity bitmap
+//   Array(T)                 -> List<T>
+//   LowCardinality(String)   -> dictionary-encoded Utf8 with Int32 indices
+//
+// Dictionaries are merged across blocks into one dictionary per field, sent
+// before the first record batch, so every batch uses the same dictionary.
+
+#include <fine.hpp>
+#include <clickhouse/client.h>
+#include <clickhouse/query.h>
+#include <clickhouse/block.h>
+#include <clickhouse/columns/column.h>
+#include <clickhouse/columns/numeric.h>
+#include <clickhouse/columns/string.h>
+#include <clickhouse/columns/date.h>
+#include <clickhouse/columns/decimal.h>
+#include <clickhouse/columns/uuid.h>
+#include <clickhouse/columns/array.h>
+#include <clickhouse/columns/nullable.h>
+#include <clickhouse/columns/lowcardinality.h>
+#include <clickhouse/columns/enum.h>
+#include <clickhouse/exceptions.h>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "arrow_ipc.h"
+#include "client_resource.h"
+#include "column_helpers.h"
+#include "error_encoding.h"
+#include "nif_flags.h"
+
+using namespace clickhouse;
+using arrow_ipc::BatchBody;
+using arrow_ipc::FlatBufferBuilder;
+
+namespace {
+
+using Offset = FlatBufferBuilder::Offset;
+
+// One dictionary per LowCardinality field, shared by all record batches
+struct Dictionary {
+  std::unordered_map<std::string_view, int32_t> index;
+  // Views into the retained blocks' dictionary columns
+  std::vector<std::string_view> values;
+
+  int32_t lookup(std::string_view value) {
+    auto [it, inserted] = index.try_emplace(value, static_cast<int32_t>(values.size()));
+    if (inserted) {
+      values.push_back(value);
+    }
+    return it->second;
+  }
+};
+
+[[noreturn]] void throw_unsupported(const ColumnRef &col) {
+  throw ValidationError("unsupported column type for Arrow export: " + col->GetType().GetName());
+}
+
+// Timestamp unit for DateTime64(precision) (the coarsest unit that keeps
+// every digit, precision is at most 9) and the factor from ticks to it
+std::pair<arrow_ipc::TimeUnit, int64_t> timestamp_unit(size_t precision) {
+  size_t digits = precision == 0 ? 0 : precision <= 3 ? 3 : precision <= 6 ? 6 : 9;
+  arrow_ipc::TimeUnit unit = digits == 9   ? arrow_ipc::NANOSECOND
+                             : digits == 6 ? arrow_ipc::MICROSECOND
+                             : digits == 3 ? arrow_ipc::MILLISECOND
+                                           : arrow_ipc::SECOND;
+  int64_t factor = 1;
+  for (size_t i = precision; i < digits; i++) {
+    factor *= 10;
+  }
+  return {unit, factor};
+}
+
+// ============================================================================
+// Schema
+// ============================================================================
+
+Offset int_type(FlatBufferBuilder &fbb, int32_t bits, bool is_signed) {
+  fbb.start_table();
+  fbb.add_scalar<int32_t>(0, bits);
+  fbb.add_scalar<uint8_t>(1, is_signed);
+  return fbb.end_table();
+}
+
+Offset empty_type(FlatBufferBuilder &fbb) {
+  fbb.start_table();
+  return fbb.end_table();
+}
+
+// Builds the Field for `col`; LowCardinality fields take the next
+// dictionary id in depth-first order, matching write_array
+Offset build_field(FlatBufferBuilder &fbb, const std::string &name, ColumnRef col,
+                   int64_t &next_dictionary) {
+  bool nullable = false;
+  if (auto nullable_col = col->As<ColumnNullable>()) {
+    nullable = true;
+    col = nullable_col->Nested();
+  }
+
+  std::vector<Offset> children;
+  Offset dictionary = 0;
+  Offset type = 0;
+  uint8_t type_id = 0;
+
+  switch (col->GetType().GetCode()) {
+  case Type::Int8: type_id = arrow_ipc::TYPE_INT; type = int_type(fbb, 8, true); break;
+  case Type::Int16: type_id = arrow_ipc::TYPE_INT; type = int_type(fbb, 16, true); break;
+  case Type::Int32: type_id = arrow_ipc::TYPE_INT; type = int_type(fbb, 32, true); break;
+  case Type::Int64: type_id = arrow_ipc::TYPE_INT; type = int_type(fbb, 64, true); break;
+  case Type::UInt8: type_id = arrow_ipc::TYPE_INT; type = int_type(fbb, 8, false); break;
+  case Type::UInt16: type_id = arrow_ipc::TYPE_INT; type = int_type(fbb, 16, false); break;
+  case Type::UInt32: type_id = arrow_ipc::TYPE_INT; type = int_type(fbb, 32, false); break;
+  case Type::UInt64: type_id = arrow_ipc::TYPE_INT; type = int_type(fbb, 64, false); break;
+  case Type::Float32:
+  case Type::Float64: {
+    type_id = arrow_ipc::TYPE_FLOATING_POINT;
+    fbb.start_table();
+    // Precision: HALF = 0, SINGLE = 1, DOUBLE = 2
+    fbb.add_scalar<int16_t>(0, col->GetType().GetCode() == Type::Float32 ? 1 : 2);
+    type = fbb.end_table();
+    break;
+  }
+  case Type::String:
+  case Type::Enum8:
+  case Type::Enum16:
+  case Type::UUID:
+    type_id = arrow_ipc::TYPE_UTF8;
+    type = empty_type(fbb);
+    break;
+  case Type::Date: {
+    type_id = arrow_ipc::TYPE_DATE;
+    fbb.start_table();
+    fbb.add_scalar<int16_t>(0, 0);  // DateUnit.DAY
+    type = fbb.end_table();
+    break;
+  }
+  case Type::DateTime:
+  case Type::DateTime64: {
+    type_id = arrow_ipc::TYPE_TIMESTAMP;
+    std::string timezone;
+    arrow_ipc::TimeUnit unit = arrow_ipc::SECOND;
+    if (auto dt = col->As<ColumnDateTime>()) {
+      timezone = dt->Timezone();
+    } else {
+      auto dt64 = col->As<ColumnDateTime64>();
+      timezone = dt64->Timezone();
+      unit = timestamp_unit(dt64->GetPrecision()).first;
+    }
+    Offset tz = timezone.empty() ? 0 : fbb.create_string(timezone);
+    fbb.start_table();
+    fbb.add_scalar<int16_t>(0, unit);
+    if (tz) {
+      fbb.add_offset(1, tz);
+    }
+    type = fbb.end_table();
+    break;
+  }
+  case Type::Decimal:
+  case Type::Decimal32:
+  case Type::Decimal64:
+  case Type::Decimal128: {
+    auto decimal_col = col->As<ColumnDecimal>();
+    type_id = arrow_ipc::TYPE_DECIMAL;
+    fbb.start_table();
+    fbb.add_scalar<int32_t>(0, static_cast<int32_t>(decimal_col->GetPrecision()));
+    fbb.add_scalar<int32_t>(1, static_cast<int32_t>(decimal_col->GetScale()));
+    fbb.add_scalar<int32_t>(2, 128);
+    type = fbb.end_table();
+    break;
+  }
+  case Type::Array: {
+    auto array_col = col->As<ColumnArray>();
+    children.push_back(
+        build_field(fbb, "item", ColumnArrayAccess::data(*array_col), next_dictionary));
+    type_id = arrow_ipc::TYPE_LIST;
+    type = empty_type(fbb);
+    break;
+  }
+  case Type::LowCardinality: {
+    // Values are the dictionary's type; NULLs are null indices
+    nullable = true;
+    type_id = arrow_ipc::TYPE_UTF8;
+    type = empty_type(fbb);
+    Offset index_type = int_type(fbb, 32, true);
+    fbb.start_table();
+    fbb.add_scalar<int64_t>(0, next_dictionary++);
+    fbb.add_offset(1, index_type);
+    fbb.add_scalar<uint8_t>(2, 0);  // isOrdered
+    dictionary = fbb.end_table();
+    break;
+  }
+  default:
+    throw_unsupported(col);
+  }
+
+  Offset name_offset = fbb.create_string(name);
+  Offset children_offset = fbb.create_offset_vector(children);
+
+  fbb.start_table();
+  fbb.add_offset(0, name_offset);
+  fbb.add_scalar<uint8_t>(1, nullable);
+  fbb.add_scalar<uint8_t>(2, type_id);
+  fbb.add_offset(3, type);
+  if (dictionary) {
+    fbb.add_offset(4, dictionary);
+  }
+  fbb.add_offset(5, children_offset);
+  return fbb.end_table();
+}
+
+std::vector<uint8_t> schema_message(const Block &header, int64_t &dictionary_count) {
+  FlatBufferBuilder fbb;
+  std::vector<Offset> fields;
+  for (size_t c = 0; c < header.GetColumnCount(); c++) {
+    fields.push_back(build_field(fbb, header.GetColumnName(c), header[c], dictionary_count));
+  }
+  Offset fields_offset = fbb.create_offset_vector(fields);
+
+  fbb.start_table();
+  fbb.add_scalar<int16_t>(0, 0);  // Endianness.Little
+  fbb.add_offset(1, fields_offset);
+  Offset schema = fbb.end_table();
+  return arrow_ipc::finish_message(fbb, arrow_ipc::HEADER_SCHEMA, schema, 0);
+}
+
+// ============================================================================
+// Record batches
+// ============================================================================
+
+// Field node and validity buffer. `nulls` is a ClickHouse null map
+// (1 = NULL) or nullptr.
+void add_node(BatchBody &body, size_t count, const uint8_t *nulls) {
+  size_t null_count = 0;
+  if (nulls) {
+    for (size_t i = 0; i < count; i++) {
+      null_count += nulls[i] != 0;
+    }
+  }
+  body.nodes.emplace_back(static_cast<int64_t>(count), static_cast<int64_t>(null_count));
+
+  if (null_count == 0) {
+    body.add_buffer(0);
+    return;
+  }
+  uint8_t *bits = body.add_buffer((count + 7) / 8);
+  for (size_t i = 0; i < count; i++) {
+    if (!nulls[i]) {
+      bits[i >> 3] |= static_cast<uint8_t>(1 << (i & 7));
+    }
+  }
+}
+
+template <typename T>
+void add_vector_buffer(BatchBody &body, const ColumnRef &col) {
+  auto &data = col->As<ColumnVector<T>>()->GetWritableData();
+  body.add_buffer(data.data(), data.size() * sizeof(T));
+}
+
+// Buffer of `count` values of type T produced by value_at(i)
+template <typename T, typename ValueAt>
+void add_converted_buffer(BatchBody &body, size_t count, ValueAt value_at) {
+  T *out = reinterpret_cast<T *>(body.add_buffer(count * sizeof(T)));
+  for (size_t i = 0; i < count; i++) {
+    out[i] = value_at(i);
+  }
+}
+
+// Offsets and data buffers of a Utf8 array
+template <typename ValueAt>
+void add_string_buffers(BatchBody &body, size_t count, ValueAt value_at) {
+  size_t total = 0;
+  for (size_t i = 0; i < count; i++) {
+    total += value_at(i).size();
+  }
+  if (total > static_cast<size_t>(INT32_MAX)) {
+    throw ValidationError("string data exceeds 2 GiB in one block, reduce max_block_size");
+  }
+
+  int32_t *offsets = reinterpret_cast<int32_t *>(body.add_buffer((count + 1) * sizeof(int32_t)));
+  int32_t position = 0;
+  for (size_t i = 0; i < count; i++) {
+    offsets[i] = position;
+    position += static_cast<int32_t>(value_at(i).size());
+  }
+  offsets[count] = position;
+
+  uint8_t *data = body.add_buffer(total);
+  for (size_t i = 0; i < count; i++) {
+    std::string_view value = value_at(i);
+    std::memcpy(data, value.data(), value.size());
+    data += value.size();
+  }
+}
+
+void write_array(BatchBody &body, ColumnRef col, std::vector<Dictionary> &dictionaries,
+                 size_t &next_dictionary) {
+  size_t count = col->Size();
+  const uint8_t *nulls = nullptr;
+  if (auto nullable_col = col->As<ColumnNullable>()) {
+    nulls = nullable_col->Nulls()->As<ColumnUInt8>()->GetWritableData().data();
+    col = nullable_col->Nested();
+  }
+
+  Type::Code code = col->GetType().GetCode();
+
+  if (code == Type::LowCardinality) {
+    auto lc_col = col->As<ColumnLowCardinality>();
+    Dictionary &dictionary = dictionaries[next_dictionary++];
+    std::vector<int32_t> indices(count, 0);
+    std::vector<uint8_t> lc_nulls(count, 0);
+    for (size_t i = 0; i < count; i++) {
+      auto item = lc_col->GetItem(i);
+      if (item.type == Type::Void) {
+        lc_nulls[i] = 1;
+      } else if (item.type == Type::String) {
+        indices[i] = dictionary.lookup(item.get<std::string_view>());
+      } else {
+        throw_unsupported(col);
+      }
+    }
+    add_node(body, count, lc_nulls.data());
+    body.add_buffer(indices.data(), count * sizeof(int32_t));
+    return;
+  }
+
+  add_node(body, count, nulls);
+
+  switch (code) {
+  case Type::Int8: add_vector_buffer<int8_t>(body, col); break;
+  case Type::Int16: add_vector_buffer<int16_t>(body, col); break;
+  case Type::Int32: add_vector_buffer<int32_t>(body, col); break;
+  case Type::Int64: add_vector_buffer<int64_t>(body, col); break;
+  case Type::UInt8: add_vector_buffer<uint8_t>(body, col); break;
+  case Type::UInt16: add_vector_buffer<uint16_t>(body, col); break;
+  case Type::UInt32: add_vector_buffer<uint32_t>(body, col); break;
+  case Type::UInt64: add_vector_buffer<uint64_t>(body, col); break;
+  case Type::Float32: add_vector_buffer<float>(body, col); break;
+  case Type::Float64: add_vector_buffer<double>(body, col); break;
+  case Type::String: {
+    auto string_col = col->As<ColumnString>();
+    add_string_buffers(body, count, [&](size_t i) { return string_col->At(i); });
+    break;
+  }
+  case Type::Enum8: {
+    auto enum_col = col->As<ColumnEnum8>();
+    add_string_buffers(body, count, [&](size_t i) { return enum_col->NameAt(i); });
+    break;
+  }
+  case Type::Enum16: {
+    auto enum_col = col->As<ColumnEnum16>();
+    add_string_buffers(body, count, [&](size_t i) { return enum_col->NameAt(i); });
+    break;
+  }
+  case Type::UUID: {
+    auto uuid_col = col->As<ColumnUUID>();
+    std::vector<char> text(count * 37);
+    for (size_t i = 0; i < count; i++) {
+      format_uuid_to_buffer(uuid_col->At(i), text.data() + i * 37);
+    }
+    add_string_buffers(body, count,
+                       [&](size_t i) { return std::string_view(text.data() + i * 37, 36); });
+    break;
+  }
+  case Type::Date: {
+    auto date_col = col->As<ColumnDate>();
+    add_converted_buffer<int32_t>(body, count, [&](size_t i) { return date_col->RawAt(i); });
+    break;
+  }
+  case Type::DateTime: {
+    auto &seconds = col->As<ColumnDateTime>()->GetWritableData();
+    add_converted_buffer<int64_t>(body, count, [&](size_t i) { return seconds[i]; });
+    break;
+  }
+  case Type::DateTime64: {
+    auto dt64_col = col->As<ColumnDateTime64>();
+    int64_t factor = timestamp_unit(dt64_col->GetPrecision()).second;
+    add_converted_buffer<int64_t>(body, count,
+                                  [&](size_t i) { return dt64_col->At(i) * factor; });
+    break;
+  }
+  case Type::Decimal:
+  case Type::Decimal32:
+  case Type::Decimal64:
+  case Type::Decimal128: {
+    auto decimal_col = col->As<ColumnDecimal>();
+    uint64_t *out = reinterpret_cast<uint64_t *>(body.add_buffer(count * 16));
+    for (size_t i = 0; i < count; i++) {
+      Int128 value = decimal_col->At(i);
+      out[2 * i] = static_cast<uint64_t>(value);
+      out[2 * i + 1] = static_cast<uint64_t>(value >> 64);
+    }
+    break;
+  }
+  case Type::Array: {
+    auto array_col = col->As<ColumnArray>();
+    size_t total = count == 0 ? 0
+                              : ColumnArrayAccess::offset(*array_col, count - 1) +
+                                    ColumnArrayAccess::size(*array_col, count - 1);
+    if (total > static_cast<size_t>(INT32_MAX)) {
+      throw ValidationError("array elements exceed 2^31 in one block, reduce max_block_size");
+    }
+    int32_t *offsets =
+        reinterpret_cast<int32_t *>(body.add_buffer((count + 1) * sizeof(int32_t)));
+    offsets[0] = 0;
+    for (size_t i = 0; i < count; i++) {
+      offsets[i + 1] = static_cast<int32_t>(ColumnArrayAccess::offset(*array_col, i) +
+                                            ColumnArrayAccess::size(*array_col, i));
+    }
+    write_array(body, ColumnArrayAccess::data(*array_col), dictionaries, next_dictionary);
+    break;
+  }
+  default:
+    throw_unsupported(col);
+  }
+}
+
+// Encodes the whole result as an IPC stream. `header` is the first block
+// received (possibly empty) and defines the schema.
+std::vector<uint8_t> encode_stream(const Block &header, const std::vector<Block> &blocks,
+                                   std::vector<uint8_t> &batches) {
+  int64_t dictionary_count = 0;
+  std::vector<uint8_t> head;
+  arrow_ipc::write_message(head, schema_message(header, dictionary_count), {});
+
+  // Record batches are encoded first: the dictionaries they fill must be
+  // written ahead of them in the stream
+  std::vector<Dictionary> dictionaries(dictionary_count);
+  for (const auto &block : blocks) {
+    BatchBody body;
+    size_t next_dictionary = 0;
+    for (size_t c = 0; c < block.GetColumnCount(); c++) {
+      write_array(body, block[c], dictionaries, next_dictionary);
+    }
+    auto metadata = arrow_ipc::batch_message(static_cast<int64_t>(block.GetRowCount()), body);
+    arrow_ipc::write_message(batches, metadata, body.bytes);
+  }
+
+  for (int64_t id = 0; id < dictionary_count; id++) {
+    const auto &values = dictionaries[id].values;
+    BatchBody body;
+    add_node(body, values.size(), nullptr);
+    add_string_buffers(body, values.size(), [&](size_t i) { return values[i]; });
+    auto metadata = arrow_ipc::batch_message(static_cast<int64_t>(values.size()), body, &id);
+    arrow_ipc::write_message(head, metadata, body.bytes);
+  }
+  return head;
+}
+
+ERL_NIF_TERM select_arrow_impl(ErlNifEnv *env, Client &client, Query query) {
+  Block header;
+  bool have_header = false;
+  std::vector<Block> blocks;
+
+  query.OnData([&](const Block &block) {
+    if (!have_header) {
+      header = block;
+      have_header = true;
+    }
+    if (block.GetRowCount() > 0) {
+      blocks.push_back(block);
+    }
+  });
+  client.Select(query);
+
+  std::vector<uint8_t> batches;
+  std::vector<uint8_t> head = encode_stream(header, blocks, batches);
+  arrow_ipc::write_end_of_stream(batches);
+
+  ERL_NIF_TERM binary;
+  unsigned char *data = enif_make_new_binary(env, head.size() + batches.size(), &binary);
+  std::memcpy(data, head.data(), head.size());
+  std::memcpy(data + head.size(), batches.data(), batches.size());
+  return binary;
+}
+
+}  // namespace
+
+// ============================================================================
+// Arrow SELECT NIFs
+// ============================================================================
+
+/// Executes a SELECT and returns the result as an Arrow IPC stream binary
+fine::Term client_select_arrow(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ClientResource> client,
+    std::string query) {
+  try {
+    ClientLock lock(*client);
+    return select_arrow_impl(env, *client->ptr, Query(query));
+  } catch (const std::exception& e) {
+    throw std::runtime_error(encode_clickhouse_error(e));
+  }
+}
+FINE_NIF(client_select_arrow, NATCH_DIRTY_IO);
+
+/// Executes a parameterized SELECT and returns an Arrow IPC stream binary
+fine::Term client_select_arrow_parameterized(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ClientResource> client,
+    fine::ResourcePtr<Query> query) {
+  try {
+    ClientLock lock(*client);
+    return select_arrow_impl(env, *client->ptr, *query);
+  } catch (const std::exception& e) {
+    throw std::runtime_error(encode_clickhouse_error(e));
+  }
+}
+FINE_NIF(client_select_arrow_parameterized, NATCH_DIRTY_IO);
@@ -0,0 +1,940 @@
+// arrow_import.cpp - Build an INSERT block from an Arrow IPC stream
+//
+// block_from_arrow reads an Arrow IPC stream binary (for example from
+// Explorer.DataFrame.dump_ipc_stream/2, or select_arrow) and appends every
+// record batch to clickhouse-cpp columns of the requested types, reading
+// values straight from the Arrow buffers:
+//
+//   - fixed-width values are copied with one memcpy when the Arrow and
+//     ClickHouse types have the same layout, and cast per value otherwise
+//   - strings come from the offsets and data buffers (also large and view
+//     layouts, fixed-size binary and string dictionaries)
+//   - validity bitmaps become Nullable null maps
+//   - list offsets become Array offsets over the recursively filled data
+//   - timestamps and dates are rescaled to the target's unit
+//
+// The result is a regular BlockResource, inserted with client_insert. Arrow
+// fields are matched to the requested columns by name; extra fields are
+// skipped.
+
+#include <fine.hpp>
+#include <clickhouse/block.h>
+#include <clickhouse/columns/array.h>
+#include <clickhouse/columns/column.h>
+#include <clickhouse/columns/date.h>
+#include <clickhouse/columns/decimal.h>
+#include <clickhouse/columns/enum.h>
+#include <clickhouse/columns/factory.h>
+#include <clickhouse/columns/lowcardinality.h>
+#include <clickhouse/columns/nullable.h>
+#include <clickhouse/columns/numeric.h>
+#include <clickhouse/columns/string.h>
+#include <clickhouse/exceptions.h>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include "arrow_ipc.h"
+#include "block_resource.h"
+#include "column_helpers.h"
+#include "error_encoding.h"
+#include "nif_flags.h"
+
+using namespace clickhouse;
+using arrow_ipc::FormatError;
+using arrow_ipc::TableReader;
+
+namespace {
+
+// Schema field with the type parameters the import uses
+struct Field {
+  std::string name;
+  uint8_t type_id = 0;
+  int32_t bit_width = 0;    // Int, Decimal, Time
+  bool is_signed = false;   // Int
+  int16_t unit = 0;         // FloatingPoint precision, Date/Time/Timestamp unit
+  int32_t scale = 0;        // Decimal
+  int32_t byte_width = 0;   // FixedSizeBinary, FixedSizeList size
+  int64_t dictionary_id = -1;
+  int32_t index_bit_width = 0;
+  bool index_signed = true;
+  std::vector<Field> children;
+};
+
+Field read_field(const TableReader &table) {
+  Field field;
+  if (table.has(0)) {
+    field.name = std::string(table.string(0));
+  }
+  field.type_id = table.scalar<uint8_t>(2);
+  if (table.has(3)) {
+    TableReader type = table.table(3);
+    switch (field.type_id) {
+    case arrow_ipc::TYPE_INT:
+      field.bit_width = type.scalar<int32_t>(0);
+      field.is_signed = type.scalar<uint8_t>(1) != 0;
+      break;
+    case arrow_ipc::TYPE_FLOATING_POINT:
+      field.unit = type.scalar<int16_t>(0);
+      break;
+    case arrow_ipc::TYPE_DECIMAL:
+      field.scale = type.scalar<int32_t>(1);
+      field.bit_width = type.scalar<int32_t>(2, 128);
+      break;
+    case arrow_ipc::TYPE_DATE:
+      field.unit = type.scalar<int16_t>(0, arrow_ipc::DATE_MILLISECOND);
+      break;
+    case arrow_ipc::TYPE_TIMESTAMP:
+      field.unit = type.scalar<int16_t>(0);
+      break;
+    case arrow_ipc::TYPE_FIXED_SIZE_BINARY:
+    case arrow_ipc::TYPE_FIXED_SIZE_LIST:
+      field.byte_width = type.scalar<int32_t>(0);
+      break;
+    }
+  }
+  if (table.has(4)) {
+    TableReader encoding = table.table(4);
+    field.dictionary_id = encoding.scalar<int64_t>(0);
+    field.index_bit_width = 32;
+    if (encoding.has(1)) {
+      TableReader index_type = encoding.table(1);
+      field.index_bit_width = index_type.scalar<int32_t>(0);
+      field.index_signed = index_type.scalar<uint8_t>(1) != 0;
+    }
+  }
+  for (const auto &child : table.tables(5)) {
+    field.children.push_back(read_field(child));
+  }
+  return field;
+}
+
+const Field *find_dictionary_field(const std::vector<Field> &fields, int64_t id) {
+  for (const auto &field : fields) {
+    if (field.dictionary_id == id) {
+      return &field;
+    }
+    if (const Field *found = find_dictionary_field(field.children, id)) {
+      return found;
+    }
+  }
+  return nullptr;
+}
+
+std::string arrow_type_name(const Field &field) {
+  if (field.dictionary_id >= 0) {
+    return "dictionary";
+  }
+  switch (field.type_id) {
+  case arrow_ipc::TYPE_NULL: return "null";
+  case arrow_ipc::TYPE_INT:
+    return (field.is_signed ? "int" : "uint") + std::to_string(field.bit_width);
+  case arrow_ipc::TYPE_FLOATING_POINT: return field.unit == 1 ? "float32" : "float64";
+  case arrow_ipc::TYPE_BINARY: return "binary";
+  case arrow_ipc::TYPE_UTF8: return "utf8";
+  case arrow_ipc::TYPE_BOOL: return "bool";
+  case arrow_ipc::TYPE_DECIMAL: return "decimal" + std::to_string(field.bit_width);
+  case arrow_ipc::TYPE_DATE: return field.unit == arrow_ipc::DAY ? "date32" : "date64";
+  case arrow_ipc::TYPE_TIME: return "time";
+  case arrow_ipc::TYPE_TIMESTAMP: return "timestamp";
+  case arrow_ipc::TYPE_INTERVAL: return "interval";
+  case arrow_ipc::TYPE_LIST: return "list";
+  case arrow_ipc::TYPE_STRUCT: return "struct";
+  case arrow_ipc::TYPE_FIXED_SIZE_BINARY: return "fixed_size_binary";
+  case arrow_ipc::TYPE_FIXED_SIZE_LIST: return "fixed_size_list";
+  case arrow_ipc::TYPE_MAP: return "map";
+  case arrow_ipc::TYPE_DURATION: return "duration";
+  case arrow_ipc::TYPE_LARGE_BINARY: return "large_binary";
+  case arrow_ipc::TYPE_LARGE_UTF8: return "large_utf8";
+  case arrow_ipc::TYPE_LARGE_LIST: return "large_list";
+  case arrow_ipc::TYPE_BINARY_VIEW: return "binary_view";
+  case arrow_ipc::TYPE_UTF8_VIEW: return "utf8_view";
+  default: return "type " + std::to_string(field.type_id);
+  }
+}
+
+struct Buffer {
+  const uint8_t *data = nullptr;
+  size_t length = 0;
+};
+
+// One array of a record batch: a field's node, buffers and child arrays
+struct Array {
+  const Field *field = nullptr;
+  size_t length = 0;
+  size_t null_count = 0;
+  const uint8_t *validity = nullptr;  // nullptr when every value is valid
+  Buffer buffers[2];                  // buffers after the validity bitmap
+  std::vector<Buffer> variadic;       // view types' data buffers
+  std::vector<Array> children;
+
+  bool valid(size_t i) const { return !validity || ((validity[i >> 3] >> (i & 7)) & 1); }
+
+  bool has_nulls(size_t start, size_t count) const {
+    if (null_count == 0 || !validity) {
+      return false;
+    }
+    for (size_t i = start; i < start + count; i++) {
+      if (!valid(i)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Fixed-width values buffer holding at least `count` values of `width`
+  const uint8_t *values(size_t width, size_t count) const {
+    if (width == 0) {
+      throw FormatError("invalid Arrow value width");
+    }
+    if (count > 0 && buffers[0].length / width < count) {
+      throw FormatError("Arrow values buffer is shorter than its array");
+    }
+    return buffers[0].data;
+  }
+};
+
+template <typename T>
+T load(const uint8_t *data, size_t i) {
+  T value;
+  std::memcpy(&value, data + i * sizeof(T), sizeof(T));
+  return value;
+}
+
+// Reads the arrays of a RecordBatch, consuming field nodes and buffers in
+// depth-first field order
+class BatchReader {
+ public:
+  BatchReader(const TableReader &batch, const uint8_t *body, size_t body_length)
+      : body_(body), body_length_(body_length) {
+    if (batch.has(3)) {
+      throw FormatError("compressed Arrow record batches are not supported");
+    }
+    length_ = batch.scalar<int64_t>(0);
+    nodes_ = batch.structs(1);
+    buffers_ = batch.structs(2);
+    variadic_counts_ = batch.longs(4);
+  }
+
+  int64_t length() const { return length_; }
+
+  Array read(const Field &field) {
+    if (next_node_ >= nodes_.size()) {
+      throw FormatError("Arrow record batch has fewer field nodes than its schema");
+    }
+    auto [length, null_count] = nodes_[next_node_++];
+    if (length < 0 || null_count < 0 || null_count > length) {
+      throw FormatError("invalid Arrow field node");
+    }
+
+    Array array;
+    array.field = &field;
+    array.length = static_cast<size_t>(length);
+    array.null_count = static_cast<size_t>(null_count);
+
+    // Null arrays have no buffers (Arrow V5)
+    if (field.type_id == arrow_ipc::TYPE_NULL && field.dictionary_id < 0) {
+      return array;
+    }
+
+    Buffer validity = next_buffer();
+    if (array.null_count > 0 && validity.length > 0) {
+      if (validity.length < (array.length + 7) / 8) {
+        throw FormatError("Arrow validity bitmap is shorter than its array");
+      }
+      array.validity = validity.data;
+    }
+
+    if (field.dictionary_id >= 0) {
+      array.buffers[0] = next_buffer();  // indices
+      return array;
+    }
+
+    switch (field.type_id) {
+    case arrow_ipc::TYPE_INT:
+    case arrow_ipc::TYPE_FLOATING_POINT:
+    case arrow_ipc::TYPE_BOOL:
+    case arrow_ipc::TYPE_DECIMAL:
+    case arrow_ipc::TYPE_DATE:
+    case arrow_ipc::TYPE_TIME:
+    case arrow_ipc::TYPE_TIMESTAMP:
+    case arrow_ipc::TYPE_INTERVAL:
+    case arrow_ipc::TYPE_DURATION:
+    case arrow_ipc::TYPE_FIXED_SIZE_BINARY:
+    case arrow_ipc::TYPE_LIST:
+    case arrow_ipc::TYPE_LARGE_LIST:
+    case arrow_ipc::TYPE_MAP:
+      array.buffers[0] = next_buffer();
+      break;
+    case arrow_ipc::TYPE_BINARY:
+    case arrow_ipc::TYPE_UTF8:
+    case arrow_ipc::TYPE_LARGE_BINARY:
+    case arrow_ipc::TYPE_LARGE_UTF8:
+      array.buffers[0] = next_buffer();
+      array.buffers[1] = next_buffer();
+      break;
+    case arrow_ipc::TYPE_BINARY_VIEW:
+    case arrow_ipc::TYPE_UTF8_VIEW: {
+      array.buffers[0] = next_buffer();
+      if (next_variadic_ >= variadic_counts_.size() || variadic_counts_[next_variadic_] < 0) {
+        throw FormatError("Arrow record batch is missing variadic buffer counts");
+      }
+      for (int64_t i = 0; i < variadic_counts_[next_variadic_]; i++) {
+        array.variadic.push_back(next_buffer());
+      }
+      next_variadic_++;
+      break;
+    }
+    case arrow_ipc::TYPE_STRUCT:
+    case arrow_ipc::TYPE_FIXED_SIZE_LIST:
+      break;
+    default:
+      throw FormatError("unsupported Arrow type " + arrow_type_name(field));
+    }
+
+    for (const auto &child : field.children) {
+      array.children.push_back(read(child));
+    }
+    return array;
+  }
+
+ private:
+  const uint8_t *body_;
+  size_t body_length_;
+  int64_t length_ = 0;
+  std::vector<std::pair<int64_t, int64_t>> nodes_;
+  std::vector<std::pair<int64_t, int64_t>> buffers_;
+  std::vector<int64_t> variadic_counts_;
+  size_t next_node_ = 0;
+  size_t next_buffer_ = 0;
+  size_t next_variadic_ = 0;
+
+  Buffer next_buffer() {
+    if (next_buffer_ >= buffers_.size()) {
+      throw FormatError("Arrow record batch has fewer buffers than its schema");
+    }
+    auto [offset, length] = buffers_[next_buffer_++];
+    if (offset < 0 || length < 0 || static_cast<uint64_t>(offset) > body_length_ ||
+        static_cast<uint64_t>(length) > body_length_ - static_cast<uint64_t>(offset)) {
+      throw FormatError("Arrow buffer out of bounds");
+    }
+    return Buffer{body_ + offset, static_cast<size_t>(length)};
+  }
+};
+
+// Dictionary values by dictionary id (views into the input binary)
+using Dictionaries = std::unordered_map<int64_t, std::vector<std::string_view>>;
+
+bool is_string_like(const Field &field) {
+  switch (field.type_id) {
+  case arrow_ipc::TYPE_BINARY:
+  case arrow_ipc::TYPE_UTF8:
+  case arrow_ipc::TYPE_LARGE_BINARY:
+  case arrow_ipc::TYPE_LARGE_UTF8:
+  case arrow_ipc::TYPE_BINARY_VIEW:
+  case arrow_ipc::TYPE_UTF8_VIEW:
+  case arrow_ipc::TYPE_FIXED_SIZE_BINARY:
+    return true;
+  default:
+    return field.dictionary_id >= 0;
+  }
+}
+
+// Value access for string-like arrays
+class StringReader {
+ public:
+  StringReader(const Array &array, const Dictionaries &dictionaries) : array_(array) {
+    const Field &field = *array.field;
+    if (field.dictionary_id >= 0) {
+      auto it = dictionaries.find(field.dictionary_id);
+      if (it == dictionaries.end()) {
+        throw FormatError("Arrow dictionary " + std::to_string(field.dictionary_id) +
+                          " is used before it is sent");
+      }
+      dictionary_ = &it->second;
+      array.values(field.index_bit_width / 8, array.length);
+      return;
+    }
+    switch (field.type_id) {
+    case arrow_ipc::TYPE_BINARY:
+    case arrow_ipc::TYPE_UTF8:
+      array.values(4, array.length + 1);
+      break;
+    case arrow_ipc::TYPE_LARGE_BINARY:
+    case arrow_ipc::TYPE_LARGE_UTF8:
+      array.values(8, array.length + 1);
+      break;
+    case arrow_ipc::TYPE_BINARY_VIEW:
+    case arrow_ipc::TYPE_UTF8_VIEW:
+      array.values(16, array.length);
+      break;
+    case arrow_ipc::TYPE_FIXED_SIZE_BINARY:
+      if (field.byte_width <= 0) {
+        throw FormatError("invalid Arrow fixed_size_binary width");
+      }
+      array.values(field.byte_width, array.length);
+      break;
+    }
+  }
+
+  std::string_view at(size_t i) const {
+    const Field &field = *array_.field;
+    const uint8_t *values = array_.buffers[0].data;
+
+    if (dictionary_) {
+      int64_t index = dictionary_index(values, i);
+      if (index < 0 || static_cast<size_t>(index) >= dictionary_->size()) {
+        throw FormatError("Arrow dictionary index out of range");
+      }
+      return (*dictionary_)[index];
+    }
+
+    switch (field.type_id) {
+    case arrow_ipc::TYPE_BINARY:
+    case arrow_ipc::TYPE_UTF8:
+      return slice(load<int32_t>(values, i), load<int32_t>(values, i + 1), array_.buffers[1]);
+    case arrow_ipc::TYPE_LARGE_BINARY:
+    case arrow_ipc::TYPE_LARGE_UTF8:
+      return slice(load<int64_t>(values, i), load<int64_t>(values, i + 1), array_.buffers[1]);
+    case arrow_ipc::TYPE_FIXED_SIZE_BINARY:
+      return std::string_view(reinterpret_cast<const char *>(values) + i * field.byte_width,
+                              field.byte_width);
+    default: {
+      // View: int32 length, then the inline data (<= 12 bytes) or a 4-byte
+      // prefix, buffer index and offset
+      const uint8_t *view = values + 16 * i;
+      int32_t length = load<int32_t>(view, 0);
+      if (length <= 12) {
+        return std::string_view(reinterpret_cast<const char *>(view + 4), std::max(length, 0));
+      }
+      int32_t buffer = load<int32_t>(view + 8, 0);
+      int32_t offset = load<int32_t>(view + 12, 0);
+      if (buffer < 0 || static_cast<size_t>(buffer) >= array_.variadic.size()) {
+        throw FormatError("Arrow view buffer index out of range");
+      }
+      return slice(offset, static_cast<int64_t>(offset) + length, array_.variadic[buffer]);
+    }
+    }
+  }
+
+ private:
+  const Array &array_;
+  const std::vector<std::string_view> *dictionary_ = nullptr;
+
+  int64_t dictionary_index(const uint8_t *indices, size_t i) const {
+    const Field &field = *array_.field;
+    switch (field.index_bit_width) {
+    case 8: return field.index_signed ? load<int8_t>(indices, i) : load<uint8_t>(indices, i);
+    case 16: return field.index_signed ? load<int16_t>(indices, i) : load<uint16_t>(indices, i);
+    case 32: return field.index_signed ? load<int32_t>(indices, i) : load<uint32_t>(indices, i);
+    case 64: return load<int64_t>(indices, i);
+    default: throw FormatError("invalid Arrow dictionary index width");
+    }
+  }
+
+  static std::string_view slice(int64_t start, int64_t end, const Buffer &data) {
+    if (start < 0 || end < start || static_cast<uint64_t>(end) > data.length) {
+      throw FormatError("Arrow string offsets out of bounds");
+    }
+    return std::string_view(reinterpret_cast<const char *>(data.data) + start, end - start);
+  }
+};
+
+int64_t power_of_ten(int digits) {
+  int64_t result = 1;
+  while (digits-- > 0) {
+    result *= 10;
+  }
+  return result;
+}
+
+int64_t floor_div(int64_t value, int64_t divisor) {
+  int64_t q = value / divisor;
+  return (value % divisor != 0 && value < 0) ? q - 1 : q;
+}
+
+// True if the integer `value` is representable as T
+template <typename T, typename S>
+bool fits_in(S value) {
+  if constexpr (std::is_signed_v<S> == std::is_signed_v<T>) {
+    return value >= std::numeric_limits<T>::min() && value <= std::numeric_limits<T>::max();
+  } else if constexpr (std::is_signed_v<S>) {
+    return value >= 0 &&
+           static_cast<std::make_unsigned_t<S>>(value) <= std::numeric_limits<T>::max();
+  } else {
+    return value <= static_cast<std::make_unsigned_t<T>>(std::numeric_limits<T>::max());
+  }
+}
+
+// Appends Arrow arrays to ClickHouse columns of one block
+class Importer {
+ public:
+  explicit Importer(const Dictionaries &dictionaries) : dictionaries_(dictionaries) {}
+
+  // Appends rows [start, start + count) of `array` to `col`
+  void append(const std::string &name, ColumnRef col, const Array &array, size_t start,
+              size_t count) {
+    name_ = &name;
+    fill(col, array, start, count);
+  }
+
+ private:
+  const Dictionaries &dictionaries_;
+  const std::string *name_ = nullptr;
+
+  [[noreturn]] void mismatch(const ColumnRef &col, const Array &array) const {
+    throw ValidationError("column " + *name_ + ": cannot insert Arrow " +
+                          arrow_type_name(*array.field) + " into " + col->GetType().GetName());
+  }
+
+  [[noreturn]] void out_of_range(const ColumnRef &col, const std::string &value) const {
+    throw ValidationError("column " + *name_ + ": value " + value + " is out of range for " +
+                          col->GetType().GetName());
+  }
+
+  void fill(ColumnRef col, const Array &array, size_t start, size_t count) {
+    if (start + count > array.length) {
+      throw FormatError("Arrow child array is shorter than its offsets");
+    }
+
+    if (auto nullable = col->As<ColumnNullable>()) {
+      auto &nulls = nullable->Nulls()->As<ColumnUInt8>()->GetWritableData();
+      for (size_t i = start; i < start + count; i++) {
+        nulls.push_back(!array.valid(i));
+      }
+      fill_values(nullable->Nested(), array, start, count);
+      return;
+    }
+
+    if (col->GetType().GetCode() == Type::LowCardinality) {
+      // Build the values, then let LowCardinality dictionary-encode them
+      // (as column_lowcardinality_append_from_column does)
+      auto nested_type = col->GetType().As<LowCardinalityType>()->GetNestedType();
+      ColumnRef values = CreateColumnByType(nested_type->GetName());
+      fill(values, array, start, count);
+      std::shared_ptr<ColumnLowCardinality> encoded;
+      if (auto nullable_values = values->As<ColumnNullable>()) {
+        encoded = std::make_shared<ColumnLowCardinality>(nullable_values);
+      } else {
+        encoded = std::make_shared<ColumnLowCardinality>(values);
+      }
+      col->Append(encoded);
+      return;
+    }
+
+    if (array.has_nulls(start, count)) {
+      throw ValidationError("column " + *name_ + " has NULL values in Arrow data but " +
+                            col->GetType().GetName() + " is not Nullable");
+    }
+    fill_values(col, array, start, count);
+  }
+
+  // Values only; NULL slots get whatever the Arrow buffer holds
+  void fill_values(ColumnRef col, const Array &array, size_t start, size_t count) {
+    switch (col->GetType().GetCode()) {
+    case Type::Int8: append_numbers<int8_t>(col, array, start, count); break;
+    case Type::Int16: append_numbers<int16_t>(col, array, start, count); break;
+    case Type::Int32: append_numbers<int32_t>(col, array, start, count); break;
+    case Type::Int64: append_numbers<int64_t>(col, array, start, count); break;
+    case Type::UInt8: append_numbers<uint8_t>(col, array, start, count); break;
+    case Type::UInt16: append_numbers<uint16_t>(col, array, start, count); break;
+    case Type::UInt32: append_numbers<uint32_t>(col, array, start, count); break;
+    case Type::UInt64: append_numbers<uint64_t>(col, array, start, count); break;
+    case Type::Float32: append_numbers<float>(col, array, start, count); break;
+    case Type::Float64: append_numbers<double>(col, array, start, count); break;
+    case Type::String: append_strings<ColumnString>(col, array, start, count); break;
+    case Type::FixedString: append_strings<ColumnFixedString>(col, array, start, count); break;
+    case Type::Enum8: append_enum_names<ColumnEnum8>(col, array, start, count); break;
+    case Type::Enum16: append_enum_names<ColumnEnum16>(col, array, start, count); break;
+    case Type::Date: {
+      auto &data = col->As<ColumnDate>()->GetWritableData();
+      for (size_t i = start; i < start + count; i++) {
+        int64_t days = array.valid(i) ? floor_div(ticks_at(col, array, i, 0), 86400) : 0;
+        if (!fits_in<uint16_t>(days)) {
+          out_of_range(col, std::to_string(days) + " days");
+        }
+        data.push_back(static_cast<uint16_t>(days));
+      }
+      break;
+    }
+    case Type::DateTime: {
+      auto &data = col->As<ColumnDateTime>()->GetWritableData();
+      for (size_t i = start; i < start + count; i++) {
+        int64_t seconds = array.valid(i) ? ticks_at(col, array, i, 0) : 0;
+        if (!fits_in<uint32_t>(seconds)) {
+          out_of_range(col, std::to_string(seconds) + " seconds");
+        }
+        data.push_back(static_cast<uint32_t>(seconds));
+      }
+      break;
+    }
+    case Type::DateTime64: {
+      auto typed = col->As<ColumnDateTime64>();
+      int precision = static_cast<int>(typed->GetPrecision());
+      for (size_t i = start; i < start + count; i++) {
+        typed->Append(array.valid(i) ? ticks_at(col, array, i, precision) : 0);
+      }
+      break;
+    }
+    case Type::Decimal:
+    case Type::Decimal32:
+    case Type::Decimal64:
+    case Type::Decimal128:
+      append_decimals(col, array, start, count);
+      break;
+    case Type::Array:
+      append_arrays(col, array, start, count);
+      break;
+    default:
+      mismatch(col, array);
+    }
+  }
+
+  // Integers narrowed to an integer column are range checked; NULL slots
+  // hold arbitrary data and are stored as 0 instead
+  template <typename T, typename S>
+  void cast_values(const ColumnRef &col, std::vector<T> &data, const Array &array,
+                   const uint8_t *values, size_t start, size_t count) {
+    size_t offset = data.size();
+    data.resize(offset + count);
+    if constexpr (std::is_same_v<T, S>) {
+      std::memcpy(data.data() + offset, values + start * sizeof(T), count * sizeof(T));
+    } else {
+      for (size_t i = 0; i < count; i++) {
+        S value = load<S>(values, start + i);
+        if constexpr (std::is_integral_v<T>) {
+          if (!fits_in<T>(value)) {
+            if (array.valid(start + i)) {
+              out_of_range(col, std::to_string(value));
+            }
+            value = 0;
+          }
+        }
+        data[offset + i] = static_cast<T>(value);
+      }
+    }
+  }
+
+  template <typename T>
+  void append_numbers(ColumnRef col, const Array &array, size_t start, size_t count) {
+    auto &data = col->As<ColumnVector<T>>()->GetWritableData();
+    const Field &field = *array.field;
+    if (field.dictionary_id >= 0) {
+      mismatch(col, array);
+    }
+
+    if (field.type_id == arrow_ipc::TYPE_BOOL) {
+      const uint8_t *bits = array.values(1, (array.length + 7) / 8);
+      for (size_t i = start; i < start + count; i++) {
+        data.push_back(static_cast<T>((bits[i >> 3] >> (i & 7)) & 1));
+      }
+      return;
+    }
+
+    if (field.type_id == arrow_ipc::TYPE_FLOATING_POINT) {
+      // Floats are not truncated into integer columns
+      if constexpr (std::is_integral_v<T>) {
+        mismatch(col, array);
+      } else {
+        if (field.unit == 1) {
+          cast_values<T, float>(col, data, array, array.values(4, array.length), start, count);
+        } else if (field.unit == 2) {
+          cast_values<T, double>(col, data, array, array.values(8, array.length), start, count);
+        } else {
+          mismatch(col, array);
+        }
+        return;
+      }
+    }
+
+    if (field.type_id != arrow_ipc::TYPE_INT) {
+      mismatch(col, array);
+    }
+    const uint8_t *values = array.values(field.bit_width / 8, array.length);
+    switch (field.bit_width * (field.is_signed ? -1 : 1)) {
+    case -8: cast_values<T, int8_t>(col, data, array, values, start, count); break;
+    case -16: cast_values<T, int16_t>(col, data, array, values, start, count); break;
+    case -32: cast_values<T, int32_t>(col, data, array, values, start, count); break;
+    case -64: cast_values<T, int64_t>(col, data, array, values, start, count); break;
+    case 8: cast_values<T, uint8_t>(col, data, array, values, start, count); break;
+    case 16: cast_values<T, uint16_t>(col, data, array, values, start, count); break;
+    case 32: cast_values<T, uint32_t>(col, data, array, values, start, count); break;
+    case 64: cast_values<T, uint64_t>(col, data, array, values, start, count); break;
+    default: mismatch(col, array);
+    }
+  }
+
+  template <typename C>
+  void append_strings(ColumnRef col, const Array &array, size_t start, size_t count) {
+    if (!is_string_like(*array.field)) {
+      mismatch(col, array);
+    }
+    auto typed = col->As<C>();
+    StringReader reader(array, dictionaries_);
+    for (size_t i = start; i < start + count; i++) {
+      typed->Append(array.valid(i) ? reader.at(i) : std::string_view());
+    }
+  }
+
+  template <typename C>
+  void append_enum_names(ColumnRef col, const Array &array, size_t start, size_t count) {
+    if (!is_string_like(*array.field)) {
+      mismatch(col, array);
+    }
+    auto typed = col->As<C>();
+    StringReader reader(array, dictionaries_);
+    // NULL slots of Nullable(Enum) still need a valid value
+    std::string placeholder = EnumType(col->Type()).BeginValueToName()->second;
+    for (size_t i = start; i < start + count; i++) {
+      typed->Append(array.valid(i) ? std::string(reader.at(i)) : placeholder);
+    }
+  }
+
+  int64_t scale_ticks(const ColumnRef &col, int64_t value, int64_t factor) const {
+    if (value > std::numeric_limits<int64_t>::max() / factor ||
+        value < std::numeric_limits<int64_t>::min() / factor) {
+      out_of_range(col, std::to_string(value));
+    }
+    return value * factor;
+  }
+
+  // Value of a date or timestamp array in units of 10^-digits seconds
+  int64_t ticks_at(const ColumnRef &col, const Array &array, size_t i, int digits) const {
+    const Field &field = *array.field;
+    int source_digits;
+    int64_t value;
+    if (field.type_id == arrow_ipc::TYPE_DATE && field.dictionary_id < 0) {
+      if (field.unit == arrow_ipc::DAY) {
+        int64_t days = load<int32_t>(array.values(4, array.length), i);
+        return scale_ticks(col, days * 86400, power_of_ten(digits));
+      }
+      value = load<int64_t>(array.values(8, array.length), i);
+      source_digits = 3;
+    } else if (field.type_id == arrow_ipc::TYPE_TIMESTAMP && field.dictionary_id < 0) {
+      if (field.unit < arrow_ipc::SECOND || field.unit > arrow_ipc::NANOSECOND) {
+        throw FormatError("invalid Arrow timestamp unit");
+      }
+      value = load<int64_t>(array.values(8, array.length), i);
+      source_digits = 3 * field.unit;
+    } else {
+      mismatch(col, array);
+    }
+    if (digits >= source_digits) {
+      return scale_ticks(col, value, power_of_ten(digits - source_digits));
+    }
+    return floor_div(value, power_of_ten(source_digits - digits));
+  }
+
+  void append_decimals(ColumnRef col, const Array &array, size_t start, size_t count) {
+    const Field &field = *array.field;
+    if (field.type_id != arrow_ipc::TYPE_DECIMAL || field.bit_width != 128 ||
+        field.dictionary_id >= 0) {
+      mismatch(col, array);
+    }
+    auto typed = col->As<ColumnDecimal>();
+    int target_scale = static_cast<int>(typed->GetScale());
+    if (field.scale > target_scale) {
+      throw ValidationError("column " + *name_ + ": Arrow decimal scale " +
+                            std::to_string(field.scale) + " exceeds " +
+                            col->GetType().GetName());
+    }
+    Int128 factor = power_of_ten(target_scale - field.scale);
+    // Rescaled values must keep within the column's precision
+    Int128 limit = 1;
+    for (size_t d = 0; d < typed->GetPrecision(); d++) {
+      limit *= 10;
+    }
+    limit = (limit - 1) / factor;
+    const uint8_t *values = array.values(16, array.length);
+    for (size_t i = start; i < start + count; i++) {
+      if (!array.valid(i)) {
+        typed->Append(Int128(0));
+        continue;
+      }
+      uint64_t low = load<uint64_t>(values, 2 * i);
+      int64_t high = load<int64_t>(values, 2 * i + 1);
+      Int128 value = (Int128(high) << 64) | Int128(low);
+      if (value > limit || value < -limit) {
+        out_of_range(col, "at row " + std::to_string(i));
+      }
+      typed->Append(value * factor);
+    }
+  }
+
+  void append_arrays(ColumnRef col, const Array &array, size_t start, size_t count) {
+    const Field &field = *array.field;
+    auto typed = col->As<ColumnArray>();
+    if (array.children.size() != 1 || field.dictionary_id >= 0) {
+      mismatch(col, array);
+    }
+
+    std::vector<int64_t> offsets(count + 1);
+    switch (field.type_id) {
+    case arrow_ipc::TYPE_LIST: {
+      const uint8_t *values = array.values(4, array.length + 1);
+      for (size_t i = 0; i <= count; i++) {
+        offsets[i] = load<int32_t>(values, start + i);
+      }
+      break;
+    }
+    case arrow_ipc::TYPE_LARGE_LIST: {
+      const uint8_t *values = array.values(8, array.length + 1);
+      for (size_t i = 0; i <= count; i++) {
+        offsets[i] = load<int64_t>(values, start + i);
+      }
+      break;
+    }
+    case arrow_ipc::TYPE_FIXED_SIZE_LIST:
+      for (size_t i = 0; i <= count; i++) {
+        offsets[i] = static_cast<int64_t>(start + i) * field.byte_width;
+      }
+      break;
+    default:
+      mismatch(col, array);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+      if (offsets[i] < 0 || offsets[i + 1] < offsets[i]) {
+        throw FormatError("Arrow list offsets are not increasing");
+      }
+    }
+
+    fill(ColumnArrayAccess::data(*typed), array.children[0], static_cast<size_t>(offsets[0]),
+         static_cast<size_t>(offsets[count] - offsets[0]));
+    for (size_t i = 0; i < count; i++) {
+      ColumnArrayAccess::add_offset(*typed, static_cast<size_t>(offsets[i + 1] - offsets[i]));
+    }
+  }
+};
+
+}  // namespace
+
+// ============================================================================
+// Arrow import NIF
+// ============================================================================
+
+/// Builds a Block from an Arrow IPC stream binary
+///
+/// @param columns List of {name, clickhouse_type}; each is filled from the
+///   Arrow field of the same name, with all record batches appended
+fine::ResourcePtr<BlockResource> block_from_arrow(
+    ErlNifEnv *env,
+    ErlNifBinary ipc,
+    std::vector<std::tuple<std::string, std::string>> columns) {
+  try {
+    std::vector<ColumnRef> targets;
+    for (const auto &[name, type_name] : columns) {
+      ColumnRef col = CreateColumnByType(type_name);
+      if (!col) {
+        throw ValidationError("failed to create column of type: " + type_name);
+      }
+      targets.push_back(col);
+    }
+
+    arrow_ipc::StreamReader stream(ipc.data, ipc.size);
+    arrow_ipc::Message message;
+    std::vector<Field> fields;
+    std::vector<size_t> positions;  // Arrow field index of each column
+    bool have_schema = false;
+    Dictionaries dictionaries;
+
+    while (stream.next(message)) {
+      switch (message.type) {
+      case arrow_ipc::HEADER_SCHEMA: {
+        if (have_schema) {
+          throw FormatError("Arrow IPC stream has more than one schema");
+        }
+        have_schema = true;
+        if (message.header.scalar<int16_t>(0) != 0) {
+          throw FormatError("big-endian Arrow data is not supported");
+        }
+        for (const auto &table : message.header.tables(1)) {
+          fields.push_back(read_field(table));
+        }
+        for (const auto &[name, type_name] : columns) {
+          size_t position = 0;
+          while (position < fields.size() && fields[position].name != name) {
+            position++;
+          }
+          if (position == fields.size()) {
+            throw ValidationError("Arrow stream has no field " + name);
+          }
+          positions.push_back(position);
+        }
+        break;
+      }
+
+      case arrow_ipc::HEADER_DICTIONARY_BATCH: {
+        int64_t id = message.header.scalar<int64_t>(0);
+        const Field *field = find_dictionary_field(fields, id);
+        if (!field) {
+          throw FormatError("Arrow dictionary " + std::to_string(id) + " is not in the schema");
+        }
+        Field values_field = *field;
+        values_field.dictionary_id = -1;
+        if (!is_string_like(values_field)) {
+          throw ValidationError("only string dictionaries are supported, field " + field->name +
+                                " has " + arrow_type_name(values_field) + " values");
+        }
+
+        BatchReader reader(message.header.table(1), message.body, message.body_length);
+        Array values = reader.read(values_field);
+        StringReader strings(values, dictionaries);
+        auto &dictionary = dictionaries[id];
+        if (!message.header.scalar<uint8_t>(2)) {  // isDelta
+          dictionary.clear();
+        }
+        for (size_t i = 0; i < values.length; i++) {
+          dictionary.push_back(values.valid(i) ? strings.at(i) : std::string_view());
+        }
+        break;
+      }
+
+      case arrow_ipc::HEADER_RECORD_BATCH: {
+        if (!have_schema) {
+          throw FormatError("Arrow record batch before the schema");
+        }
+        BatchReader reader(message.header, message.body, message.body_length);
+        std::vector<Array> arrays;
+        for (const auto &field : fields) {
+          arrays.push_back(reader.read(field));
+        }
+
+        size_t length = static_cast<size_t>(reader.length());
+        Importer importer(dictionaries);
+        for (size_t c = 0; c < columns.size(); c++) {
+          importer.append(std::get<0>(columns[c]), targets[c], arrays[positions[c]], 0, length);
+        }
+        break;
+      }
+
+      default:
+        throw FormatError("unexpected Arrow IPC message type " + std::to_string(message.type));
+      }
+    }
+
+    if (!have_schema) {
+      throw FormatError("Arrow IPC stream has no schema");
+    }
+
+    auto block = std::make_shared<Block>();
+    for (size_t c = 0; c < columns.size(); c++) {
+      block->AppendColumn(std::get<0>(columns[c]), targets[c]);
+    }
+    return fine::make_resource<BlockResource>(block);
+  } catch (const FormatError &e) {
+    throw std::runtime_error(
+        encode_clickhouse_error(ValidationError(std::string("invalid Arrow IPC stream: ") +
+                                                e.what())));
+  } catch (const std::exception &e) {
+    throw std::runtime_error(encode_clickhouse_error(e));
+  }
+}
+FINE_NIF(block_from_arrow, NATCH_DIRTY_CPU);
@@ -0,0 +1,479 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Minimal writer and reader for the Arrow IPC streaming format, without
+// depending on the Arrow or FlatBuffers libraries.
+//
+// An IPC stream is a sequence of encapsulated messages:
+//
+//   <0xFFFFFFFF> <int32 metadata size> <Message flatbuffer, padded to 8>
+//   <body>
+//
+// terminated by <0xFFFFFFFF> <0x00000000>. Only the parts of the Message,
+// Schema and RecordBatch flatbuffer schemas that Natch emits or imports are
+// covered
+// (see https://arrow.apache.org/docs/format/Columnar.html#serialization-and-interprocess-communication-ipc).
+
+namespace arrow_ipc {
+
+// FlatBuffers builder. Like the reference implementation it builds the
+// buffer back to front (children before parents), so every offset points
+// forward. Bytes are stored reversed and flipped in finish().
+class FlatBufferBuilder {
+ public:
+  // Position of an object, counted from the end of the buffer
+  using Offset = uint32_t;
+
+  Offset create_string(std::string_view value) {
+    align(4, value.size() + 1);
+    rev_.push_back(0);
+    for (size_t i = value.size(); i-- > 0;) {
+      rev_.push_back(static_cast<uint8_t>(value[i]));
+    }
+    push<uint32_t>(static_cast<uint32_t>(value.size()));
+    return size();
+  }
+
+  // Vector of {int64, int64} structs (FieldNode and Buffer)
+  Offset create_struct_vector(const std::vector<std::pair<int64_t, int64_t>> &items) {
+    align(8, items.size() * 16);
+    for (size_t i = items.size(); i-- > 0;) {
+      push<int64_t>(items[i].second);
+      push<int64_t>(items[i].first);
+    }
+    push<uint32_t>(static_cast<uint32_t>(items.size()));
+    return size();
+  }
+
+  // Vector of tables
+  Offset create_offset_vector(const std::vector<Offset> &offsets) {
+    align(4, offsets.size() * 4);
+    for (size_t i = offsets.size(); i-- > 0;) {
+      push<uint32_t>(refer_to(offsets[i]));
+    }
+    push<uint32_t>(static_cast<uint32_t>(offsets.size()));
+    return size();
+  }
+
+  void start_table() {
+    fields_.clear();
+    table_start_ = size();
+  }
+
+  template <typename T>
+  void add_scalar(uint16_t id, T value) {
+    align(sizeof(T), 0);
+    push<T>(value);
+    fields_.emplace_back(id, size());
+  }
+
+  void add_offset(uint16_t id, Offset target) {
+    align(4, 0);
+    push<uint32_t>(refer_to(target));
+    fields_.emplace_back(id, size());
+  }
+
+  Offset end_table() {
+    align(4, 0);
+    push<int32_t>(0);  // vtable offset, patched below
+    Offset table = size();
+
+    uint16_t field_count = 0;
+    for (const auto &field : fields_) {
+      field_count = std::max<uint16_t>(field_count, field.first + 1);
+    }
+    std::vector<uint16_t> vtable(field_count, 0);
+    for (const auto &field : fields_) {
+      vtable[field.first] = static_cast<uint16_t>(table - field.second);
+    }
+
+    align(2, 0);
+    for (size_t i = vtable.size(); i-- > 0;) {
+      push<uint16_t>(vtable[i]);
+    }
+    push<uint16_t>(static_cast<uint16_t>(table - table_start_));
+    push<uint16_t>(static_cast<uint16_t>(4 + 2 * field_count));
+    Offset vtable_pos = size();
+
+    patch<int32_t>(table, static_cast<int32_t>(vtable_pos - table));
+    return table;
+  }
+
+  std::vector<uint8_t> finish(Offset root) {
+    align(min_align_, 4);
+    push<uint32_t>(refer_to(root));
+    return std::vector<uint8_t>(rev_.rbegin(), rev_.rend());
+  }
+
+ private:
+  std::vector<uint8_t> rev_;
+  std::vector<std::pair<uint16_t, Offset>> fields_;
+  Offset table_start_ = 0;
+  size_t min_align_ = 1;
+
+  Offset size() const { return static_cast<Offset>(rev_.size()); }
+
+  // Pads so that `alignment` divides the size after `additional` more bytes
+  void align(size_t alignment, size_t additional) {
+    min_align_ = std::max(min_align_, alignment);
+    size_t pad = (alignment - (rev_.size() + additional) % alignment) % alignment;
+    rev_.insert(rev_.end(), pad, 0);
+  }
+
+  // Little-endian value, most significant byte first since rev_ is reversed
+  template <typename T>
+  void push(T value) {
+    uint8_t bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    for (size_t i = sizeof(T); i-- > 0;) {
+      rev_.push_back(bytes[i]);
+    }
+  }
+
+  template <typename T>
+  void patch(Offset position, T value) {
+    uint8_t bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    for (size_t i = 0; i < sizeof(T); i++) {
+      rev_[position - 1 - i] = bytes[i];
+    }
+  }
+
+  // uoffset for a value about to be pushed at the current position
+  uint32_t refer_to(Offset target) const { return size() + 4 - target; }
+};
+
+// Flatbuffer enum values from Schema.fbs and Message.fbs
+constexpr int16_t METADATA_V5 = 4;
+
+enum MessageHeader : uint8_t {
+  HEADER_SCHEMA = 1,
+  HEADER_DICTIONARY_BATCH = 2,
+  HEADER_RECORD_BATCH = 3,
+};
+
+enum TypeId : uint8_t {
+  TYPE_NULL = 1,
+  TYPE_INT = 2,
+  TYPE_FLOATING_POINT = 3,
+  TYPE_BINARY = 4,
+  TYPE_UTF8 = 5,
+  TYPE_BOOL = 6,
+  TYPE_DECIMAL = 7,
+  TYPE_DATE = 8,
+  TYPE_TIME = 9,
+  TYPE_TIMESTAMP = 10,
+  TYPE_INTERVAL = 11,
+  TYPE_LIST = 12,
+  TYPE_STRUCT = 13,
+  TYPE_FIXED_SIZE_BINARY = 15,
+  TYPE_FIXED_SIZE_LIST = 16,
+  TYPE_MAP = 17,
+  TYPE_DURATION = 18,
+  TYPE_LARGE_BINARY = 19,
+  TYPE_LARGE_UTF8 = 20,
+  TYPE_LARGE_LIST = 21,
+  TYPE_BINARY_VIEW = 23,
+  TYPE_UTF8_VIEW = 24,
+};
+
+enum TimeUnit : int16_t { SECOND = 0, MILLISECOND = 1, MICROSECOND = 2, NANOSECOND = 3 };
+
+enum DateUnit : int16_t { DAY = 0, DATE_MILLISECOND = 1 };
+
+// Body of a record or dictionary batch: field nodes and buffers in
+// depth-first field order, and the buffer bytes padded to 8
+struct BatchBody {
+  std::vector<std::pair<int64_t, int64_t>> nodes;    // length, null count
+  std::vector<std::pair<int64_t, int64_t>> buffers;  // offset, length
+  std::vector<uint8_t> bytes;
+
+  // Appends a zero-filled buffer and returns its storage, valid until the
+  // next buffer is added
+  uint8_t *add_buffer(size_t length) {
+    size_t offset = bytes.size();
+    bytes.resize(offset + ((length + 7) & ~size_t(7)), 0);
+    buffers.emplace_back(static_cast<int64_t>(offset), static_cast<int64_t>(length));
+    return bytes.data() + offset;
+  }
+
+  void add_buffer(const void *data, size_t length) {
+    if (length > 0) {
+      std::memcpy(add_buffer(length), data, length);
+    } else {
+      add_buffer(0);
+    }
+  }
+};
+
+// Appends one encapsulated message to `out`
+inline void write_message(std::vector<uint8_t> &out, const std::vector<uint8_t> &metadata,
+                          const std::vector<uint8_t> &body) {
+  uint32_t continuation = 0xFFFFFFFF;
+  uint32_t padded = static_cast<uint32_t>((metadata.size() + 7) & ~size_t(7));
+  size_t start = out.size();
+  out.resize(start + 8 + padded, 0);
+  std::memcpy(out.data() + start, &continuation, 4);
+  std::memcpy(out.data() + start + 4, &padded, 4);
+  std::memcpy(out.data() + start + 8, metadata.data(), metadata.size());
+  out.insert(out.end(), body.begin(), body.end());
+}
+
+inline void write_end_of_stream(std::vector<uint8_t> &out) {
+  const uint8_t eos[8] = {0xFF, 0xFF, 0xFF, 0xFF, 0, 0, 0, 0};
+  out.insert(out.end(), eos, eos + 8);
+}
+
+// Message flatbuffer wrapping a header table built in `fbb`
+inline std::vector<uint8_t> finish_message(FlatBufferBuilder &fbb, MessageHeader type,
+                                           FlatBufferBuilder::Offset header,
+                                           int64_t body_length) {
+  fbb.start_table();
+  fbb.add_scalar<int64_t>(3, body_length);
+  fbb.add_offset(2, header);
+  fbb.add_scalar<int16_t>(0, METADATA_V5);
+  fbb.add_scalar<uint8_t>(1, type);
+  return fbb.finish(fbb.end_table());
+}
+
+// RecordBatch (and optionally DictionaryBatch) message metadata for `body`
+inline std::vector<uint8_t> batch_message(int64_t length, const BatchBody &body,
+                                          const int64_t *dictionary_id = nullptr) {
+  FlatBufferBuilder fbb;
+  auto nodes = fbb.create_struct_vector(body.nodes);
+  auto buffers = fbb.create_struct_vector(body.buffers);
+
+  fbb.start_table();
+  fbb.add_scalar<int64_t>(0, length);
+  fbb.add_offset(1, nodes);
+  fbb.add_offset(2, buffers);
+  auto batch = fbb.end_table();
+
+  if (!dictionary_id) {
+    return finish_message(fbb, HEADER_RECORD_BATCH, batch, body.bytes.size());
+  }
+
+  fbb.start_table();
+  fbb.add_scalar<int64_t>(0, *dictionary_id);
+  fbb.add_offset(1, batch);
+  fbb.add_scalar<uint8_t>(2, 0);  // isDelta
+  auto dictionary = fbb.end_table();
+  return finish_message(fbb, HEADER_DICTIONARY_BATCH, dictionary, body.bytes.size());
+}
+
+// ============================================================================
+// Reading
+// ============================================================================
+
+// Malformed or unsupported input
+struct FormatError : std::runtime_error {
+  using std::runtime_error::runtime_error;
+};
+
+// Bounds-checked view of one flatbuffer table. Values are read with memcpy,
+// so neither the buffer nor its fields need to be aligned.
+class TableReader {
+ public:
+  TableReader() = default;
+
+  TableReader(const uint8_t *buf, size_t size, size_t pos) : buf_(buf), size_(size), pos_(pos) {
+    check(pos, 4);
+    int64_t vtable = static_cast<int64_t>(pos) - load<int32_t>(pos);
+    if (vtable < 0) {
+      throw FormatError("flatbuffer vtable out of bounds");
+    }
+    vtable_ = static_cast<size_t>(vtable);
+    check(vtable_, 4);
+    vtable_size_ = load<uint16_t>(vtable_);
+    check(vtable_, vtable_size_);
+  }
+
+  // Root table of a finished buffer
+  static TableReader root(const uint8_t *buf, size_t size) {
+    TableReader reader(buf, size);
+    reader.check(0, 4);
+    return TableReader(buf, size, reader.load<uint32_t>(0));
+  }
+
+  bool has(uint16_t id) const { return field(id) != 0; }
+
+  template <typename T>
+  T scalar(uint16_t id, T default_value = T()) const {
+    size_t f = field(id);
+    if (!f) {
+      return default_value;
+    }
+    check(pos_ + f, sizeof(T));
+    return load<T>(pos_ + f);
+  }
+
+  TableReader table(uint16_t id) const { return TableReader(buf_, size_, target(id)); }
+
+  std::string_view string(uint16_t id) const {
+    size_t pos = target(id);
+    uint32_t length = load<uint32_t>(pos);
+    check(pos + 4, length);
+    return std::string_view(reinterpret_cast<const char *>(buf_ + pos + 4), length);
+  }
+
+  // Vector of tables; empty when the field is absent
+  std::vector<TableReader> tables(uint16_t id) const {
+    std::vector<TableReader> result;
+    size_t count = 0;
+    size_t start = vector(id, 4, count);
+    for (size_t i = 0; i < count; i++) {
+      size_t element = start + 4 * i;
+      result.emplace_back(buf_, size_, element + load<uint32_t>(element));
+    }
+    return result;
+  }
+
+  // Vector of {int64, int64} structs (FieldNode and Buffer)
+  std::vector<std::pair<int64_t, int64_t>> structs(uint16_t id) const {
+    std::vector<std::pair<int64_t, int64_t>> result;
+    size_t count = 0;
+    size_t start = vector(id, 16, count);
+    for (size_t i = 0; i < count; i++) {
+      result.emplace_back(load<int64_t>(start + 16 * i), load<int64_t>(start + 16 * i + 8));
+    }
+    return result;
+  }
+
+  std::vector<int64_t> longs(uint16_t id) const {
+    std::vector<int64_t> result;
+    size_t count = 0;
+    size_t start = vector(id, 8, count);
+    for (size_t i = 0; i < count; i++) {
+      result.push_back(load<int64_t>(start + 8 * i));
+    }
+    return result;
+  }
+
+ private:
+  const uint8_t *buf_ = nullptr;
+  size_t size_ = 0;
+  size_t pos_ = 0;
+  size_t vtable_ = 0;
+  uint16_t vtable_size_ = 0;
+
+  TableReader(const uint8_t *buf, size_t size) : buf_(buf), size_(size) {}
+
+  void check(size_t pos, size_t length) const {
+    if (pos > size_ || length > size_ - pos) {
+      throw FormatError("flatbuffer offset out of bounds");
+    }
+  }
+
+  template <typename T>
+  T load(size_t pos) const {
+    T value;
+    std::memcpy(&value, buf_ + pos, sizeof(T));
+    return value;
+  }
+
+  size_t field(uint16_t id) const {
+    size_t slot = 4 + 2 * static_cast<size_t>(id);
+    return slot + 2 <= vtable_size_ ? load<uint16_t>(vtable_ + slot) : 0;
+  }
+
+  // Position an offset field points to
+  size_t target(uint16_t id) const {
+    size_t f = field(id);
+    if (!f) {
+      throw FormatError("missing required flatbuffer field");
+    }
+    check(pos_ + f, 4);
+    size_t pos = pos_ + f + load<uint32_t>(pos_ + f);
+    check(pos, 4);
+    return pos;
+  }
+
+  // Element count and position of the first element of a vector field
+  size_t vector(uint16_t id, size_t element_size, size_t &count) const {
+    count = 0;
+    if (!has(id)) {
+      return 0;
+    }
+    size_t pos = target(id);
+    count = load<uint32_t>(pos);
+    if (count > (size_ - pos - 4) / element_size) {
+      throw FormatError("flatbuffer vector out of bounds");
+    }
+    return pos + 4;
+  }
+};
+
+struct Message {
+  MessageHeader type;
+  TableReader header;
+  const uint8_t *body;
+  size_t body_length;
+};
+
+// Splits an IPC stream into messages. Also accepts the pre-1.0 framing
+// without the continuation marker, and a stream that ends without one.
+class StreamReader {
+ public:
+  StreamReader(const uint8_t *data, size_t size) : data_(data), size_(size) {}
+
+  // Reads the next message; false at the end of the stream
+  bool next(Message &message) {
+    if (pos_ == size_) {
+      return false;
+    }
+    uint32_t metadata_size = read_u32();
+    if (metadata_size == 0xFFFFFFFF) {
+      metadata_size = read_u32();
+    }
+    if (metadata_size == 0) {
+      return false;
+    }
+    need(metadata_size);
+    TableReader root = TableReader::root(data_ + pos_, metadata_size);
+    pos_ += metadata_size;
+
+    if (root.scalar<int16_t>(0) < METADATA_V5 - 1) {
+      throw FormatError("Arrow IPC metadata versions before V4 are not supported");
+    }
+    message.type = static_cast<MessageHeader>(root.scalar<uint8_t>(1));
+    message.header = root.has(2) ? root.table(2) : TableReader();
+    int64_t body_length = root.scalar<int64_t>(3);
+    if (body_length < 0) {
+      throw FormatError("negative message body length");
+    }
+    need(static_cast<size_t>(body_length));
+    message.body = data_ + pos_;
+    message.body_length = static_cast<size_t>(body_length);
+    pos_ += message.body_length;
+    return true;
+  }
+
+ private:
+  const uint8_t *data_;
+  size_t size_;
+  size_t pos_ = 0;
+
+  void need(size_t length) const {
+    if (length > size_ - pos_) {
+      throw FormatError("truncated Arrow IPC stream");
+    }
+  }
+
+  uint32_t read_u32() {
+    need(4);
+    uint32_t value;
+    std::memcpy(&value, data_ + pos_, 4);
+    pos_ += 4;
+    return value;
+  }
+};
+
+}  // namespace arrow_ipc
@@ -0,0 +1,65 @@
+#pragma once
+
+// Async request support: a NIF queues work on the client's worker thread and
+// returns a reference immediately. The worker builds the result in a
+// process-independent env and sends it straight to the caller as
+//
+//   {:natch_async, ref, {:ok, result}} | {:natch_async, ref, {:error, json}}
+//
+// so results never pass through the Connection GenServer.
+
+#include <erl_nif.h>
+#include <fine.hpp>
+#include <clickhouse/client.h>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <utility>
+#include "client_resource.h"
+#include "error_encoding.h"
+
+struct AsyncReply {
+  ErlNifPid pid;
+  ErlNifEnv *env;
+  ERL_NIF_TERM ref;
+};
+
+inline ERL_NIF_TERM make_error_binary(ErlNifEnv *env, const std::string& message) {
+  ERL_NIF_TERM term;
+  unsigned char *data = enif_make_new_binary(env, message.size(), &term);
+  std::memcpy(data, message.data(), message.size());
+  return term;
+}
+
+// Queue `work` on the client's worker thread. `work` is called as
+// work(msg_env, client) with the client locked and must return the result
+// term built in msg_env. The job keeps a reference to the client until it
+// has run. Returns the request reference in the caller's env.
+template <typename Work>
+ERL_NIF_TERM submit_async(ErlNifEnv *env, fine::ResourcePtr<ClientResource> client, Work work) {
+  ERL_NIF_TERM ref = enif_make_ref(env);
+
+  AsyncReply reply;
+  enif_self(env, &reply.pid);
+  reply.env = enif_alloc_env();
+  reply.ref = enif_make_copy(reply.env, ref);
+
+  client->submit([reply, client, work = std::move(work)]() mutable {
+    ERL_NIF_TERM result;
+    try {
+      ClientLock lock(*client);
+      result = enif_make_tuple2(reply.env, enif_make_atom(reply.env, "ok"),
+                                work(reply.env, *client));
+    } catch (const std::exception& e) {
+      result = enif_make_tuple2(reply.env, enif_make_atom(reply.env, "error"),
+                                make_error_binary(reply.env, encode_clickhouse_error(e)));
+    }
+
+    ERL_NIF_TERM msg = enif_make_tuple3(reply.env, enif_make_atom(reply.env, "natch_async"),
+                                        reply.ref, result);
+    enif_send(nullptr, &reply.pid, reply.env, msg);
+    enif_free_env(reply.env);
+  });
+
+  return ref;
+}
@@ -4,24 +4,15 @@
 #include <string>
 #include <memory>
 #include <stdexcept>
+#include "async.h"
+#include "block_resource.h"
+#include "client_resource.h"
+#include "column_resource.h"
 #include "error_encoding.h"
+#include "nif_flags.h"
 
 using namespace clickhouse;
 
-// Forward declare ColumnResource from column.cpp
-struct ColumnResource {
-  std::shared_ptr<Column> ptr;
-  ColumnResource(std::shared_ptr<Column> p) : ptr(p) {}
-};
-
-// Wrapper for Block
-struct BlockResource {
-  std::shared_ptr<Block> ptr;
-
-  BlockResource() : ptr(std::make_shared<Block>()) {}
-  BlockResource(std::shared_ptr<Block> p) : ptr(p) {}
-};
-
 // Declare BlockResource as a FINE resource
 FINE_RESOURCE(BlockResource);
 
@@ -71,24 +62,34 @@ uint64_t block_column_count(
 }
 FINE_NIF(block_column_count, 0);
 
-// Forward declare Client (from minimal.cpp)
-// We need this to avoid duplicate FINE_RESOURCE declarations
-namespace clickhouse {
-  class Client;
-}
-
 // Insert a block into a table
 fine::Atom client_insert(
     ErlNifEnv *env,
-    fine::ResourcePtr<Client> client,
+    fine::ResourcePtr<ClientResource> client,
     std::string table_name,
     fine::ResourcePtr<BlockResource> block_res) {
   try {
     // Block is copied by Insert
-    client->Insert(table_name, *block_res->ptr);
+    ClientLock lock(*client);
+    client->ptr->Insert(table_name, *block_res->ptr);
     return fine::Atom("ok");
   } catch (const std::exception& e) {
     throw std::runtime_error(encode_clickhouse_error(e));
   }
 }
-FINE_NIF(client_insert, 0);
+FINE_NIF(client_insert, NATCH_DIRTY_IO);
+
+// Queue an insert on the client's worker thread (see async.h)
+// The block resource is kept alive by the job until the insert completes
+fine::Term client_insert_async(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ClientResource> client,
+    std::string table_name,
+    fine::ResourcePtr<BlockResource> block_res) {
+  std::shared_ptr<Block> block = block_res->ptr;
+  return submit_async(env, client, [table_name, block](ErlNifEnv *msg_env, ClientResource &c) {
+    c.ptr->Insert(table_name, *block);
+    return enif_make_atom(msg_env, "ok");
+  });
+}
+FINE_NIF(client_insert_async, 0);
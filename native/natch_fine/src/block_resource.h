@@ -0,0 +1,13 @@
+#pragma once
+
+#include <clickhouse/block.h>
+#include <memory>
+
+// Wrapper to hold shared_ptr<Block> since FINE uses ResourcePtr. Declared as
+// a FINE resource in block.cpp.
+struct BlockResource {
+  std::shared_ptr<clickhouse::Block> ptr;
+
+  BlockResource() : ptr(std::make_shared<clickhouse::Block>()) {}
+  BlockResource(std::shared_ptr<clickhouse::Block> p) : ptr(p) {}
+};
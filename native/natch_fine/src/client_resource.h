@@ -0,0 +1,152 @@
+#pragma once
+
+#include <fine.hpp>
+#include <clickhouse/client.h>
+#include <clickhouse/exceptions.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "conversion_plan.h"
+
+// Defined in minimal.cpp
+clickhouse::ClientOptions build_client_options(
+    const std::string& host,
+    uint64_t port,
+    const std::string& database,
+    const std::string& user,
+    const std::string& password,
+    bool compression,
+    bool ssl,
+    uint64_t connect_timeout,
+    uint64_t recv_timeout,
+    uint64_t send_timeout);
+
+// Job queue of a client's async worker thread. The thread is detached and
+// shares this state with the client, so neither side waits for the other:
+// the client's destructor only tells an idle worker to exit.
+struct AsyncWorker {
+  using Job = std::function<void()>;
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<Job> jobs;
+  bool started = false;
+  bool stopping = false;
+
+  // Runs jobs one at a time in submission order until stopped. Each job is
+  // destroyed outside the lock, since dropping the last reference to the
+  // client in it stops this worker.
+  void loop() {
+    for (;;) {
+      Job job;
+      {
+        std::unique_lock<std::mutex> guard(mutex);
+        cv.wait(guard, [this] { return stopping || !jobs.empty(); });
+        if (jobs.empty()) {
+          return;
+        }
+        job = std::move(jobs.front());
+        jobs.pop_front();
+      }
+      job();
+    }
+  }
+};
+
+// Wrapper to hold a clickhouse::Client plus the state shared by every NIF
+// that talks to it. Requests arrive from the Connection GenServer, from
+// streaming cursors and from the async worker, so each request takes `mutex`
+// for its whole duration.
+struct ClientResource {
+  std::unique_ptr<clickhouse::Client> ptr;
+  std::mutex mutex;
+
+  // Set while a streaming cursor or an insert session owns the connection
+  std::atomic<bool> streaming{false};
+
+  // Set when an insert session is garbage collected while its INSERT is
+  // still open. The destructor cannot do network I/O, so the next request
+  // resets the connection before using it (see reset_if_needed).
+  std::atomic<bool> needs_reset{false};
+
+  // Conversion plans of this connection's recent result headers
+  PlanCache plans;
+
+  ClientResource(const clickhouse::ClientOptions& opts)
+      : ptr(std::make_unique<clickhouse::Client>(opts)) {}
+
+  // Queued jobs hold a reference to the client (see submit_async), so no
+  // job is pending here; the worker, if any, is idle or finishing the job
+  // that dropped the last reference, and exits on its own.
+  ~ClientResource() {
+    {
+      std::lock_guard<std::mutex> guard(worker_->mutex);
+      worker_->stopping = true;
+    }
+    worker_->cv.notify_all();
+  }
+
+  // Reconnects if an abandoned insert session left the connection in the
+  // middle of an INSERT. Call with `mutex` held. Best effort: a failed
+  // reconnect surfaces as the error of the request itself.
+  void reset_if_needed() {
+    if (needs_reset.exchange(false)) {
+      try {
+        ptr->ResetConnection();
+      } catch (const std::exception &) {
+      }
+    }
+  }
+
+  // Queue a job for the async worker thread, starting it on first use.
+  // Jobs run one at a time in submission order.
+  void submit(AsyncWorker::Job job) {
+    {
+      std::lock_guard<std::mutex> guard(worker_->mutex);
+      worker_->jobs.push_back(std::move(job));
+      if (!worker_->started) {
+        worker_->started = true;
+        std::thread([worker = worker_] { worker->loop(); }).detach();
+      }
+    }
+    worker_->cv.notify_one();
+  }
+
+ private:
+  std::shared_ptr<AsyncWorker> worker_ = std::make_shared<AsyncWorker>();
+};
+
+[[noreturn]] inline void throw_client_busy() {
+  throw clickhouse::ValidationError(
+      "connection is busy with an open stream; finish or close it, "
+      "or use a separate connection");
+}
+
+// Scoped lock for one request on a client. Fails fast instead of blocking
+// when the connection is owned by an open cursor: waiting would deadlock a
+// process that issues queries while consuming its own stream. The flag is
+// checked again once the mutex is held, because an insert session claims
+// the connection without keeping the mutex between its calls and may have
+// opened its INSERT while this request was waiting.
+class ClientLock {
+ public:
+  explicit ClientLock(ClientResource& client) : lock_(client.mutex, std::defer_lock) {
+    if (client.streaming) {
+      throw_client_busy();
+    }
+    lock_.lock();
+    if (client.streaming) {
+      lock_.unlock();
+      throw_client_busy();
+    }
+    client.reset_if_needed();
+  }
+
+ private:
+  std::unique_lock<std::mutex> lock_;
+};
@@ -11,20 +11,18 @@
 #include <clickhouse/columns/tuple.h>
 #include <clickhouse/columns/map.h>
 #include <clickhouse/columns/lowcardinality.h>
+#include <clickhouse/columns/enum.h>
+#include <cstring>
 #include <string>
 #include <memory>
 #include <stdexcept>
+#include "column_resource.h"
+#include "enum_terms.h"
 #include "error_encoding.h"
+#include "nif_flags.h"
 
 using namespace clickhouse;
 
-// Wrapper to hold shared_ptr<Column> since FINE uses ResourcePtr
-struct ColumnResource {
-  std::shared_ptr<Column> ptr;
-
-  ColumnResource(std::shared_ptr<Column> p) : ptr(p) {}
-};
-
 // Declare ColumnResource as a FINE resource
 FINE_RESOURCE(ColumnResource);
 
@@ -154,7 +152,7 @@ fine::Atom column_uint64_append_bulk(
     throw std::runtime_error(encode_clickhouse_error(e));
   }
 }
-FINE_NIF(column_uint64_append_bulk, 0);
+FINE_NIF(column_uint64_append_bulk, NATCH_DIRTY_CPU);
 
 // Bulk append Int64 values
 fine::Atom column_int64_append_bulk(
@@ -171,7 +169,7 @@ fine::Atom column_int64_append_bulk(
     throw std::runtime_error(encode_clickhouse_error(e));
   }
 }
-FINE_NIF(column_int64_append_bulk, 0);
+FINE_NIF(column_int64_append_bulk, NATCH_DIRTY_CPU);
 
 // Bulk append String values
 fine::Atom column_string_append_bulk(
@@ -188,7 +186,7 @@ fine::Atom column_string_append_bulk(
     throw std::runtime_error(encode_clickhouse_error(e));
   }
 }
-FINE_NIF(column_string_append_bulk, 0);
+FINE_NIF(column_string_append_bulk, NATCH_DIRTY_CPU);
 
 // Bulk append Float64 values
 fine::Atom column_float64_append_bulk(
@@ -205,7 +203,7 @@ fine::Atom column_float64_append_bulk(
     throw std::runtime_error(encode_clickhouse_error(e));
   }
 }
-FINE_NIF(column_float64_append_bulk, 0);
+FINE_NIF(column_float64_append_bulk, NATCH_DIRTY_CPU);
 
 // Bulk append DateTime values (Unix timestamps as uint64)
 fine::Atom column_datetime_append_bulk(
@@ -222,7 +220,7 @@ fine::Atom column_datetime_append_bulk(
     throw std::runtime_error(encode_clickhouse_error(e));
   }
 }
-FINE_NIF(column_datetime_append_bulk, 0);
+FINE_NIF(column_datetime_append_bulk, NATCH_DIRTY_CPU);
 
 // Bulk append DateTime64 values (microsecond timestamps as int64)
 fine::Atom column_datetime64_append_bulk(
@@ -239,7 +237,7 @@ fine::Atom column_datetime64_append_bulk(
     throw std::runtime_error(encode_clickhouse_error(e));
   }
 }
-FINE_NIF(column_datetime64_append_bulk, 0);
+FINE_NIF(column_datetime64_append_bulk, NATCH_DIRTY_CPU);
 
 // Bulk append Decimal64 values (scaled int64 values)
 fine::Atom column_decimal_append_bulk(
@@ -257,95 +255,54 @@ fine::Atom column_decimal_append_bulk(
     throw std::runtime_error(encode_clickhouse_error(e));
   }
 }
-FINE_NIF(column_decimal_append_bulk, 0);
-
-// Bulk append Nullable(UInt64) values
-fine::Atom column_nullable_uint64_append_bulk(
-    ErlNifEnv *env,
-    fine::ResourcePtr<ColumnResource> col_res,
-    std::vector<uint64_t> values,
-    std::vector<uint64_t> nulls) {
-  try {
-    auto nullable_col = std::static_pointer_cast<ColumnNullable>(col_res->ptr);
-    auto nested = nullable_col->Nested()->As<ColumnUInt64>();
-    auto null_map = nullable_col->Nulls()->As<ColumnUInt8>();
+FINE_NIF(column_decimal_append_bulk, NATCH_DIRTY_CPU);
 
-    for (size_t i = 0; i < values.size(); i++) {
-      nested->Append(values[i]);
-      null_map->Append(static_cast<uint8_t>(nulls[i]));
-    }
-    return fine::Atom("ok");
-  } catch (const std::exception& e) {
-    throw std::runtime_error(encode_clickhouse_error(e));
-  }
-}
-FINE_NIF(column_nullable_uint64_append_bulk, 0);
+// Nullable(T) columns of any nested type are appended in two steps: the
+// values (with placeholders in NULL rows) go through the nested column's own
+// typed bulk or packed append, then the null map is written in one go.
 
-// Bulk append Nullable(Int64) values
-fine::Atom column_nullable_int64_append_bulk(
+// The nested column of a Nullable. It shares the Nullable's storage, so the
+// typed append NIFs write straight into it without a temporary column.
+fine::ResourcePtr<ColumnResource> column_nullable_nested(
     ErlNifEnv *env,
-    fine::ResourcePtr<ColumnResource> col_res,
-    std::vector<int64_t> values,
-    std::vector<uint64_t> nulls) {
+    fine::ResourcePtr<ColumnResource> col_res) {
   try {
     auto nullable_col = std::static_pointer_cast<ColumnNullable>(col_res->ptr);
-    auto nested = nullable_col->Nested()->As<ColumnInt64>();
-    auto null_map = nullable_col->Nulls()->As<ColumnUInt8>();
-
-    for (size_t i = 0; i < values.size(); i++) {
-      nested->Append(values[i]);
-      null_map->Append(static_cast<uint8_t>(nulls[i]));
-    }
-    return fine::Atom("ok");
+    return fine::make_resource<ColumnResource>(nullable_col->Nested());
   } catch (const std::exception& e) {
     throw std::runtime_error(encode_clickhouse_error(e));
   }
 }
-FINE_NIF(column_nullable_int64_append_bulk, 0);
+FINE_NIF(column_nullable_nested, 0);
 
-// Bulk append Nullable(String) values
-fine::Atom column_nullable_string_append_bulk(
+// Bulk append the null map for values just appended to the nested column:
+// one byte per row, nonzero = NULL (the layout select_cols returns with
+// format: :binary). The null map must end up as long as the nested column.
+fine::Atom column_nullable_append_bulk(
     ErlNifEnv *env,
     fine::ResourcePtr<ColumnResource> col_res,
-    std::vector<std::string> values,
-    std::vector<uint64_t> nulls) {
+    ErlNifBinary null_map) {
   try {
     auto nullable_col = std::static_pointer_cast<ColumnNullable>(col_res->ptr);
-    auto nested = nullable_col->Nested()->As<ColumnString>();
-    auto null_map = nullable_col->Nulls()->As<ColumnUInt8>();
-
-    for (size_t i = 0; i < values.size(); i++) {
-      nested->Append(values[i]);
-      null_map->Append(static_cast<uint8_t>(nulls[i]));
+    auto &nulls = nullable_col->Nulls()->As<ColumnUInt8>()->GetWritableData();
+    size_t offset = nulls.size();
+    size_t nested_size = nullable_col->Nested()->Size();
+    if (nested_size != offset + null_map.size) {
+      throw ValidationError("null map has " + std::to_string(null_map.size) +
+                            " rows but " + std::to_string(nested_size - offset) +
+                            " values were appended");
     }
-    return fine::Atom("ok");
-  } catch (const std::exception& e) {
-    throw std::runtime_error(encode_clickhouse_error(e));
-  }
-}
-FINE_NIF(column_nullable_string_append_bulk, 0);
-
-// Bulk append Nullable(Float64) values
-fine::Atom column_nullable_float64_append_bulk(
-    ErlNifEnv *env,
-    fine::ResourcePtr<ColumnResource> col_res,
-    std::vector<double> values,
-    std::vector<uint64_t> nulls) {
-  try {
-    auto nullable_col = std::static_pointer_cast<ColumnNullable>(col_res->ptr);
-    auto nested = nullable_col->Nested()->As<ColumnFloat64>();
-    auto null_map = nullable_col->Nulls()->As<ColumnUInt8>();
 
-    for (size_t i = 0; i < values.size(); i++) {
-      nested->Append(values[i]);
-      null_map->Append(static_cast<uint8_t>(nulls[i]));
+    nulls.resize(offset + null_map.size);
+    for (size_t i = 0; i < null_map.size; i++) {
+      nulls[offset + i] = null_map.data[i] != 0;
     }
     return fine::Atom("ok");
   } catch (const std::exception& e) {
     throw std::runtime_error(encode_clickhouse_error(e));
   }
 }
-FINE_NIF(column_nullable_float64_append_bulk, 0);
+FINE_NIF(column_nullable_append_bulk, NATCH_DIRTY_CPU);
 
 //
 // PHASE 5C - ADDITIONAL TYPE SUPPORT
@@ -367,7 +324,7 @@ fine::Atom column_date_append_bulk(
     throw std::runtime_error(encode_clickhouse_error(e));
   }
 }
-FINE_NIF(column_date_append_bulk, 0);
+FINE_NIF(column_date_append_bulk, NATCH_DIRTY_CPU);
 
 // Bulk append UInt8 values (used for Bool)
 fine::Atom column_uint8_append_bulk(
@@ -384,7 +341,7 @@ fine::Atom column_uint8_append_bulk(
     throw std::runtime_error(encode_clickhouse_error(e));
   }
 }
-FINE_NIF(column_uint8_append_bulk, 0);
+FINE_NIF(column_uint8_append_bulk, NATCH_DIRTY_CPU);
 
 // Bulk append UInt32 values
 fine::Atom column_uint32_append_bulk(
@@ -401,7 +358,7 @@ fine::Atom column_uint32_append_bulk(
     throw std::runtime_error(encode_clickhouse_error(e));
   }
 }
-FINE_NIF(column_uint32_append_bulk, 0);
+FINE_NIF(column_uint32_append_bulk, NATCH_DIRTY_CPU);
 
 // Bulk append UInt16 values
 fine::Atom column_uint16_append_bulk(
@@ -418,7 +375,7 @@ fine::Atom column_uint16_append_bulk(
     throw std::runtime_error(encode_clickhouse_error(e));
   }
 }
-FINE_NIF(column_uint16_append_bulk, 0);
+FINE_NIF(column_uint16_append_bulk, NATCH_DIRTY_CPU);
 
 // Bulk append Int32 values
 fine::Atom column_int32_append_bulk(
@@ -435,7 +392,7 @@ fine::Atom column_int32_append_bulk(
     throw std::runtime_error(encode_clickhouse_error(e));
   }
 }
-FINE_NIF(column_int32_append_bulk, 0);
+FINE_NIF(column_int32_append_bulk, NATCH_DIRTY_CPU);
 
 // Bulk append Int16 values
 fine::Atom column_int16_append_bulk(
@@ -452,7 +409,7 @@ fine::Atom column_int16_append_bulk(
     throw std::runtime_error(encode_clickhouse_error(e));
   }
 }
-FINE_NIF(column_int16_append_bulk, 0);
+FINE_NIF(column_int16_append_bulk, NATCH_DIRTY_CPU);
 
 // Bulk append Int8 values
 fine::Atom column_int8_append_bulk(
@@ -469,7 +426,7 @@ fine::Atom column_int8_append_bulk(
     throw std::runtime_error(encode_clickhouse_error(e));
   }
 }
-FINE_NIF(column_int8_append_bulk, 0);
+FINE_NIF(column_int8_append_bulk, NATCH_DIRTY_CPU);
 
 // Bulk append Float32 values
 fine::Atom column_float32_append_bulk(
@@ -486,7 +443,7 @@ fine::Atom column_float32_append_bulk(
     throw std::runtime_error(encode_clickhouse_error(e));
   }
 }
-FINE_NIF(column_float32_append_bulk, 0);
+FINE_NIF(column_float32_append_bulk, NATCH_DIRTY_CPU);
 
 // Bulk append UUID values (separate lists of high and low 64-bit values)
 fine::Atom column_uuid_append_bulk(
@@ -509,7 +466,213 @@ fine::Atom column_uuid_append_bulk(
     throw std::runtime_error(encode_clickhouse_error(e));
   }
 }
-FINE_NIF(column_uuid_append_bulk, 0);
+FINE_NIF(column_uuid_append_bulk, NATCH_DIRTY_CPU);
+
+// ============================================================================
+// Packed Binary Bulk Append
+// ============================================================================
+//
+// Sibling NIFs to *_append_bulk that take a native-endian binary of packed
+// values instead of a list. The column storage grows once and the binary is
+// copied in with a single memcpy, so no per-value term decoding happens.
+// Layouts match select_cols(..., format: :binary).
+
+// Number of values in a packed binary, rejecting partial trailing values
+template <typename T>
+static size_t packed_count(const ErlNifBinary &bin) {
+  if (bin.size % sizeof(T) != 0) {
+    throw ValidationError("binary size " + std::to_string(bin.size) +
+                          " is not a multiple of the " + std::to_string(sizeof(T)) +
+                          "-byte value width");
+  }
+  return bin.size / sizeof(T);
+}
+
+// memcpy into the column's own vector (binary data may be unaligned, so the
+// values are never read through a T* into the binary)
+template <typename T>
+static void append_packed(std::vector<T> &data, const ErlNifBinary &bin) {
+  size_t count = packed_count<T>(bin);
+  size_t offset = data.size();
+  data.resize(offset + count);
+  std::memcpy(data.data() + offset, bin.data, bin.size);
+}
+
+template <typename T>
+static fine::Atom vector_append_binary(fine::ResourcePtr<ColumnResource> &col_res,
+                                       const ErlNifBinary &bin) {
+  try {
+    auto typed = std::static_pointer_cast<ColumnVector<T>>(col_res->ptr);
+    append_packed(typed->GetWritableData(), bin);
+    return fine::Atom("ok");
+  } catch (const std::exception& e) {
+    throw std::runtime_error(encode_clickhouse_error(e));
+  }
+}
+
+// Bulk append packed UInt64 values
+fine::Atom column_uint64_append_binary(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ColumnResource> col_res,
+    ErlNifBinary values) {
+  return vector_append_binary<uint64_t>(col_res, values);
+}
+FINE_NIF(column_uint64_append_binary, NATCH_DIRTY_CPU);
+
+// Bulk append packed UInt32 values
+fine::Atom column_uint32_append_binary(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ColumnResource> col_res,
+    ErlNifBinary values) {
+  return vector_append_binary<uint32_t>(col_res, values);
+}
+FINE_NIF(column_uint32_append_binary, NATCH_DIRTY_CPU);
+
+// Bulk append packed UInt16 values
+fine::Atom column_uint16_append_binary(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ColumnResource> col_res,
+    ErlNifBinary values) {
+  return vector_append_binary<uint16_t>(col_res, values);
+}
+FINE_NIF(column_uint16_append_binary, NATCH_DIRTY_CPU);
+
+// Bulk append packed UInt8 values (used for Bool)
+fine::Atom column_uint8_append_binary(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ColumnResource> col_res,
+    ErlNifBinary values) {
+  return vector_append_binary<uint8_t>(col_res, values);
+}
+FINE_NIF(column_uint8_append_binary, NATCH_DIRTY_CPU);
+
+// Bulk append packed Int64 values
+fine::Atom column_int64_append_binary(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ColumnResource> col_res,
+    ErlNifBinary values) {
+  return vector_append_binary<int64_t>(col_res, values);
+}
+FINE_NIF(column_int64_append_binary, NATCH_DIRTY_CPU);
+
+// Bulk append packed Int32 values
+fine::Atom column_int32_append_binary(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ColumnResource> col_res,
+    ErlNifBinary values) {
+  return vector_append_binary<int32_t>(col_res, values);
+}
+FINE_NIF(column_int32_append_binary, NATCH_DIRTY_CPU);
+
+// Bulk append packed Int16 values
+fine::Atom column_int16_append_binary(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ColumnResource> col_res,
+    ErlNifBinary values) {
+  return vector_append_binary<int16_t>(col_res, values);
+}
+FINE_NIF(column_int16_append_binary, NATCH_DIRTY_CPU);
+
+// Bulk append packed Int8 values
+fine::Atom column_int8_append_binary(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ColumnResource> col_res,
+    ErlNifBinary values) {
+  return vector_append_binary<int8_t>(col_res, values);
+}
+FINE_NIF(column_int8_append_binary, NATCH_DIRTY_CPU);
+
+// Bulk append packed Float64 values
+fine::Atom column_float64_append_binary(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ColumnResource> col_res,
+    ErlNifBinary values) {
+  return vector_append_binary<double>(col_res, values);
+}
+FINE_NIF(column_float64_append_binary, NATCH_DIRTY_CPU);
+
+// Bulk append packed Float32 values
+fine::Atom column_float32_append_binary(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ColumnResource> col_res,
+    ErlNifBinary values) {
+  return vector_append_binary<float>(col_res, values);
+}
+FINE_NIF(column_float32_append_binary, NATCH_DIRTY_CPU);
+
+// Bulk append packed Date values (UInt16 days since epoch)
+fine::Atom column_date_append_binary(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ColumnResource> col_res,
+    ErlNifBinary values) {
+  try {
+    auto typed = std::static_pointer_cast<ColumnDate>(col_res->ptr);
+    append_packed(typed->GetWritableData(), values);
+    return fine::Atom("ok");
+  } catch (const std::exception& e) {
+    throw std::runtime_error(encode_clickhouse_error(e));
+  }
+}
+FINE_NIF(column_date_append_binary, NATCH_DIRTY_CPU);
+
+// Bulk append packed DateTime values (UInt32 Unix seconds)
+fine::Atom column_datetime_append_binary(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ColumnResource> col_res,
+    ErlNifBinary values) {
+  try {
+    auto typed = std::static_pointer_cast<ColumnDateTime>(col_res->ptr);
+    append_packed(typed->GetWritableData(), values);
+    return fine::Atom("ok");
+  } catch (const std::exception& e) {
+    throw std::runtime_error(encode_clickhouse_error(e));
+  }
+}
+FINE_NIF(column_datetime_append_binary, NATCH_DIRTY_CPU);
+
+// Bulk append packed DateTime64 values (Int64 ticks)
+// ColumnDateTime64 does not expose its storage, so values are appended one
+// at a time, still without decoding any terms
+fine::Atom column_datetime64_append_binary(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ColumnResource> col_res,
+    ErlNifBinary values) {
+  try {
+    auto typed = std::static_pointer_cast<ColumnDateTime64>(col_res->ptr);
+    size_t count = packed_count<int64_t>(values);
+    typed->Reserve(typed->Size() + count);
+    for (size_t i = 0; i < count; i++) {
+      int64_t tick;
+      std::memcpy(&tick, values.data + i * sizeof(int64_t), sizeof(int64_t));
+      typed->Append(tick);
+    }
+    return fine::Atom("ok");
+  } catch (const std::exception& e) {
+    throw std::runtime_error(encode_clickhouse_error(e));
+  }
+}
+FINE_NIF(column_datetime64_append_binary, NATCH_DIRTY_CPU);
+
+// Bulk append packed Decimal values (Int64 scaled values)
+fine::Atom column_decimal_append_binary(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ColumnResource> col_res,
+    ErlNifBinary values) {
+  try {
+    auto typed = std::static_pointer_cast<ColumnDecimal>(col_res->ptr);
+    size_t count = packed_count<int64_t>(values);
+    typed->Reserve(typed->Size() + count);
+    for (size_t i = 0; i < count; i++) {
+      int64_t scaled;
+      std::memcpy(&scaled, values.data + i * sizeof(int64_t), sizeof(int64_t));
+      typed->Append(Int128(scaled));
+    }
+    return fine::Atom("ok");
+  } catch (const std::exception& e) {
+    throw std::runtime_error(encode_clickhouse_error(e));
+  }
+}
+FINE_NIF(column_decimal_append_binary, NATCH_DIRTY_CPU);
 
 // ============================================================================
 // Array Column Support
@@ -565,7 +728,7 @@ fine::Atom column_array_append_from_column(
     throw std::runtime_error(encode_clickhouse_error(e));
   }
 }
-FINE_NIF(column_array_append_from_column, 0);
+FINE_NIF(column_array_append_from_column, NATCH_DIRTY_CPU);
 
 // ============================================================================
 // Tuple Type Support - Columnar API
@@ -624,7 +787,7 @@ fine::Atom column_tuple_append_from_columns(
     throw std::runtime_error(encode_clickhouse_error(e));
   }
 }
-FINE_NIF(column_tuple_append_from_columns, 0);
+FINE_NIF(column_tuple_append_from_columns, NATCH_DIRTY_CPU);
 
 // ============================================================================
 // Map Type Support - Columnar API
@@ -662,7 +825,71 @@ fine::Atom column_map_append_from_array(
     throw std::runtime_error(encode_clickhouse_error(e));
   }
 }
-FINE_NIF(column_map_append_from_array, 0);
+FINE_NIF(column_map_append_from_array, NATCH_DIRTY_CPU);
+
+// ============================================================================
+// Enum Type Support
+// ============================================================================
+
+// Append enum names (binaries or atoms) or item values, mapped to values
+// through a lookup built once from the column type. Returns :ok, or
+// {:unknown, value} for the first value that names no item, in which case
+// nothing is appended.
+template <typename T>
+static fine::Term enum_append_names(ErlNifEnv *env, ColumnRef col, fine::Term values) {
+  auto typed = col->As<ColumnEnum<T>>();
+  if (!typed) {
+    throw ValidationError("column is not an enum column");
+  }
+  EnumValues lookup(col->Type());
+
+  unsigned length;
+  if (!enif_get_list_length(env, values, &length)) {
+    throw ValidationError("enum values must be a list");
+  }
+
+  std::vector<T> mapped;
+  mapped.reserve(length);
+  ERL_NIF_TERM list = values;
+  ERL_NIF_TERM head;
+  while (enif_get_list_cell(env, list, &head, &list)) {
+    int16_t value;
+    if (!lookup.decode(env, head, value)) {
+      return enif_make_tuple2(env, enif_make_atom(env, "unknown"), head);
+    }
+    mapped.push_back(static_cast<T>(value));
+  }
+
+  typed->Reserve(typed->Size() + mapped.size());
+  for (T value : mapped) {
+    typed->Append(value);
+  }
+  return enif_make_atom(env, "ok");
+}
+
+fine::Term column_enum8_append_names(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ColumnResource> col_res,
+    fine::Term values) {
+  try {
+    return enum_append_names<int8_t>(env, col_res->ptr, values);
+  } catch (const std::exception& e) {
+    throw std::runtime_error(encode_clickhouse_error(e));
+  }
+}
+FINE_NIF(column_enum8_append_names, NATCH_DIRTY_CPU);
+
+fine::Term column_enum16_append_names(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ColumnResource> col_res,
+    fine::Term values) {
+  try {
+    return enum_append_names<int16_t>(env, col_res->ptr, values);
+  } catch (const std::exception& e) {
+    throw std::runtime_error(encode_clickhouse_error(e));
+  }
+}
+FINE_NIF(column_enum16_append_names, NATCH_DIRTY_CPU);
 
 // ============================================================================
 // LowCardinality Type Support
@@ -694,4 +921,4 @@ fine::Atom column_lowcardinality_append_from_column(
     throw std::runtime_error(encode_clickhouse_error(e));
   }
 }
-FINE_NIF(column_lowcardinality_append_from_column, 0);
+FINE_NIF(column_lowcardinality_append_from_column, NATCH_DIRTY_CPU);
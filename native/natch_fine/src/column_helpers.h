@@ -0,0 +1,72 @@
+#pragma once
+
+#include <clickhouse/columns/array.h>
+#include <clickhouse/columns/column.h>
+#include <clickhouse/columns/lowcardinality.h>
+#include <clickhouse/columns/map.h>
+#include <clickhouse/columns/uuid.h>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+
+// Column access shared by the term, packed binary and Arrow conversions
+
+// Helper to format UUID to string (much faster than ostringstream)
+inline void format_uuid_to_buffer(const clickhouse::UUID& uuid, char* buffer) {
+  uint64_t high = uuid.first;
+  uint64_t low = uuid.second;
+  snprintf(buffer, 37,  // 36 chars + null terminator
+           "%08llx-%04llx-%04llx-%04llx-%012llx",
+           (unsigned long long)((high >> 32) & 0xFFFFFFFF),
+           (unsigned long long)((high >> 16) & 0xFFFF),
+           (unsigned long long)(high & 0xFFFF),
+           (unsigned long long)((low >> 48) & 0xFFFF),
+           (unsigned long long)(low & 0xFFFFFFFFFFFF));
+}
+
+// ColumnArray keeps its flattened data column and offsets protected. Member
+// pointers taken through a derived class give access to them without the
+// per-row column allocation of GetAsColumn() / AppendAsColumn().
+struct ColumnArrayAccess : clickhouse::ColumnArray {
+  static clickhouse::ColumnRef data(clickhouse::ColumnArray &col) {
+    return (col.*(&ColumnArrayAccess::GetData))();
+  }
+  static size_t offset(const clickhouse::ColumnArray &col, size_t row) {
+    return (col.*(&ColumnArrayAccess::GetOffset))(row);
+  }
+  static size_t size(const clickhouse::ColumnArray &col, size_t row) {
+    return (col.*(&ColumnArrayAccess::GetSize))(row);
+  }
+  // Ends a row of `count` elements already appended to data()
+  static void add_offset(clickhouse::ColumnArray &col, size_t count) {
+    (col.*(&ColumnArrayAccess::AddOffset))(count);
+  }
+};
+
+// Same for the dictionary and per-row dictionary index of a LowCardinality
+// column. For LowCardinality(Nullable(T)) the dictionary is a ColumnNullable
+// whose first entry is NULL.
+struct ColumnLowCardinalityAccess : clickhouse::ColumnLowCardinality {
+  static clickhouse::ColumnRef dictionary(clickhouse::ColumnLowCardinality &col) {
+    return (col.*(&ColumnLowCardinalityAccess::GetDictionary))();
+  }
+  static uint64_t index(const clickhouse::ColumnLowCardinality &col, size_t row) {
+    return (col.*(&ColumnLowCardinalityAccess::getDictionaryIndex))(row);
+  }
+};
+
+// ColumnMap keeps its Array(Tuple(K, V)) data column private, but befriends
+// every ColumnMapT<K, V>. This specialization for a tag type of our own is
+// one of them and hands the data column out, so maps can be converted from
+// the flattened keys and values instead of a GetAsColumn() copy per row.
+struct ColumnMapAccessTag {};
+
+namespace clickhouse {
+template <>
+class ColumnMapT<ColumnMapAccessTag, ColumnMapAccessTag> {
+ public:
+  static std::shared_ptr<ColumnArray> data(const ColumnMap &col) { return col.data_; }
+};
+}  // namespace clickhouse
+
+using ColumnMapAccess = clickhouse::ColumnMapT<ColumnMapAccessTag, ColumnMapAccessTag>;
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <clickhouse/columns/column.h>
+#include <memory>
+
+// Wrapper to hold shared_ptr<Column> since FINE uses ResourcePtr. Declared as
+// a FINE resource in column.cpp (and block.cpp, which takes columns).
+struct ColumnResource {
+  std::shared_ptr<clickhouse::Column> ptr;
+
+  ColumnResource(std::shared_ptr<clickhouse::Column> p) : ptr(p) {}
+};
@@ -0,0 +1,494 @@
+// conversion_plan.cpp - Type-specialized column converters
+//
+// See conversion_plan.h. make_converter is the only place that dispatches on
+// the column type; every converter below runs a tight loop over an already
+// typed column.
+
+#include <clickhouse/columns/column.h>
+#include <clickhouse/columns/numeric.h>
+#include <clickhouse/columns/string.h>
+#include <clickhouse/columns/date.h>
+#include <clickhouse/columns/decimal.h>
+#include <clickhouse/columns/uuid.h>
+#include <clickhouse/columns/array.h>
+#include <clickhouse/columns/tuple.h>
+#include <clickhouse/columns/map.h>
+#include <clickhouse/columns/lowcardinality.h>
+#include <clickhouse/columns/nullable.h>
+#include <clickhouse/columns/enum.h>
+#include <clickhouse/types/types.h>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "column_helpers.h"
+#include "conversion_plan.h"
+#include "enum_terms.h"
+#include "string_terms.h"
+
+using namespace clickhouse;
+
+namespace {
+
+// Specialized for each supported column class below. The plan guarantees a
+// converter only ever sees columns of its own class, so casts are static.
+template <typename ColumnT>
+class Converter;
+
+template <typename T>
+ERL_NIF_TERM number_term(ErlNifEnv *env, T value) {
+  if constexpr (std::is_floating_point_v<T>) {
+    return enif_make_double(env, value);
+  } else if constexpr (std::is_signed_v<T>) {
+    return enif_make_int64(env, value);
+  } else {
+    return enif_make_uint64(env, value);
+  }
+}
+
+// Writes term_at(i) for each of `count` rows, or nil for rows set in `nulls`
+// when given, so NULL rows never build a term
+template <typename TermAt>
+void fill_rows(ErlNifEnv *env, size_t count, const uint8_t *nulls, ERL_NIF_TERM *out,
+               TermAt term_at) {
+  if (!nulls) {
+    for (size_t i = 0; i < count; i++) {
+      out[i] = term_at(i);
+    }
+    return;
+  }
+
+  ERL_NIF_TERM nil = enif_make_atom(env, "nil");
+  for (size_t i = 0; i < count; i++) {
+    out[i] = nulls[i] ? nil : term_at(i);
+  }
+}
+
+// Scalar columns: Derived::fill(env, col, nulls, out) converts a column,
+// with `nulls` null for non-Nullable columns. The same loop serves T and
+// Nullable(T).
+template <typename Derived>
+class LeafConverter : public ColumnConverter {
+ public:
+  void convert(ErlNifEnv *env, Column &col, ERL_NIF_TERM *out) const override {
+    static_cast<const Derived *>(this)->fill(env, col, nullptr, out);
+  }
+
+  void convert_nullable(ErlNifEnv *env, Column &nested, const uint8_t *nulls,
+                        ERL_NIF_TERM *out) const override {
+    static_cast<const Derived *>(this)->fill(env, nested, nulls, out);
+  }
+};
+
+// Integers and floats
+template <typename T>
+class Converter<ColumnVector<T>> final : public LeafConverter<Converter<ColumnVector<T>>> {
+ public:
+  void fill(ErlNifEnv *env, Column &col, const uint8_t *nulls, ERL_NIF_TERM *out) const {
+    auto &typed = static_cast<ColumnVector<T> &>(col);
+    fill_rows(env, typed.Size(), nulls, out,
+              [&](size_t i) { return number_term(env, typed.At(i)); });
+  }
+};
+
+// NULL rows are left out of the string builder entirely
+template <>
+class Converter<ColumnString> final : public LeafConverter<Converter<ColumnString>> {
+ public:
+  void fill(ErlNifEnv *env, Column &col, const uint8_t *nulls, ERL_NIF_TERM *out) const {
+    auto &typed = static_cast<ColumnString &>(col);
+    size_t count = typed.Size();
+    StringTermBuilder strings(count);
+    for (size_t i = 0; i < count; i++) {
+      if (nulls && nulls[i]) {
+        strings.add_nil();
+      } else {
+        strings.add(typed.At(i));
+      }
+    }
+    strings.build(env, out);
+  }
+};
+
+// Days since the epoch
+template <>
+class Converter<ColumnDate> final : public LeafConverter<Converter<ColumnDate>> {
+ public:
+  void fill(ErlNifEnv *env, Column &col, const uint8_t *nulls, ERL_NIF_TERM *out) const {
+    auto &typed = static_cast<ColumnDate &>(col);
+    fill_rows(env, typed.Size(), nulls, out,
+              [&](size_t i) { return enif_make_uint64(env, typed.RawAt(i)); });
+  }
+};
+
+// Seconds since the epoch
+template <>
+class Converter<ColumnDateTime> final : public LeafConverter<Converter<ColumnDateTime>> {
+ public:
+  void fill(ErlNifEnv *env, Column &col, const uint8_t *nulls, ERL_NIF_TERM *out) const {
+    auto &typed = static_cast<ColumnDateTime &>(col);
+    fill_rows(env, typed.Size(), nulls, out,
+              [&](size_t i) { return enif_make_uint64(env, typed.At(i)); });
+  }
+};
+
+// Ticks of the column's precision since the epoch
+template <>
+class Converter<ColumnDateTime64> final : public LeafConverter<Converter<ColumnDateTime64>> {
+ public:
+  void fill(ErlNifEnv *env, Column &col, const uint8_t *nulls, ERL_NIF_TERM *out) const {
+    auto &typed = static_cast<ColumnDateTime64 &>(col);
+    fill_rows(env, typed.Size(), nulls, out,
+              [&](size_t i) { return enif_make_int64(env, typed.At(i)); });
+  }
+};
+
+// Scaled integer value
+template <>
+class Converter<ColumnDecimal> final : public LeafConverter<Converter<ColumnDecimal>> {
+ public:
+  void fill(ErlNifEnv *env, Column &col, const uint8_t *nulls, ERL_NIF_TERM *out) const {
+    auto &typed = static_cast<ColumnDecimal &>(col);
+    fill_rows(env, typed.Size(), nulls, out,
+              [&](size_t i) { return enif_make_int64(env, static_cast<int64_t>(typed.At(i))); });
+  }
+};
+
+template <>
+class Converter<ColumnUUID> final : public LeafConverter<Converter<ColumnUUID>> {
+ public:
+  void fill(ErlNifEnv *env, Column &col, const uint8_t *nulls, ERL_NIF_TERM *out) const {
+    auto &typed = static_cast<ColumnUUID &>(col);
+    char uuid_buf[37];
+    fill_rows(env, typed.Size(), nulls, out, [&](size_t i) {
+      format_uuid_to_buffer(typed.At(i), uuid_buf);
+      return StringTermBuilder::make_heap_binary(env, std::string_view(uuid_buf, 36));
+    });
+  }
+};
+
+// Emits each row's item term. The item names are read from the type when
+// the plan is built. Atoms are not tied to an env, so they are made once, on
+// first use, and shared by every call; binaries belong to the caller's env
+// and are made once per call.
+template <typename T>
+class Converter<ColumnEnum<T>> final : public LeafConverter<Converter<ColumnEnum<T>>> {
+ public:
+  Converter(const TypeRef &type, EnumFormat enums) : names_(type), enums_(enums) {}
+
+  void fill(ErlNifEnv *env, Column &col, const uint8_t *nulls, ERL_NIF_TERM *out) const {
+    auto &typed = static_cast<ColumnEnum<T> &>(col);
+    if (enums_ == EnumFormat::Atoms) {
+      std::call_once(atoms_once_, [&] { atoms_.emplace(env, names_, true); });
+      fill_terms(env, typed, nulls, out, *atoms_);
+    } else {
+      fill_terms(env, typed, nulls, out, EnumTerms(env, names_, false));
+    }
+  }
+
+ private:
+  static void fill_terms(ErlNifEnv *env, ColumnEnum<T> &typed, const uint8_t *nulls,
+                         ERL_NIF_TERM *out, const EnumTerms &terms) {
+    fill_rows(env, typed.Size(), nulls, out, [&](size_t i) { return terms.at(typed.At(i)); });
+  }
+
+  EnumNames names_;
+  EnumFormat enums_;
+  mutable std::once_flag atoms_once_;
+  mutable std::optional<EnumTerms> atoms_;
+};
+
+// One list per row. The flattened nested column is converted exactly once
+// and each row's list is built from its slice of those terms by offsets.
+template <>
+class Converter<ColumnArray> final : public ColumnConverter {
+ public:
+  explicit Converter(ConverterPtr item) : item_(std::move(item)) {}
+
+  void convert(ErlNifEnv *env, Column &col, ERL_NIF_TERM *out) const override {
+    auto &typed = static_cast<ColumnArray &>(col);
+    ColumnRef data = ColumnArrayAccess::data(typed);
+    std::vector<ERL_NIF_TERM> flat(data->Size());
+    item_->convert(env, *data, flat.data());
+
+    size_t count = typed.Size();
+    for (size_t i = 0; i < count; i++) {
+      size_t offset = ColumnArrayAccess::offset(typed, i);
+      size_t size = ColumnArrayAccess::size(typed, i);
+      out[i] = enif_make_list_from_array(env, flat.data() + offset, size);
+    }
+  }
+
+ private:
+  ConverterPtr item_;
+};
+
+// Each element column is converted once into its own run of a column-major
+// buffer; tuple i gathers row i of every run
+template <>
+class Converter<ColumnTuple> final : public ColumnConverter {
+ public:
+  explicit Converter(std::vector<ConverterPtr> elements) : elements_(std::move(elements)) {}
+
+  void convert(ErlNifEnv *env, Column &col, ERL_NIF_TERM *out) const override {
+    auto &typed = static_cast<ColumnTuple &>(col);
+    size_t count = typed.Size();
+    size_t tuple_size = elements_.size();
+    std::vector<ERL_NIF_TERM> elements(tuple_size * count);
+    for (size_t j = 0; j < tuple_size; j++) {
+      elements_[j]->convert(env, *typed.At(j), elements.data() + j * count);
+    }
+
+    std::vector<ERL_NIF_TERM> tuple_elements(tuple_size);
+    for (size_t i = 0; i < count; i++) {
+      for (size_t j = 0; j < tuple_size; j++) {
+        tuple_elements[j] = elements[j * count + i];
+      }
+      out[i] = enif_make_tuple_from_array(env, tuple_elements.data(), tuple_size);
+    }
+  }
+
+ private:
+  std::vector<ConverterPtr> elements_;
+};
+
+// Map is stored as Array(Tuple(K, V)). As for arrays, the flattened keys
+// and values columns are each converted once and every row's map is built
+// from its slice of those terms by offsets.
+template <>
+class Converter<ColumnMap> final : public ColumnConverter {
+ public:
+  Converter(ConverterPtr keys, ConverterPtr values)
+      : keys_(std::move(keys)), values_(std::move(values)) {}
+
+  void convert(ErlNifEnv *env, Column &col, ERL_NIF_TERM *out) const override {
+    auto &typed = static_cast<ColumnMap &>(col);
+    auto data = ColumnMapAccess::data(typed);
+    auto &pairs = static_cast<ColumnTuple &>(*ColumnArrayAccess::data(*data));
+    size_t pair_count = pairs.Size();
+    std::vector<ERL_NIF_TERM> key_terms(pair_count);
+    std::vector<ERL_NIF_TERM> value_terms(pair_count);
+    keys_->convert(env, *pairs.At(0), key_terms.data());
+    values_->convert(env, *pairs.At(1), value_terms.data());
+
+    size_t count = typed.Size();
+    for (size_t i = 0; i < count; i++) {
+      size_t offset = ColumnArrayAccess::offset(*data, i);
+      size_t size = ColumnArrayAccess::size(*data, i);
+      enif_make_map_from_arrays(env, key_terms.data() + offset, value_terms.data() + offset, size,
+                                &out[i]);
+    }
+  }
+
+ private:
+  ConverterPtr keys_;
+  ConverterPtr values_;
+};
+
+// Each dictionary entry is converted once (NULL is the first entry of a
+// Nullable dictionary) and its term reused for every row by index
+template <>
+class Converter<ColumnLowCardinality> final : public ColumnConverter {
+ public:
+  explicit Converter(ConverterPtr dictionary) : dictionary_(std::move(dictionary)) {}
+
+  void convert(ErlNifEnv *env, Column &col, ERL_NIF_TERM *out) const override {
+    auto &typed = static_cast<ColumnLowCardinality &>(col);
+    ColumnRef dictionary_col = ColumnLowCardinalityAccess::dictionary(typed);
+    std::vector<ERL_NIF_TERM> dictionary(dictionary_col->Size());
+    dictionary_->convert(env, *dictionary_col, dictionary.data());
+
+    size_t count = typed.Size();
+    for (size_t i = 0; i < count; i++) {
+      out[i] = dictionary[ColumnLowCardinalityAccess::index(typed, i)];
+    }
+  }
+
+ private:
+  ConverterPtr dictionary_;
+};
+
+// Nullable(T): the nested converter writes nil for NULL rows, converting
+// only the others when it can (see ColumnConverter::convert_nullable)
+template <>
+class Converter<ColumnNullable> final : public ColumnConverter {
+ public:
+  explicit Converter(ConverterPtr nested) : nested_(std::move(nested)) {}
+
+  void convert(ErlNifEnv *env, Column &col, ERL_NIF_TERM *out) const override {
+    auto &typed = static_cast<ColumnNullable &>(col);
+    auto &nulls = static_cast<ColumnUInt8 &>(*typed.Nulls());
+    nested_->convert_nullable(env, *typed.Nested(), nulls.GetWritableData().data(), out);
+  }
+
+ private:
+  ConverterPtr nested_;
+};
+
+// Types without a converter fail only when asked to convert rows
+class UnsupportedConverter final : public ColumnConverter {
+ public:
+  explicit UnsupportedConverter(std::string type_name) : type_name_(std::move(type_name)) {}
+
+  void convert(ErlNifEnv *env, Column &col, ERL_NIF_TERM *out) const override {
+    if (col.Size() > 0) {
+      throw std::runtime_error("Unsupported column type in column_to_elixir_list: " + type_name_);
+    }
+  }
+
+ private:
+  std::string type_name_;
+};
+
+template <typename ColumnT, typename... Args>
+ConverterPtr converter(Args &&...args) {
+  return std::make_shared<const Converter<ColumnT>>(std::forward<Args>(args)...);
+}
+
+}  // namespace
+
+void ColumnConverter::convert_nullable(ErlNifEnv *env, Column &nested, const uint8_t *nulls,
+                                       ERL_NIF_TERM *out) const {
+  convert(env, nested, out);
+  ERL_NIF_TERM nil = enif_make_atom(env, "nil");
+  size_t count = nested.Size();
+  for (size_t i = 0; i < count; i++) {
+    if (nulls[i]) {
+      out[i] = nil;
+    }
+  }
+}
+
+ConverterPtr make_converter(const TypeRef &type, EnumFormat enums) {
+  switch (type->GetCode()) {
+  case Type::UInt64:
+    return converter<ColumnUInt64>();
+  case Type::UInt32:
+    return converter<ColumnUInt32>();
+  case Type::UInt16:
+    return converter<ColumnUInt16>();
+  case Type::UInt8:
+    return converter<ColumnUInt8>();
+  case Type::Int64:
+    return converter<ColumnInt64>();
+  case Type::Int32:
+    return converter<ColumnInt32>();
+  case Type::Int16:
+    return converter<ColumnInt16>();
+  case Type::Int8:
+    return converter<ColumnInt8>();
+  case Type::Float64:
+    return converter<ColumnFloat64>();
+  case Type::Float32:
+    return converter<ColumnFloat32>();
+  case Type::String:
+    return converter<ColumnString>();
+  case Type::Date:
+    return converter<ColumnDate>();
+  case Type::DateTime:
+    return converter<ColumnDateTime>();
+  case Type::DateTime64:
+    return converter<ColumnDateTime64>();
+  case Type::Decimal:
+  case Type::Decimal32:
+  case Type::Decimal64:
+  case Type::Decimal128:
+    return converter<ColumnDecimal>();
+  case Type::UUID:
+    return converter<ColumnUUID>();
+  case Type::Enum8:
+    return converter<ColumnEnum8>(type, enums);
+  case Type::Enum16:
+    return converter<ColumnEnum16>(type, enums);
+  case Type::Array:
+    return converter<ColumnArray>(make_converter(type->As<ArrayType>()->GetItemType(), enums));
+  case Type::Tuple: {
+    std::vector<ConverterPtr> elements;
+    for (const auto &element : type->As<TupleType>()->GetTupleType()) {
+      elements.push_back(make_converter(element, enums));
+    }
+    return converter<ColumnTuple>(std::move(elements));
+  }
+  case Type::Map: {
+    auto map_type = type->As<MapType>();
+    return converter<ColumnMap>(make_converter(map_type->GetKeyType(), enums),
+                                make_converter(map_type->GetValueType(), enums));
+  }
+  case Type::LowCardinality:
+    return converter<ColumnLowCardinality>(
+        make_converter(type->As<LowCardinalityType>()->GetNestedType(), enums));
+  case Type::Nullable:
+    return converter<ColumnNullable>(
+        make_converter(type->As<NullableType>()->GetNestedType(), enums));
+  default:
+    return std::make_shared<const UnsupportedConverter>(type->GetName());
+  }
+}
+
+ConversionPlan::ConversionPlan(const Block &header, EnumFormat enums) {
+  columns_.reserve(header.GetColumnCount());
+  for (size_t c = 0; c < header.GetColumnCount(); c++) {
+    columns_.push_back(make_converter(header[c]->Type(), enums));
+  }
+}
+
+void ConversionPlan::convert(ErlNifEnv *env, size_t c, const ColumnRef &col,
+                             std::vector<ERL_NIF_TERM> &out) const {
+  size_t start = out.size();
+  out.resize(start + col->Size());
+  convert(env, c, col, out.data() + start);
+}
+
+std::shared_ptr<const HeaderPlan> PlanCache::get(ErlNifEnv *env, const Block &header,
+                                                 EnumFormat enums) {
+  // The enum format, then names and types, each NUL-terminated (neither can
+  // contain NUL)
+  std::string key(1, enums == EnumFormat::Atoms ? 'a' : 'b');
+  for (size_t c = 0; c < header.GetColumnCount(); c++) {
+    key += header.GetColumnName(c);
+    key += '\0';
+    key += header[c]->Type()->GetName();
+    key += '\0';
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = plans_.find(key);
+    if (it != plans_.end()) {
+      return it->second;
+    }
+  }
+
+  auto plan = std::make_shared<HeaderPlan>();
+  plan->plan = ConversionPlan(header, enums);
+  plan->names.reserve(header.GetColumnCount());
+  for (size_t c = 0; c < header.GetColumnCount(); c++) {
+    plan->names.push_back(enif_make_atom(env, header.GetColumnName(c).c_str()));
+  }
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (plans_.size() >= CAPACITY) {
+    plans_.clear();
+  }
+  plans_.emplace(std::move(key), plan);
+  return plan;
+}
+
+void column_to_span(ErlNifEnv *env, ColumnRef col, ERL_NIF_TERM *out) {
+  make_converter(col->Type())->convert(env, *col, out);
+}
+
+void column_to_terms(ErlNifEnv *env, ColumnRef col, std::vector<ERL_NIF_TERM> &values) {
+  size_t start = values.size();
+  values.resize(start + col->Size());
+  column_to_span(env, col, values.data() + start);
+}
+
+ERL_NIF_TERM column_to_elixir_list(ErlNifEnv *env, ColumnRef col) {
+  std::vector<ERL_NIF_TERM> values;
+  column_to_terms(env, col, values);
+  return enif_make_list_from_array(env, values.data(), values.size());
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <erl_nif.h>
+#include <clickhouse/block.h>
+#include <clickhouse/columns/column.h>
+#include <clickhouse/types/types.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "enum_terms.h"
+
+// Column-to-term conversion shared by every SELECT path.
+//
+// A converter is built once per column type: the type is dispatched a single
+// time (recursively for nested types) into a tree of Converter<ColumnT>
+// specializations, each of which casts its column statically and converts a
+// whole column per call. A ConversionPlan holds one converter per column of a
+// result header and is executed for every block of that result.
+//
+// Converters hold no env-bound state, so one plan can be used from several
+// threads and envs at once (see parallel_convert.cpp).
+
+class ColumnConverter {
+ public:
+  virtual ~ColumnConverter() = default;
+
+  // Writes one term per row of `col` to out[0..col.Size()). `col` must have
+  // the type the converter was built for.
+  virtual void convert(ErlNifEnv *env, clickhouse::Column &col, ERL_NIF_TERM *out) const = 0;
+
+  // Same for the nested column of a Nullable, writing nil for rows set in
+  // `nulls` (the null map, one byte per row). Scalar converters skip those
+  // rows; the default converts every row and overlays nil.
+  virtual void convert_nullable(ErlNifEnv *env, clickhouse::Column &nested, const uint8_t *nulls,
+                                ERL_NIF_TERM *out) const;
+};
+
+using ConverterPtr = std::shared_ptr<const ColumnConverter>;
+
+// Converter for columns of `type`, returning enum names (at any depth) in
+// `enums` format. Unsupported types get a converter that only fails once it
+// is given rows, so empty results of any type still work.
+ConverterPtr make_converter(const clickhouse::TypeRef &type,
+                            EnumFormat enums = EnumFormat::Binaries);
+
+// One converter per column of a result, built from its header (or first)
+// block and reused for every block of the result
+class ConversionPlan {
+ public:
+  ConversionPlan() = default;
+  explicit ConversionPlan(const clickhouse::Block &header,
+                          EnumFormat enums = EnumFormat::Binaries);
+
+  bool empty() const { return columns_.empty(); }
+  size_t size() const { return columns_.size(); }
+
+  // Writes the terms of column `c` of a block (or a slice of it) to `out`
+  void convert(ErlNifEnv *env, size_t c, const clickhouse::ColumnRef &col,
+               ERL_NIF_TERM *out) const {
+    columns_[c]->convert(env, *col, out);
+  }
+
+  // Same, appended to `out`
+  void convert(ErlNifEnv *env, size_t c, const clickhouse::ColumnRef &col,
+               std::vector<ERL_NIF_TERM> &out) const;
+
+ private:
+  std::vector<ConverterPtr> columns_;
+};
+
+// What a result header resolves to: the conversion plan and the column name
+// atoms (atoms are not tied to an env, so they can be cached)
+struct HeaderPlan {
+  ConversionPlan plan;
+  std::vector<ERL_NIF_TERM> names;
+};
+
+// Header plans of recent queries, keyed by the header's column names and
+// types and the enum format. Dashboards run the same few query shapes over and over; with the
+// cache they skip type dispatch and atom creation after the first run.
+// Kept per connection (and per pool); when full it is simply emptied.
+class PlanCache {
+ public:
+  static constexpr size_t CAPACITY = 64;
+
+  // The plan for `header`, built (with atoms made in `env`) on first use
+  std::shared_ptr<const HeaderPlan> get(ErlNifEnv *env, const clickhouse::Block &header,
+                                        EnumFormat enums = EnumFormat::Binaries);
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::shared_ptr<const HeaderPlan>> plans_;
+};
+
+// Ad-hoc conversion of a single column, building its converter per call
+
+// Convert every row of a column to a term, written to out[0..col->Size())
+void column_to_span(ErlNifEnv *env, clickhouse::ColumnRef col, ERL_NIF_TERM *out);
+// Convert every row of a column to a term, appended to `values`
+void column_to_terms(ErlNifEnv *env, clickhouse::ColumnRef col, std::vector<ERL_NIF_TERM> &values);
+// Convert a column to an Elixir list
+ERL_NIF_TERM column_to_elixir_list(ErlNifEnv *env, clickhouse::ColumnRef col);
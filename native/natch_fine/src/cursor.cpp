@@ -0,0 +1,268 @@
+// cursor.cpp - Streaming SELECT support
+//
+// clickhouse-cpp only exposes SELECT results through a per-block callback
+// that runs inside Client::Select until the whole result has been received.
+// A cursor runs that Select on its own worker thread and hands blocks over
+// through a small bounded queue, so Elixir can pull one block at a time and
+// memory stays proportional to a block rather than the full result.
+//
+// The worker holds the client's mutex for the lifetime of the query and marks
+// the client as streaming. Other requests on the same connection fail fast
+// with a "busy" error until the cursor is drained or closed.
+
+#include <fine.hpp>
+#include <clickhouse/client.h>
+#include <clickhouse/query.h>
+#include <clickhouse/block.h>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+#include "client_resource.h"
+#include "error_encoding.h"
+#include "nif_flags.h"
+#include "parallel_convert.h"
+
+using namespace clickhouse;
+
+// Defined in select.cpp
+void block_to_maps_impl(ErlNifEnv *env, const HeaderPlan &header, std::shared_ptr<Block> block,
+                        std::vector<ERL_NIF_TERM>& out_maps);
+
+// Number of received blocks buffered ahead of the consumer
+constexpr size_t CURSOR_QUEUE_CAPACITY = 2;
+
+// State shared by a cursor and its worker thread. The worker is detached and
+// owns a reference to this state, so a cursor can be garbage collected while
+// its query is still running: the cursor only cancels, and the worker
+// releases the connection and the state when Select returns.
+struct CursorStream {
+  fine::ResourcePtr<ClientResource> client;
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<std::shared_ptr<Block>> queue;
+  bool started = false;
+  bool finished = false;
+  bool cancelled = false;
+  std::string error;
+
+  explicit CursorStream(fine::ResourcePtr<ClientResource> c) : client(c) {}
+
+  // Runs the query on the worker thread, blocking in the callback while the
+  // queue is full. Returning false from the callback cancels the query and
+  // lets clickhouse-cpp drain the connection so it stays usable.
+  void run(Query query) {
+    std::unique_lock<std::mutex> client_lock(client->mutex, std::defer_lock);
+    if (!client->streaming) {
+      client_lock.lock();
+      // An insert session may have claimed the connection while we waited
+      if (client->streaming.exchange(true)) {
+        client_lock.unlock();
+      }
+    }
+    {
+      std::lock_guard<std::mutex> guard(mutex);
+      started = true;
+      if (!client_lock.owns_lock()) {
+        try {
+          throw_client_busy();
+        } catch (const std::exception& e) {
+          error = encode_clickhouse_error(e);
+        }
+        finished = true;
+      }
+    }
+    cv.notify_all();
+    if (!client_lock.owns_lock()) {
+      return;
+    }
+    client->reset_if_needed();
+
+    try {
+      query.OnDataCancelable([this](const Block &block) {
+        if (block.GetRowCount() == 0) {
+          std::lock_guard<std::mutex> guard(mutex);
+          return !cancelled;
+        }
+
+        std::unique_lock<std::mutex> guard(mutex);
+        cv.wait(guard, [this] { return cancelled || queue.size() < CURSOR_QUEUE_CAPACITY; });
+        if (cancelled) {
+          return false;
+        }
+        queue.push_back(std::make_shared<Block>(block));
+        cv.notify_all();
+        return true;
+      });
+      client->ptr->Select(query);
+    } catch (const std::exception& e) {
+      std::lock_guard<std::mutex> guard(mutex);
+      error = encode_clickhouse_error(e);
+    }
+
+    // Release the connection before reporting completion so the consumer
+    // can issue its next request as soon as it sees the end of the stream
+    client->streaming = false;
+    client_lock.unlock();
+    {
+      std::lock_guard<std::mutex> guard(mutex);
+      finished = true;
+    }
+    cv.notify_all();
+  }
+
+  // Waits for the next block. Returns nullptr once the result is exhausted.
+  std::shared_ptr<Block> next() {
+    std::unique_lock<std::mutex> guard(mutex);
+    cv.wait(guard, [this] { return !queue.empty() || finished; });
+
+    if (!queue.empty()) {
+      auto block = queue.front();
+      queue.pop_front();
+      guard.unlock();
+      cv.notify_all();
+      return block;
+    }
+
+    if (!error.empty()) {
+      std::string message = error;
+      error.clear();
+      throw std::runtime_error(message);
+    }
+
+    return nullptr;
+  }
+
+  // Asks the worker to stop at its next block without waiting for it
+  void cancel() {
+    {
+      std::lock_guard<std::mutex> guard(mutex);
+      cancelled = true;
+      queue.clear();
+    }
+    cv.notify_all();
+  }
+
+  // Cancels and waits until the worker has released the connection
+  void close() {
+    cancel();
+    std::unique_lock<std::mutex> guard(mutex);
+    cv.wait(guard, [this] { return finished; });
+  }
+};
+
+struct CursorResource {
+  std::shared_ptr<CursorStream> stream;
+  bool columnar;
+  // Plan and name atoms for the first block handed out, reused for the rest
+  std::shared_ptr<const HeaderPlan> header;
+
+  CursorResource(fine::ResourcePtr<ClientResource> c, bool cols)
+      : stream(std::make_shared<CursorStream>(c)), columnar(cols) {}
+
+  // Runs on the garbage collecting thread, so it must not wait for the
+  // query: the detached worker finishes it on its own
+  ~CursorResource() {
+    stream->cancel();
+  }
+
+  void start(Query query) {
+    std::thread([stream = stream, query = std::move(query)]() mutable {
+      stream->run(std::move(query));
+    }).detach();
+
+    std::unique_lock<std::mutex> guard(stream->mutex);
+    stream->cv.wait(guard, [this] { return stream->started; });
+  }
+};
+
+FINE_RESOURCE(CursorResource);
+
+// Convert one block to the cursor's output format
+static ERL_NIF_TERM block_to_term(ErlNifEnv *env, CursorResource &cursor,
+                                  std::shared_ptr<Block> block) {
+  if (!cursor.header) {
+    cursor.header = cursor.stream->client->plans.get(env, *block);
+  }
+
+  if (!cursor.columnar) {
+    std::vector<ERL_NIF_TERM> maps;
+    maps.reserve(block->GetRowCount());
+    block_to_maps_impl(env, *cursor.header, block, maps);
+    return enif_make_list_from_array(env, maps.data(), maps.size());
+  }
+
+  size_t col_count = block->GetColumnCount();
+  std::vector<std::vector<ERL_NIF_TERM>> columns(col_count);
+  convert_block_columns(env, cursor.header->plan, *block, columns);
+
+  std::vector<ERL_NIF_TERM> keys = cursor.header->names;
+  std::vector<ERL_NIF_TERM> values;
+  values.reserve(col_count);
+
+  for (size_t c = 0; c < col_count; c++) {
+    values.push_back(enif_make_list_from_array(env, columns[c].data(), columns[c].size()));
+  }
+
+  ERL_NIF_TERM columns_map;
+  enif_make_map_from_arrays(env, keys.data(), values.data(), col_count, &columns_map);
+  return columns_map;
+}
+
+// ============================================================================
+// Cursor NIFs
+// ============================================================================
+
+/// Starts a streaming SELECT and returns a cursor
+///
+/// @param format :rows (each block as a list of maps) or :columns
+///               (each block as %{column => [values]})
+fine::ResourcePtr<CursorResource> client_select_open(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ClientResource> client,
+    std::string sql,
+    fine::Atom format) {
+  auto cursor = fine::make_resource<CursorResource>(client, format.to_string() == "columns");
+  cursor->start(Query(sql));
+  return cursor;
+}
+FINE_NIF(client_select_open, NATCH_DIRTY_IO);
+
+/// Starts a streaming parameterized SELECT and returns a cursor
+fine::ResourcePtr<CursorResource> client_select_open_parameterized(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ClientResource> client,
+    fine::ResourcePtr<Query> query,
+    fine::Atom format) {
+  auto cursor = fine::make_resource<CursorResource>(client, format.to_string() == "columns");
+  // Copied so the cursor's callbacks do not leak into the shared Query resource
+  cursor->start(*query);
+  return cursor;
+}
+FINE_NIF(client_select_open_parameterized, NATCH_DIRTY_IO);
+
+/// Returns the next non-empty block, or :done once the result is exhausted
+fine::Term cursor_next_block(
+    ErlNifEnv *env,
+    fine::ResourcePtr<CursorResource> cursor) {
+  auto block = cursor->stream->next();
+  if (!block) {
+    return enif_make_atom(env, "done");
+  }
+  return block_to_term(env, *cursor, block);
+}
+FINE_NIF(cursor_next_block, NATCH_DIRTY_IO);
+
+/// Cancels the query (if still running) and releases the connection
+fine::Atom cursor_close(
+    ErlNifEnv *env,
+    fine::ResourcePtr<CursorResource> cursor) {
+  cursor->stream->close();
+  return fine::Atom("ok");
+}
+FINE_NIF(cursor_close, NATCH_DIRTY_IO);
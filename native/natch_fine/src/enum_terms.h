@@ -0,0 +1,134 @@
+#pragma once
+
+#include <erl_nif.h>
+#include <clickhouse/exceptions.h>
+#include <clickhouse/types/types.h>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "string_terms.h"
+
+// Enum8/Enum16 names are fixed by the column type, so both directions are
+// precomputed once per column from its EnumType instead of per row.
+
+// How a select returns enum names: as binaries (the default) or as atoms,
+// chosen per call with the :enum option
+enum class EnumFormat { Binaries, Atoms };
+
+inline EnumFormat enum_format_from_name(const std::string &name) {
+  return name == "atom" ? EnumFormat::Atoms : EnumFormat::Binaries;
+}
+
+// Atoms are limited to 255 characters
+constexpr size_t MAX_ATOM_LENGTH = 255;
+
+// Item names and values of an enum type, read once from the type
+class EnumNames {
+ public:
+  explicit EnumNames(const clickhouse::TypeRef &type) {
+    clickhouse::EnumType enum_type(type);
+    for (auto it = enum_type.BeginValueToName(); it != enum_type.EndValueToName(); ++it) {
+      items_.emplace_back(it->first, it->second);
+    }
+  }
+
+  // Ordered by value
+  const std::vector<std::pair<int, std::string>> &items() const { return items_; }
+
+ private:
+  std::vector<std::pair<int, std::string>> items_;
+};
+
+// One term per enum item, looked up by value
+class EnumTerms {
+ public:
+  EnumTerms(ErlNifEnv *env, const EnumNames &names, bool as_atoms) {
+    const auto &items = names.items();
+    if (items.empty()) {
+      return;
+    }
+
+    // Items are ordered by value, so the table spans first..last
+    min_ = items.front().first;
+    int last = items.back().first;
+    terms_.assign(static_cast<size_t>(last - min_ + 1), 0);
+    for (const auto &[value, name] : items) {
+      ERL_NIF_TERM term;
+      if (as_atoms) {
+        if (name.size() > MAX_ATOM_LENGTH) {
+          throw clickhouse::ValidationError("enum name is too long for an atom: " + name);
+        }
+        term = enif_make_atom_len(env, name.data(), name.size());
+      } else {
+        term = StringTermBuilder::make_heap_binary(env, name);
+      }
+      terms_[static_cast<size_t>(value - min_)] = term;
+    }
+  }
+
+  ERL_NIF_TERM at(int value) const {
+    size_t slot = static_cast<size_t>(value - min_);
+    if (value < min_ || slot >= terms_.size() || terms_[slot] == 0) {
+      throw std::runtime_error("enum value " + std::to_string(value) + " has no name");
+    }
+    return terms_[slot];
+  }
+
+ private:
+  int min_ = 0;
+  std::vector<ERL_NIF_TERM> terms_;
+};
+
+// Name -> value for appending enum names given as binaries or atoms.
+// Integers are accepted as the value itself when it names an item.
+class EnumValues {
+ public:
+  explicit EnumValues(const clickhouse::TypeRef &type) : type_(type) {
+    // Keys view the names owned by the type, which type_ keeps alive
+    clickhouse::EnumType enum_type(type_);
+    for (auto it = enum_type.BeginValueToName(); it != enum_type.EndValueToName(); ++it) {
+      values_.emplace(it->second, it->first);
+      known_.insert(it->first);
+    }
+  }
+
+  // Returns false if `term` is not a name or value of this enum
+  bool decode(ErlNifEnv *env, ERL_NIF_TERM term, int16_t &value) const {
+    ErlNifBinary bin;
+    if (enif_inspect_binary(env, term, &bin)) {
+      return lookup(std::string_view(reinterpret_cast<const char *>(bin.data), bin.size), value);
+    }
+
+    char atom[MAX_ATOM_LENGTH + 1];
+    int length = enif_get_atom(env, term, atom, sizeof(atom), ERL_NIF_LATIN1);
+    if (length > 0) {
+      return lookup(std::string_view(atom, static_cast<size_t>(length - 1)), value);
+    }
+
+    int64_t integer;
+    if (enif_get_int64(env, term, &integer) && known_.count(integer)) {
+      value = static_cast<int16_t>(integer);
+      return true;
+    }
+    return false;
+  }
+
+ private:
+  bool lookup(std::string_view name, int16_t &value) const {
+    auto it = values_.find(name);
+    if (it == values_.end()) {
+      return false;
+    }
+    value = it->second;
+    return true;
+  }
+
+  clickhouse::TypeRef type_;
+  std::unordered_map<std::string_view, int16_t> values_;
+  std::unordered_set<int64_t> known_;
+};
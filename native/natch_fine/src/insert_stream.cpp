@@ -0,0 +1,230 @@
+// insert_stream.cpp - Streaming INSERT sessions
+//
+// client_insert sends one Block per INSERT statement. An insert session
+// instead opens a single INSERT with Client::BeginInsert, sends any number
+// of blocks with SendInsertBlock and completes it with EndInsert, so large
+// loads keep one block in memory at a time and the server sees one INSERT.
+//
+// NIF calls on a session may run on different scheduler threads, so the
+// session cannot hold the client's mutex between calls. It claims the
+// connection by setting the client's streaming flag instead (like an open
+// cursor): other requests on the connection fail fast with a "busy" error
+// until the session is finished or closed. Each session call takes the
+// mutex only while it talks to the server.
+//
+// A session that is closed before finish is aborted by resetting the
+// connection: clickhouse-cpp cannot cancel an INSERT in flight, and
+// EndInsert would commit the partial data. A session garbage collected while
+// open only releases the connection and marks it for reset; the reconnect
+// happens on the next request rather than in the destructor.
+
+#include <fine.hpp>
+#include <clickhouse/client.h>
+#include <clickhouse/block.h>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "block_resource.h"
+#include "client_resource.h"
+#include "error_encoding.h"
+#include "nif_flags.h"
+
+using namespace clickhouse;
+
+struct InsertSessionResource {
+  fine::ResourcePtr<ClientResource> client;
+  std::vector<std::string> columns;
+
+  // Serializes calls on this session
+  std::mutex mutex;
+  bool open = false;
+  uint64_t rows_sent = 0;
+
+  InsertSessionResource(fine::ResourcePtr<ClientResource> c, std::vector<std::string> cols)
+      : client(c), columns(std::move(cols)) {}
+
+  ~InsertSessionResource() {
+    std::lock_guard<std::mutex> guard(mutex);
+    if (open) {
+      // Marked before streaming is cleared, so no request can use the
+      // connection in between
+      client->needs_reset = true;
+      open = false;
+      client->streaming = false;
+    }
+  }
+
+  void begin(const std::string &table) {
+    std::string query = "INSERT INTO " + table + " (";
+    for (size_t i = 0; i < columns.size(); i++) {
+      if (i > 0) {
+        query += ", ";
+      }
+      query += "`" + columns[i] + "`";
+    }
+    query += ") VALUES";
+
+    std::lock_guard<std::mutex> client_guard(client->mutex);
+    if (client->streaming.exchange(true)) {
+      throw_client_busy();
+    }
+    client->reset_if_needed();
+    try {
+      client->ptr->BeginInsert(query);
+    } catch (...) {
+      reset_connection();
+      client->streaming = false;
+      throw;
+    }
+    open = true;
+  }
+
+  // Sends the block with its columns in the order given to begin, matched
+  // by name, so callers may build columns in any order
+  void send(const Block &block) {
+    std::lock_guard<std::mutex> guard(mutex);
+    ensure_open();
+
+    if (block.GetColumnCount() != columns.size()) {
+      throw ValidationError("block has " + std::to_string(block.GetColumnCount()) +
+                            " columns, insert session expects " +
+                            std::to_string(columns.size()));
+    }
+
+    Block ordered(columns.size(), block.GetRowCount());
+    for (const auto &name : columns) {
+      ColumnRef column;
+      for (size_t c = 0; c < block.GetColumnCount(); c++) {
+        if (block.GetColumnName(c) == name) {
+          column = block[c];
+          break;
+        }
+      }
+      if (!column) {
+        throw ValidationError("block is missing column " + name);
+      }
+      ordered.AppendColumn(name, column);
+    }
+
+    run([&] { client->ptr->SendInsertBlock(ordered); });
+    rows_sent += block.GetRowCount();
+  }
+
+  uint64_t finish() {
+    std::lock_guard<std::mutex> guard(mutex);
+    ensure_open();
+    // The claim is released under the client mutex, so a request waiting
+    // for it never sees the connection as still busy
+    run([&] {
+      client->ptr->EndInsert();
+      open = false;
+      client->streaming = false;
+    });
+    return rows_sent;
+  }
+
+  void close() {
+    std::lock_guard<std::mutex> guard(mutex);
+    abort();
+  }
+
+ private:
+  void ensure_open() {
+    if (!open) {
+      throw ValidationError("insert session is already finished or closed");
+    }
+  }
+
+  // Runs one protocol step under the client's mutex. Any failure leaves the
+  // INSERT in an unknown state, so the session is aborted before rethrowing.
+  template <typename F>
+  void run(F step) {
+    std::lock_guard<std::mutex> client_guard(client->mutex);
+    try {
+      step();
+    } catch (...) {
+      reset_connection();
+      open = false;
+      client->streaming = false;
+      throw;
+    }
+  }
+
+  void abort() {
+    if (!open) {
+      return;
+    }
+    std::lock_guard<std::mutex> client_guard(client->mutex);
+    reset_connection();
+    open = false;
+    client->streaming = false;
+  }
+
+  // Best effort: a failed reconnect surfaces on the next request instead
+  void reset_connection() {
+    try {
+      client->ptr->ResetConnection();
+    } catch (const std::exception &) {
+    }
+  }
+};
+
+FINE_RESOURCE(InsertSessionResource);
+
+// ============================================================================
+// Insert Session NIFs
+// ============================================================================
+
+/// Opens an INSERT for the given columns and returns a session
+fine::ResourcePtr<InsertSessionResource> client_insert_begin(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ClientResource> client,
+    std::string table_name,
+    std::vector<std::string> columns) {
+  try {
+    auto session = fine::make_resource<InsertSessionResource>(client, columns);
+    session->begin(table_name);
+    return session;
+  } catch (const std::exception& e) {
+    throw std::runtime_error(encode_clickhouse_error(e));
+  }
+}
+FINE_NIF(client_insert_begin, NATCH_DIRTY_IO);
+
+/// Sends one block as part of the session's INSERT
+fine::Atom insert_session_send_block(
+    ErlNifEnv *env,
+    fine::ResourcePtr<InsertSessionResource> session,
+    fine::ResourcePtr<BlockResource> block_res) {
+  try {
+    session->send(*block_res->ptr);
+    return fine::Atom("ok");
+  } catch (const std::exception& e) {
+    throw std::runtime_error(encode_clickhouse_error(e));
+  }
+}
+FINE_NIF(insert_session_send_block, NATCH_DIRTY_IO);
+
+/// Completes the INSERT and releases the connection. Returns the number of
+/// rows sent.
+uint64_t insert_session_finish(
+    ErlNifEnv *env,
+    fine::ResourcePtr<InsertSessionResource> session) {
+  try {
+    return session->finish();
+  } catch (const std::exception& e) {
+    throw std::runtime_error(encode_clickhouse_error(e));
+  }
+}
+FINE_NIF(insert_session_finish, NATCH_DIRTY_IO);
+
+/// Aborts the INSERT if it is still open and releases the connection
+fine::Atom insert_session_close(
+    ErlNifEnv *env,
+    fine::ResourcePtr<InsertSessionResource> session) {
+  session->close();
+  return fine::Atom("ok");
+}
+FINE_NIF(insert_session_close, NATCH_DIRTY_IO);
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <erl_nif.h>
+
+// Scheduler flags used when registering NIFs.
+//
+// NIFs that block on the network (connect, ping, execute, insert, select)
+// run on dirty I/O schedulers, and NIFs that walk large lists to build
+// columns run on dirty CPU schedulers, so a long query never pins a normal
+// BEAM scheduler. Building with -DNATCH_DIRTY_SCHEDULERS=OFF registers
+// everything on normal schedulers, which is only useful for benchmarking
+// the difference (see bench/scheduler_latency_bench.exs).
+#ifdef NATCH_NO_DIRTY_SCHEDULERS
+#define NATCH_DIRTY_IO 0
+#define NATCH_DIRTY_CPU 0
+#else
+#define NATCH_DIRTY_IO ERL_NIF_DIRTY_JOB_IO_BOUND
+#define NATCH_DIRTY_CPU ERL_NIF_DIRTY_JOB_CPU_BOUND
+#endif
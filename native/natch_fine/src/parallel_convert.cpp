@@ -0,0 +1,220 @@
+// parallel_convert.cpp - Parallel per-column term conversion
+//
+// See parallel_convert.h. The pool is created on first use and grows to the
+// configured thread count; it is never torn down, since its threads only
+// ever wait for work.
+
+#include <fine.hpp>
+#include <clickhouse/block.h>
+#include <clickhouse/columns/column.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "parallel_convert.h"
+
+using namespace clickhouse;
+
+// Columns are only split into row ranges of at least this many rows, so the
+// per-unit env, Slice and copy overhead stays small next to the conversion
+constexpr size_t MIN_RANGE_ROWS = 16384;
+
+static std::atomic<size_t> g_min_rows{20000};
+static std::atomic<size_t> g_threads{std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), 8)};
+
+ParallelConversionSettings parallel_conversion_settings() {
+  return ParallelConversionSettings{g_min_rows.load(), g_threads.load()};
+}
+
+namespace {
+
+class ConversionPool {
+ public:
+  static ConversionPool &instance() {
+    // Intentionally leaked: workers may still be parked in wait() at exit
+    static ConversionPool *pool = new ConversionPool();
+    return *pool;
+  }
+
+  void ensure_workers(size_t count) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    while (workers_.size() < count) {
+      workers_.emplace_back(&ConversionPool::worker_loop, this);
+      workers_.back().detach();
+    }
+  }
+
+  void submit(std::function<void()> task) {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      tasks_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()>> tasks_;
+  std::vector<std::thread> workers_;
+
+  void worker_loop() {
+    for (;;) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> guard(mutex_);
+        cv_.wait(guard, [this] { return !tasks_.empty(); });
+        task = std::move(tasks_.front());
+        tasks_.pop_front();
+      }
+      task();
+    }
+  }
+};
+
+// One column, or a row range of one column, converted into its own env
+struct ConversionUnit {
+  size_t column;
+  size_t offset;
+  size_t length;
+  ErlNifEnv *env = nullptr;
+  ERL_NIF_TERM list = 0;
+};
+
+// A set of units claimed by index from any thread that calls drain()
+struct ConversionBatch {
+  const ConversionPlan &plan;
+  const Block &block;
+  std::vector<ConversionUnit> units;
+  std::atomic<size_t> next{0};
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  size_t remaining;
+  std::string error;
+
+  ConversionBatch(const ConversionPlan &p, const Block &b, std::vector<ConversionUnit> u)
+      : plan(p), block(b), units(std::move(u)), remaining(units.size()) {}
+
+  void drain() {
+    for (size_t i = next.fetch_add(1); i < units.size(); i = next.fetch_add(1)) {
+      run(units[i]);
+      std::lock_guard<std::mutex> guard(mutex);
+      if (--remaining == 0) {
+        cv.notify_all();
+      }
+    }
+  }
+
+  void wait() {
+    std::unique_lock<std::mutex> guard(mutex);
+    cv.wait(guard, [this] { return remaining == 0; });
+  }
+
+ private:
+  void run(ConversionUnit &unit) {
+    try {
+      ColumnRef col = block[unit.column];
+      if (unit.length != col->Size()) {
+        col = col->Slice(unit.offset, unit.length);
+      }
+      unit.env = enif_alloc_env();
+      std::vector<ERL_NIF_TERM> terms;
+      plan.convert(unit.env, unit.column, col, terms);
+      unit.list = enif_make_list_from_array(unit.env, terms.data(), terms.size());
+    } catch (const std::exception &e) {
+      std::lock_guard<std::mutex> guard(mutex);
+      if (error.empty()) {
+        error = e.what();
+      }
+    }
+  }
+};
+
+}  // namespace
+
+void convert_block_columns(ErlNifEnv *env, const ConversionPlan &plan, const Block &block,
+                           std::vector<std::vector<ERL_NIF_TERM>> &columns) {
+  size_t col_count = block.GetColumnCount();
+  size_t row_count = block.GetRowCount();
+  if (columns.size() < col_count) {
+    columns.resize(col_count);
+  }
+
+  ParallelConversionSettings settings = parallel_conversion_settings();
+  size_t ranges = 1;
+  if (settings.threads > col_count) {
+    ranges = std::max<size_t>(1, std::min(settings.threads / std::max<size_t>(col_count, 1),
+                                          row_count / MIN_RANGE_ROWS));
+  }
+
+  if (settings.threads <= 1 || row_count == 0 || row_count < settings.min_rows ||
+      col_count * ranges < 2) {
+    for (size_t c = 0; c < col_count; c++) {
+      plan.convert(env, c, block[c], columns[c]);
+    }
+    return;
+  }
+
+  // Units in column order, row ranges in row order, so copying them back in
+  // sequence appends every column's terms in the right order
+  std::vector<ConversionUnit> units;
+  units.reserve(col_count * ranges);
+  for (size_t c = 0; c < col_count; c++) {
+    size_t range_rows = (row_count + ranges - 1) / ranges;
+    for (size_t offset = 0; offset < row_count; offset += range_rows) {
+      units.push_back(ConversionUnit{c, offset, std::min(range_rows, row_count - offset)});
+    }
+  }
+
+  auto batch = std::make_shared<ConversionBatch>(plan, block, std::move(units));
+  size_t helpers = std::min(settings.threads, batch->units.size()) - 1;
+  ConversionPool &pool = ConversionPool::instance();
+  pool.ensure_workers(settings.threads - 1);
+  for (size_t i = 0; i < helpers; i++) {
+    pool.submit([batch] { batch->drain(); });
+  }
+  batch->drain();
+  batch->wait();
+
+  // Stitch results into the caller's env and release the unit envs
+  for (auto &unit : batch->units) {
+    if (unit.env && batch->error.empty()) {
+      ERL_NIF_TERM list = enif_make_copy(env, unit.list);
+      auto &out = columns[unit.column];
+      out.reserve(out.size() + unit.length);
+      ERL_NIF_TERM head;
+      while (enif_get_list_cell(env, list, &head, &list)) {
+        out.push_back(head);
+      }
+    }
+    if (unit.env) {
+      enif_free_env(unit.env);
+      unit.env = nullptr;
+    }
+  }
+
+  if (!batch->error.empty()) {
+    throw std::runtime_error(batch->error);
+  }
+}
+
+// Configure parallel conversion. threads <= 1 disables it; blocks with fewer
+// than min_rows rows are always converted on the calling thread.
+fine::Atom set_parallel_conversion(
+    ErlNifEnv *env,
+    uint64_t min_rows,
+    uint64_t threads) {
+  g_min_rows = min_rows;
+  g_threads = std::max<uint64_t>(threads, 1);
+  return fine::Atom("ok");
+}
+FINE_NIF(set_parallel_conversion, 0);
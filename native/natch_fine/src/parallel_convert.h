@@ -0,0 +1,34 @@
+#pragma once
+
+#include <erl_nif.h>
+#include <clickhouse/block.h>
+#include <cstddef>
+#include <vector>
+#include "conversion_plan.h"
+
+// Block-to-terms conversion shared by every SELECT path.
+//
+// Small blocks are converted column by column on the calling thread. Blocks
+// with at least `min_rows` rows are split into work units (one per column,
+// and large columns further into row ranges) that run on a fixed native
+// thread pool. Each unit builds its terms in its own process-independent
+// env; the calling thread then copies the unit's list into `env` with
+// enif_make_copy and frees the unit env. The calling thread works on units
+// too, so a busy pool only reduces parallelism, never blocks progress.
+//
+// Settings are process-wide and set from Elixir via set_parallel_conversion
+// (see Natch.Application). threads <= 1 disables parallel conversion.
+
+struct ParallelConversionSettings {
+  size_t min_rows;
+  size_t threads;
+};
+
+ParallelConversionSettings parallel_conversion_settings();
+
+// Converts every column of `block` with `plan` (built for the block's header)
+// into one term per row, appended to columns[c] (resized to the block's
+// column count if needed)
+void convert_block_columns(ErlNifEnv *env, const ConversionPlan &plan,
+                           const clickhouse::Block &block,
+                           std::vector<std::vector<ERL_NIF_TERM>> &columns);
@@ -0,0 +1,330 @@
+// pool.cpp - Native connection pool
+//
+// A PoolResource owns N clickhouse::Client instances created from one
+// ClientOptions. Callers check a client out directly from the NIF (no
+// GenServer in the path), so concurrent queries scale with pool size.
+//
+// Checkout claims a free slot with a compare-and-swap on its busy flag,
+// starting from a rotating index so load spreads across connections. Only
+// when every slot is busy does a caller block on a condition variable until
+// a checkin or the checkout timeout.
+//
+// Health: a slot whose last request failed with a socket-level error is
+// marked broken and reset (ResetConnection) before it is handed out again.
+// Slots idle for longer than the health check interval are pinged on
+// checkout and reset if the ping fails.
+
+#include <fine.hpp>
+#include <clickhouse/client.h>
+#include <clickhouse/query.h>
+#include <clickhouse/block.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+#include "block_resource.h"
+#include "client_resource.h"
+#include "error_encoding.h"
+#include "nif_flags.h"
+
+using namespace clickhouse;
+
+// Defined in select.cpp
+ERL_NIF_TERM select_rows_impl(ErlNifEnv *env, Client &client, Query query, PlanCache &plans);
+ERL_NIF_TERM select_cols_impl(ErlNifEnv *env, Client &client, Query query, EnumFormat enums,
+                              PlanCache &plans);
+
+using SteadyClock = std::chrono::steady_clock;
+
+struct PoolSlot {
+  std::unique_ptr<Client> client;
+  std::atomic<bool> busy{false};
+  // Only touched by the thread that holds the slot
+  bool broken = false;
+  SteadyClock::time_point last_used = SteadyClock::now();
+};
+
+struct PoolResource {
+  ClientOptions opts;
+  std::vector<std::unique_ptr<PoolSlot>> slots;
+  // Shared by all connections: the pool runs the same queries on each
+  PlanCache plans;
+  std::chrono::milliseconds checkout_timeout;
+  std::chrono::milliseconds health_check_interval;
+
+  std::atomic<size_t> next_slot{0};
+  std::atomic<size_t> in_use{0};
+  std::atomic<uint64_t> resets{0};
+  std::mutex wait_mutex;
+  std::condition_variable wait_cv;
+
+  PoolResource(const ClientOptions& o, size_t size, uint64_t checkout_timeout_ms,
+               uint64_t health_check_interval_ms)
+      : opts(o),
+        checkout_timeout(checkout_timeout_ms),
+        health_check_interval(health_check_interval_ms) {
+    slots.reserve(size);
+    for (size_t i = 0; i < size; i++) {
+      auto slot = std::make_unique<PoolSlot>();
+      slot->client = std::make_unique<Client>(opts);
+      slots.push_back(std::move(slot));
+    }
+  }
+
+  // Lock-free scan for a free slot starting at a rotating position
+  PoolSlot* try_claim() {
+    size_t n = slots.size();
+    size_t start = next_slot.fetch_add(1, std::memory_order_relaxed);
+    for (size_t i = 0; i < n; i++) {
+      PoolSlot* slot = slots[(start + i) % n].get();
+      bool expected = false;
+      if (slot->busy.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+        in_use.fetch_add(1, std::memory_order_relaxed);
+        return slot;
+      }
+    }
+    return nullptr;
+  }
+
+  PoolSlot* checkout() {
+    PoolSlot* slot = try_claim();
+    if (!slot) {
+      auto deadline = SteadyClock::now() + checkout_timeout;
+      std::unique_lock<std::mutex> guard(wait_mutex);
+      while (!(slot = try_claim())) {
+        if (wait_cv.wait_until(guard, deadline) == std::cv_status::timeout &&
+            !(slot = try_claim())) {
+          throw ValidationError("pool checkout timed out: all " +
+                                std::to_string(slots.size()) + " connections are busy");
+        }
+        if (slot) {
+          break;
+        }
+      }
+    }
+
+    try {
+      ensure_healthy(*slot);
+    } catch (...) {
+      checkin(slot);
+      throw;
+    }
+    return slot;
+  }
+
+  void checkin(PoolSlot* slot) {
+    slot->last_used = SteadyClock::now();
+    slot->busy.store(false, std::memory_order_release);
+    in_use.fetch_sub(1, std::memory_order_relaxed);
+    {
+      // Pairs with the waiter's predicate check so the wakeup is not lost
+      std::lock_guard<std::mutex> guard(wait_mutex);
+    }
+    wait_cv.notify_one();
+  }
+
+  void reset(PoolSlot& slot) {
+    resets.fetch_add(1, std::memory_order_relaxed);
+    slot.client->ResetConnection();
+    slot.broken = false;
+  }
+
+  void ensure_healthy(PoolSlot& slot) {
+    if (slot.broken) {
+      reset(slot);
+      return;
+    }
+
+    if (health_check_interval.count() > 0 &&
+        SteadyClock::now() - slot.last_used > health_check_interval) {
+      try {
+        slot.client->Ping();
+      } catch (const std::exception&) {
+        reset(slot);
+      }
+    }
+  }
+};
+
+FINE_RESOURCE(PoolResource);
+
+// Runs `fn` on a checked-out client and returns it to the pool afterwards.
+// Socket-level failures mark the slot broken so the next checkout
+// reconnects it instead of handing out a dead connection.
+template <typename Fn>
+auto with_pooled_client(PoolResource& pool, Fn fn) -> decltype(fn(std::declval<Client&>())) {
+  PoolSlot* slot;
+  try {
+    slot = pool.checkout();
+  } catch (const std::exception& e) {
+    throw std::runtime_error(encode_clickhouse_error(e));
+  }
+
+  try {
+    auto result = fn(*slot->client);
+    pool.checkin(slot);
+    return result;
+  } catch (const std::exception& e) {
+    if (dynamic_cast<const std::system_error*>(&e) ||
+        dynamic_cast<const ProtocolError*>(&e)) {
+      slot->broken = true;
+    }
+    pool.checkin(slot);
+    throw std::runtime_error(encode_clickhouse_error(e));
+  }
+}
+
+// Wrapper struct to return raw terms from pool NIFs
+struct PoolResult {
+  ERL_NIF_TERM term;
+
+  PoolResult(ERL_NIF_TERM t) : term(t) {}
+};
+
+namespace fine {
+  template <>
+  struct Encoder<PoolResult> {
+    static ERL_NIF_TERM encode(ErlNifEnv *env, const PoolResult &result) {
+      return result.term;
+    }
+  };
+
+  template <>
+  struct Decoder<PoolResult> {
+    static bool decode(ErlNifEnv *env, ERL_NIF_TERM term, PoolResult &result) {
+      return false;  // Only used for return values
+    }
+  };
+}
+
+// ============================================================================
+// Pool Lifecycle
+// ============================================================================
+
+/// Creates a pool of `size` connections (same arguments as client_create)
+fine::ResourcePtr<PoolResource> pool_create(
+    ErlNifEnv *env,
+    std::string host,
+    uint64_t port,
+    std::string database,
+    std::string user,
+    std::string password,
+    bool compression,
+    bool ssl,
+    uint64_t connect_timeout,
+    uint64_t recv_timeout,
+    uint64_t send_timeout,
+    uint64_t size,
+    uint64_t checkout_timeout,
+    uint64_t health_check_interval) {
+  if (size == 0) {
+    throw std::runtime_error(encode_clickhouse_error(
+        ValidationError("pool size must be greater than 0")));
+  }
+
+  try {
+    ClientOptions opts = build_client_options(
+        host, port, database, user, password, compression, ssl,
+        connect_timeout, recv_timeout, send_timeout);
+    return fine::make_resource<PoolResource>(opts, size, checkout_timeout, health_check_interval);
+  } catch (const std::exception& e) {
+    throw std::runtime_error(encode_clickhouse_error(e));
+  }
+}
+FINE_NIF(pool_create, NATCH_DIRTY_IO);
+
+/// Returns %{size: n, in_use: n, resets: n}
+fine::Term pool_status(
+    ErlNifEnv *env,
+    fine::ResourcePtr<PoolResource> pool) {
+  ERL_NIF_TERM keys[] = {
+    enif_make_atom(env, "size"),
+    enif_make_atom(env, "in_use"),
+    enif_make_atom(env, "resets"),
+  };
+  ERL_NIF_TERM values[] = {
+    enif_make_uint64(env, pool->slots.size()),
+    enif_make_uint64(env, pool->in_use.load()),
+    enif_make_uint64(env, pool->resets.load()),
+  };
+  ERL_NIF_TERM map;
+  enif_make_map_from_arrays(env, keys, values, 3, &map);
+  return map;
+}
+FINE_NIF(pool_status, 0);
+
+// ============================================================================
+// Pooled Queries
+// ============================================================================
+
+/// Runs a SELECT on a pooled connection
+///
+/// @param format :rows (list of maps) or :columns (%{column => [values]})
+PoolResult pool_select(
+    ErlNifEnv *env,
+    fine::ResourcePtr<PoolResource> pool,
+    std::string sql,
+    fine::Atom format) {
+  bool columnar = format.to_string() == "columns";
+  return PoolResult(with_pooled_client(*pool, [&](Client &client) {
+    return columnar ? select_cols_impl(env, client, Query(sql), EnumFormat::Binaries, pool->plans)
+                    : select_rows_impl(env, client, Query(sql), pool->plans);
+  }));
+}
+FINE_NIF(pool_select, NATCH_DIRTY_IO);
+
+/// Runs a parameterized SELECT on a pooled connection
+PoolResult pool_select_parameterized(
+    ErlNifEnv *env,
+    fine::ResourcePtr<PoolResource> pool,
+    fine::ResourcePtr<Query> query,
+    fine::Atom format) {
+  bool columnar = format.to_string() == "columns";
+  return PoolResult(with_pooled_client(*pool, [&](Client &client) {
+    return columnar ? select_cols_impl(env, client, *query, EnumFormat::Binaries, pool->plans)
+                    : select_rows_impl(env, client, *query, pool->plans);
+  }));
+}
+FINE_NIF(pool_select_parameterized, NATCH_DIRTY_IO);
+
+/// Runs a DDL/DML statement on a pooled connection
+fine::Atom pool_execute(
+    ErlNifEnv *env,
+    fine::ResourcePtr<PoolResource> pool,
+    std::string sql) {
+  return with_pooled_client(*pool, [&](Client &client) {
+    client.Execute(sql);
+    return fine::Atom("ok");
+  });
+}
+FINE_NIF(pool_execute, NATCH_DIRTY_IO);
+
+/// Runs a parameterized statement on a pooled connection
+fine::Atom pool_execute_parameterized(
+    ErlNifEnv *env,
+    fine::ResourcePtr<PoolResource> pool,
+    fine::ResourcePtr<Query> query) {
+  return with_pooled_client(*pool, [&](Client &client) {
+    client.Execute(*query);
+    return fine::Atom("ok");
+  });
+}
+FINE_NIF(pool_execute_parameterized, NATCH_DIRTY_IO);
+
+/// Inserts a block on a pooled connection
+fine::Atom pool_insert(
+    ErlNifEnv *env,
+    fine::ResourcePtr<PoolResource> pool,
+    std::string table_name,
+    fine::ResourcePtr<BlockResource> block_res) {
+  return with_pooled_client(*pool, [&](Client &client) {
+    client.Insert(table_name, *block_res->ptr);
+    return fine::Atom("ok");
+  });
+}
+FINE_NIF(pool_insert, NATCH_DIRTY_IO);
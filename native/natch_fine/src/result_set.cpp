@@ -0,0 +1,223 @@
+// result_set.cpp - Lazily decoded SELECT results
+//
+// client_select_blocks runs a SELECT and keeps the received blocks in a
+// ResultSetResource without building any terms. The accessor NIFs below
+// decode only what they are asked for: the row count and column names come
+// from the header, column/2 converts one column, and slice/row convert a
+// range of rows by slicing the blocks it spans.
+
+#include <fine.hpp>
+#include <clickhouse/client.h>
+#include <clickhouse/query.h>
+#include <clickhouse/block.h>
+#include <clickhouse/exceptions.h>
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "client_resource.h"
+#include "error_encoding.h"
+#include "nif_flags.h"
+#include "result_set.h"
+
+using namespace clickhouse;
+
+FINE_RESOURCE(ResultSetResource);
+
+static size_t column_index(const ResultSetResource &result, const std::string &name) {
+  for (size_t c = 0; c < result.column_names.size(); c++) {
+    if (result.column_names[c] == name) {
+      return c;
+    }
+  }
+  throw ValidationError("unknown column " + name);
+}
+
+// Convert rows [offset, offset + length) of column `c`, appended to `out`.
+// The range must lie within the result.
+static void convert_column_range(ErlNifEnv *env, const ResultSetResource &result, size_t c,
+                                 size_t offset, size_t length, std::vector<ERL_NIF_TERM> &out) {
+  if (length == 0) {
+    return;
+  }
+
+  out.reserve(out.size() + length);
+  auto [b, row] = result.locate(offset);
+  size_t remaining = length;
+
+  for (; remaining > 0; b++, row = 0) {
+    ColumnRef col = result.blocks[b][c];
+    size_t count = std::min(col->Size() - row, remaining);
+    if (row != 0 || count != col->Size()) {
+      col = col->Slice(row, count);
+    }
+    result.header->plan.convert(env, c, col, out);
+    remaining -= count;
+  }
+}
+
+static std::vector<ERL_NIF_TERM> key_atoms(const ResultSetResource &result) {
+  return result.header ? result.header->names : std::vector<ERL_NIF_TERM>();
+}
+
+// Run a SELECT and keep its blocks without converting them. Enum names
+// will be converted in `enums` format.
+static fine::ResourcePtr<ResultSetResource> select_blocks_impl(ErlNifEnv *env,
+                                                               ClientResource &client,
+                                                               Query query, EnumFormat enums) {
+  auto result = fine::make_resource<ResultSetResource>();
+  query.OnData([&](const Block &block) { result->append(env, block, enums, client.plans); });
+  client.ptr->Select(query);
+  return result;
+}
+
+// ============================================================================
+// Result Set NIFs
+// ============================================================================
+
+/// Executes a SELECT and returns the unconverted result
+///
+/// @param enum_format :binary or :atom, how enum names will be converted
+fine::ResourcePtr<ResultSetResource> client_select_blocks(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ClientResource> client,
+    std::string query,
+    fine::Atom enum_format) {
+  try {
+    ClientLock lock(*client);
+    return select_blocks_impl(env, *client, Query(query),
+                              enum_format_from_name(enum_format.to_string()));
+  } catch (const std::exception& e) {
+    throw std::runtime_error(encode_clickhouse_error(e));
+  }
+}
+FINE_NIF(client_select_blocks, NATCH_DIRTY_IO);
+
+/// Executes a parameterized SELECT and returns the unconverted result
+fine::ResourcePtr<ResultSetResource> client_select_blocks_parameterized(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ClientResource> client,
+    fine::ResourcePtr<Query> query,
+    fine::Atom enum_format) {
+  try {
+    ClientLock lock(*client);
+    return select_blocks_impl(env, *client, *query,
+                              enum_format_from_name(enum_format.to_string()));
+  } catch (const std::exception& e) {
+    throw std::runtime_error(encode_clickhouse_error(e));
+  }
+}
+FINE_NIF(client_select_blocks_parameterized, NATCH_DIRTY_IO);
+
+/// Returns the number of rows in the result
+uint64_t result_row_count(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ResultSetResource> result) {
+  return result->row_count;
+}
+FINE_NIF(result_row_count, 0);
+
+/// Returns the result's column names in order
+std::vector<fine::Atom> result_column_names(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ResultSetResource> result) {
+  std::vector<fine::Atom> names;
+  for (const auto &name : result->column_names) {
+    names.push_back(fine::Atom(name));
+  }
+  return names;
+}
+FINE_NIF(result_column_names, 0);
+
+/// Converts one column to a list of all its values
+fine::Term result_column(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ResultSetResource> result,
+    std::string name) {
+  try {
+    size_t c = column_index(*result, name);
+    std::vector<ERL_NIF_TERM> values;
+    convert_column_range(env, *result, c, 0, result->row_count, values);
+    return enif_make_list_from_array(env, values.data(), values.size());
+  } catch (const std::exception& e) {
+    throw std::runtime_error(encode_clickhouse_error(e));
+  }
+}
+FINE_NIF(result_column, NATCH_DIRTY_CPU);
+
+/// Converts up to `length` rows starting at `offset` to a list of maps
+/// (:rows) or %{column => [values]} (:columns)
+fine::Term result_slice(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ResultSetResource> result,
+    uint64_t offset,
+    uint64_t length,
+    fine::Atom format) {
+  try {
+    size_t start = std::min<size_t>(offset, result->row_count);
+    size_t count = std::min<size_t>(length, result->row_count - start);
+    size_t col_count = result->column_names.size();
+
+    std::vector<std::vector<ERL_NIF_TERM>> columns(col_count);
+    for (size_t c = 0; c < col_count; c++) {
+      convert_column_range(env, *result, c, start, count, columns[c]);
+    }
+
+    std::vector<ERL_NIF_TERM> keys = key_atoms(*result);
+
+    if (format.to_string() == "columns") {
+      std::vector<ERL_NIF_TERM> lists;
+      lists.reserve(col_count);
+      for (auto &values : columns) {
+        lists.push_back(enif_make_list_from_array(env, values.data(), values.size()));
+      }
+      ERL_NIF_TERM columns_map;
+      enif_make_map_from_arrays(env, keys.data(), lists.data(), col_count, &columns_map);
+      return columns_map;
+    }
+
+    std::vector<ERL_NIF_TERM> rows;
+    std::vector<ERL_NIF_TERM> values(col_count);
+    rows.reserve(count);
+    for (size_t r = 0; r < count; r++) {
+      for (size_t c = 0; c < col_count; c++) {
+        values[c] = columns[c][r];
+      }
+      ERL_NIF_TERM map;
+      enif_make_map_from_arrays(env, keys.data(), values.data(), col_count, &map);
+      rows.push_back(map);
+    }
+    return enif_make_list_from_array(env, rows.data(), rows.size());
+  } catch (const std::exception& e) {
+    throw std::runtime_error(encode_clickhouse_error(e));
+  }
+}
+FINE_NIF(result_slice, NATCH_DIRTY_CPU);
+
+/// Converts row `index` to a map, or nil when out of range
+std::optional<fine::Term> result_row(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ResultSetResource> result,
+    uint64_t index) {
+  if (index >= result->row_count) {
+    return std::nullopt;
+  }
+
+  try {
+    size_t col_count = result->column_names.size();
+    std::vector<ERL_NIF_TERM> values;
+    values.reserve(col_count);
+    for (size_t c = 0; c < col_count; c++) {
+      convert_column_range(env, *result, c, index, 1, values);
+    }
+
+    std::vector<ERL_NIF_TERM> keys = key_atoms(*result);
+    ERL_NIF_TERM map;
+    enif_make_map_from_arrays(env, keys.data(), values.data(), col_count, &map);
+    return fine::Term(map);
+  } catch (const std::exception& e) {
+    throw std::runtime_error(encode_clickhouse_error(e));
+  }
+}
+FINE_NIF(result_row, 0);
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <clickhouse/block.h>
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "conversion_plan.h"
+
+// A SELECT result kept in native form. Receiving a result (dirty I/O) and
+// converting it to terms are separate NIF calls, so callers can decode only
+// the columns or rows they read (see result_set.cpp), or convert everything
+// on a normal scheduler with yielding (see yielding_convert.cpp).
+struct ResultSetResource {
+  // Only blocks with at least one row
+  std::vector<clickhouse::Block> blocks;
+  // First row of each block
+  std::vector<size_t> block_offsets;
+  size_t row_count = 0;
+  // From the first block received, so empty results still have a header
+  std::vector<std::string> column_names;
+  // Conversion plan and name atoms of that header, from the plan cache
+  std::shared_ptr<const HeaderPlan> header;
+
+  void append(ErlNifEnv *env, const clickhouse::Block &block, EnumFormat enums,
+              PlanCache &plans) {
+    if (!header) {
+      for (size_t c = 0; c < block.GetColumnCount(); c++) {
+        column_names.push_back(block.GetColumnName(c));
+      }
+      header = plans.get(env, block, enums);
+    }
+    if (block.GetRowCount() > 0) {
+      blocks.push_back(block);
+      block_offsets.push_back(row_count);
+      row_count += block.GetRowCount();
+    }
+  }
+
+  // Block index and row within that block of result row `row` (< row_count)
+  std::pair<size_t, size_t> locate(size_t row) const {
+    auto it = std::upper_bound(block_offsets.begin(), block_offsets.end(), row);
+    size_t b = static_cast<size_t>(it - block_offsets.begin()) - 1;
+    return {b, row - block_offsets[b]};
+  }
+};
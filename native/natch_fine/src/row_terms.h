@@ -0,0 +1,139 @@
+#pragma once
+
+#include <erl_nif.h>
+#include <clickhouse/exceptions.h>
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Shape of each row in a row-oriented result. Maps repeat the column names
+// in every row; tuples and lists are positional and come with the names
+// once, as {column_names, rows}.
+enum class RowFormat { Maps, Tuples, Lists };
+
+// "tuples" and "lists" select those shapes; anything else is maps
+inline RowFormat row_format_from_name(const std::string &name) {
+  if (name == "tuples") {
+    return RowFormat::Tuples;
+  }
+  if (name == "lists") {
+    return RowFormat::Lists;
+  }
+  return RowFormat::Maps;
+}
+
+// One row from its column values; `keys` (column name atoms) are only read
+// for maps
+inline ERL_NIF_TERM make_row(ErlNifEnv *env, RowFormat format, const ERL_NIF_TERM *keys,
+                             const ERL_NIF_TERM *values, size_t count) {
+  switch (format) {
+  case RowFormat::Tuples:
+    return enif_make_tuple_from_array(env, values, static_cast<unsigned>(count));
+  case RowFormat::Lists:
+    return enif_make_list_from_array(env, values, static_cast<unsigned>(count));
+  case RowFormat::Maps:
+  default: {
+    // The arrays are only read, despite the non-const signature
+    ERL_NIF_TERM map;
+    enif_make_map_from_arrays(env, const_cast<ERL_NIF_TERM *>(keys),
+                              const_cast<ERL_NIF_TERM *>(values), count, &map);
+    return map;
+  }
+  }
+}
+
+// The final result: the row list for maps, {column_names, rows} otherwise
+inline ERL_NIF_TERM rows_result(ErlNifEnv *env, RowFormat format,
+                                const std::vector<ERL_NIF_TERM> &keys, ERL_NIF_TERM rows) {
+  if (format == RowFormat::Maps) {
+    return rows;
+  }
+  ERL_NIF_TERM names = enif_make_list_from_array(env, keys.data(), static_cast<unsigned>(keys.size()));
+  return enif_make_tuple2(env, names, rows);
+}
+
+// Builds %Module{} rows directly. The struct's keys (with __struct__) are
+// sorted once into a cached key array; each row fills the values from the
+// mapped columns, or the field's default for fields with no column.
+class StructRowBuilder {
+ public:
+  // `fields` are the struct's {field, default} pairs, `mapping` maps column
+  // names to field names where they differ. Defaults must be terms of the
+  // env rows are built in.
+  StructRowBuilder(ErlNifEnv *env, ERL_NIF_TERM module,
+                   const std::vector<std::pair<ERL_NIF_TERM, ERL_NIF_TERM>> &fields,
+                   const std::vector<std::pair<ERL_NIF_TERM, ERL_NIF_TERM>> &mapping)
+      : module_(module), struct_key_(enif_make_atom(env, "__struct__")), mapping_(mapping) {
+    std::vector<Slot> slots;
+    slots.push_back(Slot{struct_key_, module});
+    for (const auto &[field, default_value] : fields) {
+      slots.push_back(Slot{field, default_value});
+    }
+    std::sort(slots.begin(), slots.end(), [](const Slot &a, const Slot &b) {
+      return enif_compare(a.key, b.key) < 0;
+    });
+    for (const auto &slot : slots) {
+      keys_.push_back(slot.key);
+      defaults_.push_back(slot.default_value);
+    }
+    sources_.assign(keys_.size(), -1);
+  }
+
+  // Resolves each result column (name atoms, in column order) to its field.
+  // Throws if a column matches no field of the struct.
+  void bind(ErlNifEnv *env, const std::vector<ERL_NIF_TERM> &columns) {
+    std::fill(sources_.begin(), sources_.end(), -1);
+    for (size_t c = 0; c < columns.size(); c++) {
+      ERL_NIF_TERM field = columns[c];
+      for (const auto &[column, mapped] : mapping_) {
+        if (enif_is_identical(column, columns[c])) {
+          field = mapped;
+          break;
+        }
+      }
+
+      auto it = std::find_if(keys_.begin(), keys_.end(),
+                             [&](ERL_NIF_TERM key) { return enif_is_identical(key, field); });
+      if (it == keys_.end() || enif_is_identical(field, struct_key_)) {
+        throw clickhouse::ValidationError("column " + atom_text(env, columns[c]) +
+                                          " is not a field of " + atom_text(env, module_));
+      }
+      sources_[static_cast<size_t>(it - keys_.begin())] = static_cast<int>(c);
+    }
+    values_.assign(keys_.size(), 0);
+  }
+
+  // One struct from a row's column values
+  ERL_NIF_TERM make(ErlNifEnv *env, const ERL_NIF_TERM *column_values) {
+    for (size_t k = 0; k < keys_.size(); k++) {
+      values_[k] = sources_[k] < 0 ? defaults_[k] : column_values[sources_[k]];
+    }
+    ERL_NIF_TERM map;
+    enif_make_map_from_arrays(env, keys_.data(), values_.data(), keys_.size(), &map);
+    return map;
+  }
+
+ private:
+  struct Slot {
+    ERL_NIF_TERM key;
+    ERL_NIF_TERM default_value;
+  };
+
+  static std::string atom_text(ErlNifEnv *env, ERL_NIF_TERM atom) {
+    char name[256];
+    if (enif_get_atom(env, atom, name, sizeof(name), ERL_NIF_LATIN1) > 0) {
+      return name;
+    }
+    return "?";
+  }
+
+  ERL_NIF_TERM module_;
+  ERL_NIF_TERM struct_key_;
+  std::vector<std::pair<ERL_NIF_TERM, ERL_NIF_TERM>> mapping_;
+  std::vector<ERL_NIF_TERM> keys_;
+  std::vector<ERL_NIF_TERM> defaults_;
+  std::vector<int> sources_;
+  std::vector<ERL_NIF_TERM> values_;
+};
@@ -0,0 +1,577 @@
+// rows.cpp - Build a Block directly from row-shaped data
+//
+// block_from_rows walks a list of rows (maps with atom or string keys, or
+// positional tuples) exactly once and decodes each cell straight into a
+// typed clickhouse::Column. This replaces the Elixir transposition in
+// Natch.Conversion.rows_to_columns plus one NIF crossing per column.
+//
+// Each column gets a RowAppender chosen once from its type code, so the
+// per-cell work is a virtual call and a term decode. Types without a native
+// appender (Array, Tuple, Map, Decimal, ...) are built by the Elixir
+// fallback in Natch.Block.build_block_from_rows.
+
+#include <fine.hpp>
+#include <clickhouse/block.h>
+#include <clickhouse/columns/column.h>
+#include <clickhouse/columns/date.h>
+#include <clickhouse/columns/enum.h>
+#include <clickhouse/columns/factory.h>
+#include <clickhouse/columns/nullable.h>
+#include <clickhouse/columns/numeric.h>
+#include <clickhouse/columns/string.h>
+#include <clickhouse/columns/uuid.h>
+#include <clickhouse/exceptions.h>
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include "block_resource.h"
+#include "column_resource.h"
+#include "enum_terms.h"
+#include "error_encoding.h"
+#include "nif_flags.h"
+#include "string_terms.h"
+
+using namespace clickhouse;
+
+// Atoms used while decoding cells, created once per call
+struct RowAtoms {
+  ERL_NIF_TERM nil, true_, false_, struct_, date, datetime;
+  ERL_NIF_TERM year, month, day, hour, minute, second, microsecond;
+  ERL_NIF_TERM utc_offset, std_offset;
+
+  explicit RowAtoms(ErlNifEnv *env)
+      : nil(enif_make_atom(env, "nil")),
+        true_(enif_make_atom(env, "true")),
+        false_(enif_make_atom(env, "false")),
+        struct_(enif_make_atom(env, "__struct__")),
+        date(enif_make_atom(env, "Elixir.Date")),
+        datetime(enif_make_atom(env, "Elixir.DateTime")),
+        year(enif_make_atom(env, "year")),
+        month(enif_make_atom(env, "month")),
+        day(enif_make_atom(env, "day")),
+        hour(enif_make_atom(env, "hour")),
+        minute(enif_make_atom(env, "minute")),
+        second(enif_make_atom(env, "second")),
+        microsecond(enif_make_atom(env, "microsecond")),
+        utc_offset(enif_make_atom(env, "utc_offset")),
+        std_offset(enif_make_atom(env, "std_offset")) {}
+};
+
+// Days since 1970-01-01 for a proleptic Gregorian date (Howard Hinnant's
+// days_from_civil), matching Date.diff(date, ~D[1970-01-01])
+static int64_t days_from_civil(int64_t y, int64_t m, int64_t d) {
+  y -= m <= 2;
+  const int64_t era = (y >= 0 ? y : y - 399) / 400;
+  const int64_t yoe = y - era * 400;
+  const int64_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - 719468;
+}
+
+static bool is_struct(ErlNifEnv *env, ERL_NIF_TERM term, ERL_NIF_TERM module, const RowAtoms &atoms) {
+  ERL_NIF_TERM value;
+  return enif_is_map(env, term) &&
+         enif_get_map_value(env, term, atoms.struct_, &value) &&
+         enif_is_identical(value, module);
+}
+
+static bool get_int_field(ErlNifEnv *env, ERL_NIF_TERM map, ERL_NIF_TERM key, int64_t &out) {
+  ERL_NIF_TERM value;
+  return enif_get_map_value(env, map, key, &value) && enif_get_int64(env, value, &out);
+}
+
+// %Date{} -> days since epoch
+static bool decode_date(ErlNifEnv *env, ERL_NIF_TERM term, const RowAtoms &atoms, int64_t &days) {
+  int64_t y, m, d;
+  if (!is_struct(env, term, atoms.date, atoms) ||
+      !get_int_field(env, term, atoms.year, y) ||
+      !get_int_field(env, term, atoms.month, m) ||
+      !get_int_field(env, term, atoms.day, d)) {
+    return false;
+  }
+  days = days_from_civil(y, m, d);
+  return true;
+}
+
+// %DateTime{} -> Unix seconds plus the microsecond part, matching
+// DateTime.to_unix/2 (wall time minus utc_offset and std_offset)
+static bool decode_datetime(ErlNifEnv *env, ERL_NIF_TERM term, const RowAtoms &atoms,
+                            int64_t &seconds, int64_t &micros) {
+  int64_t y, mo, d, h, mi, s, utc_offset, std_offset;
+  if (!is_struct(env, term, atoms.datetime, atoms) ||
+      !get_int_field(env, term, atoms.year, y) ||
+      !get_int_field(env, term, atoms.month, mo) ||
+      !get_int_field(env, term, atoms.day, d) ||
+      !get_int_field(env, term, atoms.hour, h) ||
+      !get_int_field(env, term, atoms.minute, mi) ||
+      !get_int_field(env, term, atoms.second, s) ||
+      !get_int_field(env, term, atoms.utc_offset, utc_offset) ||
+      !get_int_field(env, term, atoms.std_offset, std_offset)) {
+    return false;
+  }
+
+  // microsecond is {value, precision}
+  ERL_NIF_TERM usec_term;
+  const ERL_NIF_TERM *usec;
+  int arity;
+  if (!enif_get_map_value(env, term, atoms.microsecond, &usec_term) ||
+      !enif_get_tuple(env, usec_term, &arity, &usec) || arity != 2 ||
+      !enif_get_int64(env, usec[0], &micros)) {
+    return false;
+  }
+
+  seconds = days_from_civil(y, mo, d) * 86400 + h * 3600 + mi * 60 + s - utc_offset - std_offset;
+  return true;
+}
+
+// Decodes one cell into a column. append() returns false when the term does
+// not fit the column type; the caller turns that into a validation error
+// naming the column and row.
+class RowAppender {
+ public:
+  virtual ~RowAppender() = default;
+  virtual bool append(ErlNifEnv *env, ERL_NIF_TERM term) = 0;
+  // Placeholder value for a NULL row of a Nullable column
+  virtual void append_default() = 0;
+};
+
+template <typename T>
+class IntegerAppender : public RowAppender {
+ public:
+  IntegerAppender(ColumnRef col, const RowAtoms &atoms, size_t rows)
+      : data_(col->As<ColumnVector<T>>()->GetWritableData()), atoms_(atoms) {
+    data_.reserve(data_.size() + rows);
+  }
+
+  bool append(ErlNifEnv *env, ERL_NIF_TERM term) override {
+    if constexpr (std::is_same_v<T, uint8_t>) {
+      // Bool columns are UInt8
+      if (enif_is_identical(term, atoms_.true_)) {
+        data_.push_back(1);
+        return true;
+      }
+      if (enif_is_identical(term, atoms_.false_)) {
+        data_.push_back(0);
+        return true;
+      }
+    }
+
+    if constexpr (std::is_unsigned_v<T>) {
+      uint64_t value;
+      if (!enif_get_uint64(env, term, &value) || value > std::numeric_limits<T>::max()) {
+        return false;
+      }
+      data_.push_back(static_cast<T>(value));
+    } else {
+      int64_t value;
+      if (!enif_get_int64(env, term, &value) ||
+          value < std::numeric_limits<T>::min() || value > std::numeric_limits<T>::max()) {
+        return false;
+      }
+      data_.push_back(static_cast<T>(value));
+    }
+    return true;
+  }
+
+  void append_default() override { data_.push_back(0); }
+
+ private:
+  std::vector<T> &data_;
+  const RowAtoms &atoms_;
+};
+
+template <typename T>
+class FloatAppender : public RowAppender {
+ public:
+  FloatAppender(ColumnRef col, size_t rows)
+      : data_(col->As<ColumnVector<T>>()->GetWritableData()) {
+    data_.reserve(data_.size() + rows);
+  }
+
+  bool append(ErlNifEnv *env, ERL_NIF_TERM term) override {
+    double value;
+    int64_t integer;
+    if (enif_get_double(env, term, &value)) {
+      data_.push_back(static_cast<T>(value));
+    } else if (enif_get_int64(env, term, &integer)) {
+      data_.push_back(static_cast<T>(integer));
+    } else {
+      return false;
+    }
+    return true;
+  }
+
+  void append_default() override { data_.push_back(0); }
+
+ private:
+  std::vector<T> &data_;
+};
+
+class StringAppender : public RowAppender {
+ public:
+  explicit StringAppender(ColumnRef col) : col_(col->As<ColumnString>()) {}
+
+  bool append(ErlNifEnv *env, ERL_NIF_TERM term) override {
+    ErlNifBinary bin;
+    if (!enif_inspect_binary(env, term, &bin)) {
+      return false;
+    }
+    col_->Append(std::string_view(reinterpret_cast<const char *>(bin.data), bin.size));
+    return true;
+  }
+
+  void append_default() override { col_->Append(std::string_view()); }
+
+ private:
+  std::shared_ptr<ColumnString> col_;
+};
+
+class DateAppender : public RowAppender {
+ public:
+  DateAppender(ColumnRef col, const RowAtoms &atoms, size_t rows)
+      : data_(col->As<ColumnDate>()->GetWritableData()), atoms_(atoms) {
+    data_.reserve(data_.size() + rows);
+  }
+
+  bool append(ErlNifEnv *env, ERL_NIF_TERM term) override {
+    int64_t days;
+    if (!enif_get_int64(env, term, &days) && !decode_date(env, term, atoms_, days)) {
+      return false;
+    }
+    if (days < 0 || days > std::numeric_limits<uint16_t>::max()) {
+      return false;
+    }
+    data_.push_back(static_cast<uint16_t>(days));
+    return true;
+  }
+
+  void append_default() override { data_.push_back(0); }
+
+ private:
+  std::vector<uint16_t> &data_;
+  const RowAtoms &atoms_;
+};
+
+class DateTimeAppender : public RowAppender {
+ public:
+  DateTimeAppender(ColumnRef col, const RowAtoms &atoms, size_t rows)
+      : data_(col->As<ColumnDateTime>()->GetWritableData()), atoms_(atoms) {
+    data_.reserve(data_.size() + rows);
+  }
+
+  bool append(ErlNifEnv *env, ERL_NIF_TERM term) override {
+    int64_t seconds, micros;
+    if (!enif_get_int64(env, term, &seconds) &&
+        !decode_datetime(env, term, atoms_, seconds, micros)) {
+      return false;
+    }
+    if (seconds < 0 || seconds > std::numeric_limits<uint32_t>::max()) {
+      return false;
+    }
+    data_.push_back(static_cast<uint32_t>(seconds));
+    return true;
+  }
+
+  void append_default() override { data_.push_back(0); }
+
+ private:
+  std::vector<uint32_t> &data_;
+  const RowAtoms &atoms_;
+};
+
+// Integers are taken as ticks at the column's precision, like
+// column_datetime64_append_bulk; DateTime structs are scaled to it.
+class DateTime64Appender : public RowAppender {
+ public:
+  DateTime64Appender(ColumnRef col, const RowAtoms &atoms)
+      : col_(col->As<ColumnDateTime64>()), atoms_(atoms) {
+    size_t precision = col_->GetPrecision();
+    for (size_t i = 0; i < precision; i++) {
+      ticks_per_second_ *= 10;
+    }
+  }
+
+  bool append(ErlNifEnv *env, ERL_NIF_TERM term) override {
+    int64_t ticks;
+    if (!enif_get_int64(env, term, &ticks)) {
+      int64_t seconds, micros;
+      if (!decode_datetime(env, term, atoms_, seconds, micros)) {
+        return false;
+      }
+      ticks = seconds * ticks_per_second_;
+      ticks += ticks_per_second_ >= 1000000 ? micros * (ticks_per_second_ / 1000000)
+                                            : micros / (1000000 / ticks_per_second_);
+    }
+    col_->Append(ticks);
+    return true;
+  }
+
+  void append_default() override { col_->Append(int64_t{0}); }
+
+ private:
+  std::shared_ptr<ColumnDateTime64> col_;
+  const RowAtoms &atoms_;
+  int64_t ticks_per_second_ = 1;
+};
+
+// Accepts a 16-byte binary or the 36-character hyphenated text form
+class UUIDAppender : public RowAppender {
+ public:
+  explicit UUIDAppender(ColumnRef col) : col_(col->As<ColumnUUID>()) {}
+
+  bool append(ErlNifEnv *env, ERL_NIF_TERM term) override {
+    ErlNifBinary bin;
+    if (!enif_inspect_binary(env, term, &bin)) {
+      return false;
+    }
+
+    uint64_t halves[2] = {0, 0};
+    if (bin.size == 16) {
+      for (size_t i = 0; i < 16; i++) {
+        halves[i / 8] = (halves[i / 8] << 8) | bin.data[i];
+      }
+    } else {
+      size_t digits = 0;
+      for (size_t i = 0; i < bin.size; i++) {
+        unsigned char c = bin.data[i];
+        if (c == '-') {
+          continue;
+        }
+        int nibble = hex_value(c);
+        if (nibble < 0 || digits >= 32) {
+          return false;
+        }
+        halves[digits / 16] = (halves[digits / 16] << 4) | static_cast<uint64_t>(nibble);
+        digits++;
+      }
+      if (digits != 32) {
+        return false;
+      }
+    }
+
+    col_->Append(UUID{halves[0], halves[1]});
+    return true;
+  }
+
+  void append_default() override { col_->Append(UUID{0, 0}); }
+
+ private:
+  static int hex_value(unsigned char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+  }
+
+  std::shared_ptr<ColumnUUID> col_;
+};
+
+// Enum names (binaries or atoms) or item values, mapped once per column
+template <typename T>
+class EnumAppender : public RowAppender {
+ public:
+  explicit EnumAppender(ColumnRef col)
+      : col_(col->As<ColumnEnum<T>>()),
+        values_(col->Type()),
+        first_(static_cast<T>(EnumType(col->Type()).BeginValueToName()->first)) {}
+
+  bool append(ErlNifEnv *env, ERL_NIF_TERM term) override {
+    int16_t value;
+    if (!values_.decode(env, term, value)) {
+      return false;
+    }
+    col_->Append(static_cast<T>(value));
+    return true;
+  }
+
+  // 0 need not be an item; Nullable(Enum) NULL slots hold the first one
+  void append_default() override { col_->Append(first_); }
+
+ private:
+  std::shared_ptr<ColumnEnum<T>> col_;
+  EnumValues values_;
+  T first_;
+};
+
+class NullableAppender : public RowAppender {
+ public:
+  NullableAppender(std::unique_ptr<RowAppender> nested, ColumnRef nulls, const RowAtoms &atoms, size_t rows)
+      : nested_(std::move(nested)),
+        nulls_(nulls->As<ColumnUInt8>()->GetWritableData()),
+        atoms_(atoms) {
+    nulls_.reserve(nulls_.size() + rows);
+  }
+
+  bool append(ErlNifEnv *env, ERL_NIF_TERM term) override {
+    if (enif_is_identical(term, atoms_.nil)) {
+      append_default();
+      return true;
+    }
+    if (!nested_->append(env, term)) {
+      return false;
+    }
+    nulls_.push_back(0);
+    return true;
+  }
+
+  void append_default() override {
+    nested_->append_default();
+    nulls_.push_back(1);
+  }
+
+ private:
+  std::unique_ptr<RowAppender> nested_;
+  std::vector<uint8_t> &nulls_;
+  const RowAtoms &atoms_;
+};
+
+// Picks the appender for a column from its type code; nullptr if the type
+// has no native row path
+static std::unique_ptr<RowAppender> make_row_appender(ColumnRef col, const RowAtoms &atoms, size_t rows) {
+  switch (col->GetType().GetCode()) {
+  case Type::UInt64: return std::make_unique<IntegerAppender<uint64_t>>(col, atoms, rows);
+  case Type::UInt32: return std::make_unique<IntegerAppender<uint32_t>>(col, atoms, rows);
+  case Type::UInt16: return std::make_unique<IntegerAppender<uint16_t>>(col, atoms, rows);
+  case Type::UInt8: return std::make_unique<IntegerAppender<uint8_t>>(col, atoms, rows);
+  case Type::Int64: return std::make_unique<IntegerAppender<int64_t>>(col, atoms, rows);
+  case Type::Int32: return std::make_unique<IntegerAppender<int32_t>>(col, atoms, rows);
+  case Type::Int16: return std::make_unique<IntegerAppender<int16_t>>(col, atoms, rows);
+  case Type::Int8: return std::make_unique<IntegerAppender<int8_t>>(col, atoms, rows);
+  case Type::Float64: return std::make_unique<FloatAppender<double>>(col, rows);
+  case Type::Float32: return std::make_unique<FloatAppender<float>>(col, rows);
+  case Type::String: return std::make_unique<StringAppender>(col);
+  case Type::Date: return std::make_unique<DateAppender>(col, atoms, rows);
+  case Type::DateTime: return std::make_unique<DateTimeAppender>(col, atoms, rows);
+  case Type::DateTime64: return std::make_unique<DateTime64Appender>(col, atoms);
+  case Type::UUID: return std::make_unique<UUIDAppender>(col);
+  case Type::Enum8: return std::make_unique<EnumAppender<int8_t>>(col);
+  case Type::Enum16: return std::make_unique<EnumAppender<int16_t>>(col);
+  case Type::Nullable: {
+    auto nullable = col->As<ColumnNullable>();
+    auto nested = make_row_appender(nullable->Nested(), atoms, rows);
+    if (!nested) {
+      return nullptr;
+    }
+    return std::make_unique<NullableAppender>(std::move(nested), nullable->Nulls(), atoms, rows);
+  }
+  default:
+    return nullptr;
+  }
+}
+
+struct RowColumn {
+  std::string name;
+  ERL_NIF_TERM atom_key;
+  ERL_NIF_TERM string_key;
+  size_t position;
+  ColumnRef column;
+  std::unique_ptr<RowAppender> appender;
+};
+
+// Build a Block from a list of rows in one pass.
+//
+// `columns` is a list of {name, position, clickhouse_type}; position is the
+// column's index in the schema and in a tuple row. `prebuilt` lists columns
+// already built from the same rows (types without a row appender) as
+// {name, position, column}. The block holds both in position order. `arity`
+// is the expected tuple size. Map rows are looked up by atom key first, then
+// by string key.
+fine::ResourcePtr<BlockResource> block_from_rows(
+    ErlNifEnv *env,
+    fine::Term rows,
+    std::vector<std::tuple<fine::Atom, uint64_t, std::string>> columns,
+    std::vector<std::tuple<fine::Atom, uint64_t, fine::ResourcePtr<ColumnResource>>> prebuilt,
+    uint64_t arity) {
+  try {
+    unsigned row_count;
+    if (!enif_get_list_length(env, rows, &row_count)) {
+      throw ValidationError("rows must be a list");
+    }
+
+    RowAtoms atoms(env);
+    std::vector<RowColumn> targets;
+    targets.reserve(columns.size());
+    for (const auto &[name, position, type_name] : columns) {
+      RowColumn target;
+      target.name = name.to_string();
+      target.atom_key = enif_make_atom_len(env, target.name.data(), target.name.size());
+      target.string_key = StringTermBuilder::make_heap_binary(env, target.name);
+      target.position = position;
+      target.column = CreateColumnByType(type_name);
+      if (!target.column) {
+        throw ValidationError("failed to create column of type: " + type_name);
+      }
+      target.appender = make_row_appender(target.column, atoms, row_count);
+      if (!target.appender) {
+        throw ValidationError("column " + target.name + " of type " + type_name +
+                              " cannot be built from rows natively");
+      }
+      targets.push_back(std::move(target));
+    }
+
+    ERL_NIF_TERM list = rows;
+    ERL_NIF_TERM row;
+    size_t index = 0;
+    while (enif_get_list_cell(env, list, &row, &list)) {
+      const ERL_NIF_TERM *elements = nullptr;
+      int tuple_arity = 0;
+      bool is_map = enif_is_map(env, row);
+      if (!is_map) {
+        if (!enif_get_tuple(env, row, &tuple_arity, &elements)) {
+          throw ValidationError("row " + std::to_string(index) + " is not a map or tuple");
+        }
+        if (static_cast<uint64_t>(tuple_arity) != arity) {
+          throw ValidationError("row " + std::to_string(index) + " has " +
+                                std::to_string(tuple_arity) + " elements, expected " +
+                                std::to_string(arity));
+        }
+      }
+
+      for (auto &target : targets) {
+        ERL_NIF_TERM cell;
+        if (is_map) {
+          if (!enif_get_map_value(env, row, target.atom_key, &cell) &&
+              !enif_get_map_value(env, row, target.string_key, &cell)) {
+            throw ValidationError("row " + std::to_string(index) + " is missing column " +
+                                  target.name);
+          }
+        } else {
+          cell = elements[target.position];
+        }
+
+        if (!target.appender->append(env, cell)) {
+          throw ValidationError("invalid value for column " + target.name + " (" +
+                                target.column->GetType().GetName() + ") at row " +
+                                std::to_string(index));
+        }
+      }
+      index++;
+    }
+
+    std::vector<std::tuple<uint64_t, std::string, ColumnRef>> ordered;
+    ordered.reserve(targets.size() + prebuilt.size());
+    for (auto &target : targets) {
+      ordered.emplace_back(target.position, target.name, target.column);
+    }
+    for (const auto &[name, position, col_res] : prebuilt) {
+      ordered.emplace_back(position, name.to_string(), col_res->ptr);
+    }
+    std::sort(ordered.begin(), ordered.end(), [](const auto &a, const auto &b) {
+      return std::get<0>(a) < std::get<0>(b);
+    });
+
+    auto block = std::make_shared<Block>();
+    for (const auto &[position, name, column] : ordered) {
+      block->AppendColumn(name, column);
+    }
+    return fine::make_resource<BlockResource>(block);
+  } catch (const std::exception& e) {
+    throw std::runtime_error(encode_clickhouse_error(e));
+  }
+}
+FINE_NIF(block_from_rows, NATCH_DIRTY_CPU);
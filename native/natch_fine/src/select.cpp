@@ -13,695 +13,63 @@
 #include <clickhouse/columns/lowcardinality.h>
 #include <clickhouse/columns/enum.h>
 #include <clickhouse/types/types.h>
+#include <clickhouse/exceptions.h>
+#include <exception>
 #include <string>
 #include <vector>
 #include <memory>
 #include <sstream>
 #include <iomanip>
+#include "async.h"
+#include "client_resource.h"
+#include "column_helpers.h"
+#include "conversion_plan.h"
+#include "enum_terms.h"
+#include "error_encoding.h"
+#include "nif_flags.h"
+#include "parallel_convert.h"
+#include "row_terms.h"
 
 using namespace clickhouse;
 
-// Forward declaration
-ERL_NIF_TERM column_to_elixir_list(ErlNifEnv *env, ColumnRef col);
-
-// Helper to format UUID to string (much faster than ostringstream)
-inline void format_uuid_to_buffer(const UUID& uuid, char* buffer) {
-  uint64_t high = uuid.first;
-  uint64_t low = uuid.second;
-  snprintf(buffer, 37,  // 36 chars + null terminator
-           "%08llx-%04llx-%04llx-%04llx-%012llx",
-           (unsigned long long)((high >> 32) & 0xFFFFFFFF),
-           (unsigned long long)((high >> 16) & 0xFFFF),
-           (unsigned long long)(high & 0xFFFF),
-           (unsigned long long)((low >> 48) & 0xFFFF),
-           (unsigned long long)(low & 0xFFFFFFFFFFFF));
-}
-
-// Helper to recursively convert a column to an Elixir list
-// This handles all column types including nested arrays
-ERL_NIF_TERM column_to_elixir_list(ErlNifEnv *env, ColumnRef col) {
-  size_t count = col->Size();
-  std::vector<ERL_NIF_TERM> values;
-  values.reserve(count);
-
-  // Optimized: Use Type::Code for O(1) type dispatch instead of cascade of As<T>() calls
-  Type::Code type_code = col->GetType().GetCode();
-
-  switch (type_code) {
-  case Type::UInt64: {
-    auto uint64_col = col->As<ColumnUInt64>();
-    for (size_t i = 0; i < count; i++) {
-      values.push_back(enif_make_uint64(env, uint64_col->At(i)));
-    }
-    break;
-  }
-  case Type::UInt32: {
-    auto uint32_col = col->As<ColumnUInt32>();
-    for (size_t i = 0; i < count; i++) {
-      values.push_back(enif_make_uint64(env, uint32_col->At(i)));
-    }
-    break;
-  }
-  case Type::UInt16: {
-    auto uint16_col = col->As<ColumnUInt16>();
-    for (size_t i = 0; i < count; i++) {
-      values.push_back(enif_make_uint64(env, uint16_col->At(i)));
-    }
-    break;
-  }
-  case Type::UInt8: {
-    auto uint8_col = col->As<ColumnUInt8>();
-    for (size_t i = 0; i < count; i++) {
-      values.push_back(enif_make_uint64(env, uint8_col->At(i)));
-    }
-    break;
-  }
-  case Type::Int64: {
-    auto int64_col = col->As<ColumnInt64>();
-    for (size_t i = 0; i < count; i++) {
-      values.push_back(enif_make_int64(env, int64_col->At(i)));
-    }
-    break;
-  }
-  case Type::Int32: {
-    auto int32_col = col->As<ColumnInt32>();
-    for (size_t i = 0; i < count; i++) {
-      values.push_back(enif_make_int64(env, int32_col->At(i)));
-    }
-    break;
-  }
-  case Type::Int16: {
-    auto int16_col = col->As<ColumnInt16>();
-    for (size_t i = 0; i < count; i++) {
-      values.push_back(enif_make_int64(env, int16_col->At(i)));
-    }
-    break;
-  }
-  case Type::Int8: {
-    auto int8_col = col->As<ColumnInt8>();
-    for (size_t i = 0; i < count; i++) {
-      values.push_back(enif_make_int64(env, int8_col->At(i)));
-    }
-    break;
-  }
-  case Type::Float64: {
-    auto float64_col = col->As<ColumnFloat64>();
-    for (size_t i = 0; i < count; i++) {
-      values.push_back(enif_make_double(env, float64_col->At(i)));
-    }
-    break;
-  }
-  case Type::Float32: {
-    auto float32_col = col->As<ColumnFloat32>();
-    for (size_t i = 0; i < count; i++) {
-      values.push_back(enif_make_double(env, float32_col->At(i)));
-    }
-    break;
-  }
-  case Type::String: {
-    auto string_col = col->As<ColumnString>();
-    for (size_t i = 0; i < count; i++) {
-      std::string_view val_view = string_col->At(i);
-      ErlNifBinary bin;
-      enif_alloc_binary(val_view.size(), &bin);
-      std::memcpy(bin.data, val_view.data(), val_view.size());
-      values.push_back(enif_make_binary(env, &bin));
-    }
-    break;
-  }
-  case Type::DateTime: {
-    auto datetime_col = col->As<ColumnDateTime>();
-    for (size_t i = 0; i < count; i++) {
-      values.push_back(enif_make_uint64(env, datetime_col->At(i)));
-    }
-    break;
-  }
-  case Type::DateTime64: {
-    auto datetime64_col = col->As<ColumnDateTime64>();
-    for (size_t i = 0; i < count; i++) {
-      values.push_back(enif_make_int64(env, datetime64_col->At(i)));
-    }
-    break;
-  }
-  case Type::Date: {
-    auto date_col = col->As<ColumnDate>();
-    for (size_t i = 0; i < count; i++) {
-      values.push_back(enif_make_uint64(env, date_col->RawAt(i)));
-    }
-    break;
-  }
-  case Type::UUID: {
-    auto uuid_col = col->As<ColumnUUID>();
-    for (size_t i = 0; i < count; i++) {
-      UUID uuid = uuid_col->At(i);
-      char uuid_buf[37];
-      format_uuid_to_buffer(uuid, uuid_buf);
-      ErlNifBinary bin;
-      enif_alloc_binary(36, &bin);
-      std::memcpy(bin.data, uuid_buf, 36);
-      values.push_back(enif_make_binary(env, &bin));
-    }
-    break;
-  }
-  case Type::Decimal:
-  case Type::Decimal32:
-  case Type::Decimal64:
-  case Type::Decimal128: {
-    auto decimal_col = col->As<ColumnDecimal>();
-    for (size_t i = 0; i < count; i++) {
-      Int128 value = decimal_col->At(i);
-      int64_t scaled_value = static_cast<int64_t>(value);
-      values.push_back(enif_make_int64(env, scaled_value));
-    }
-    break;
-  }
-  case Type::Array: {
-    auto array_col = col->As<ColumnArray>();
-    // Recursively handle nested arrays
-    for (size_t i = 0; i < count; i++) {
-      auto nested = array_col->GetAsColumn(i);
-      values.push_back(column_to_elixir_list(env, nested));
-    }
-    break;
-  }
-  case Type::Tuple: {
-    auto tuple_col = col->As<ColumnTuple>();
-    // Handle tuple columns - return Elixir tuples
-    size_t tuple_size = tuple_col->TupleSize();
-
-    // Optimized: Pre-convert each element column ONCE, then index directly
-    std::vector<std::vector<ERL_NIF_TERM>> element_columns;
-    element_columns.reserve(tuple_size);
-
-    for (size_t j = 0; j < tuple_size; j++) {
-      auto element_col = tuple_col->At(j);
-      // Convert entire element column to Elixir list, then extract to vector
-      ERL_NIF_TERM elem_list = column_to_elixir_list(env, element_col);
-      std::vector<ERL_NIF_TERM> elem_vec;
-      elem_vec.reserve(count);
-      ERL_NIF_TERM tail = elem_list;
-      for (size_t i = 0; i < count; i++) {
-        ERL_NIF_TERM head;
-        if (enif_get_list_cell(env, tail, &head, &tail)) {
-          elem_vec.push_back(head);
-        } else {
-          elem_vec.push_back(enif_make_atom(env, "error"));
-        }
-      }
-      element_columns.push_back(std::move(elem_vec));
-    }
-
-    // Now build tuples by indexing pre-converted columns
-    for (size_t i = 0; i < count; i++) {
-      std::vector<ERL_NIF_TERM> tuple_elements;
-      tuple_elements.reserve(tuple_size);
-      for (size_t j = 0; j < tuple_size; j++) {
-        tuple_elements.push_back(element_columns[j][i]);
-      }
-      values.push_back(enif_make_tuple_from_array(env, tuple_elements.data(), tuple_elements.size()));
-    }
-    break;
-  }
-  case Type::Map: {
-    auto map_col = col->As<ColumnMap>();
-    // Handle map columns - return Elixir maps
-    // Map is stored as Array(Tuple(K, V)) where Tuple is columnar
-    for (size_t i = 0; i < count; i++) {
-      // Get the i-th map's tuples as a ColumnTuple
-      auto kv_tuples = map_col->GetAsColumn(i);
-
-      // This is a ColumnTuple with 2 columns: keys and values
-      if (auto tuple_col = kv_tuples->As<ColumnTuple>()) {
-        // Get the keys and values columns
-        auto keys_col = tuple_col->At(0);
-        auto values_col = tuple_col->At(1);
-
-        // The number of key-value pairs is the size of the keys/values columns
-        size_t map_size = keys_col->Size();
-
-        // Optimized: Convert columns to vectors directly, then build map in O(M)
-        std::vector<ERL_NIF_TERM> key_terms;
-        std::vector<ERL_NIF_TERM> value_terms;
-        key_terms.reserve(map_size);
-        value_terms.reserve(map_size);
-
-        // Convert keys column to vector
-        ERL_NIF_TERM keys_list = column_to_elixir_list(env, keys_col);
-        ERL_NIF_TERM key_tail = keys_list;
-        for (size_t j = 0; j < map_size; j++) {
-          ERL_NIF_TERM key;
-          if (enif_get_list_cell(env, key_tail, &key, &key_tail)) {
-            key_terms.push_back(key);
-          }
-        }
-
-        // Convert values column to vector
-        ERL_NIF_TERM values_list = column_to_elixir_list(env, values_col);
-        ERL_NIF_TERM value_tail = values_list;
-        for (size_t j = 0; j < map_size; j++) {
-          ERL_NIF_TERM value;
-          if (enif_get_list_cell(env, value_tail, &value, &value_tail)) {
-            value_terms.push_back(value);
-          }
-        }
-
-        // Build map in O(M) with enif_make_map_from_arrays
-        ERL_NIF_TERM elixir_map;
-        enif_make_map_from_arrays(env, key_terms.data(), value_terms.data(), map_size, &elixir_map);
-
-        values.push_back(elixir_map);
-      } else {
-        // Fallback for unexpected structure
-        values.push_back(enif_make_new_map(env));
-      }
-    }
-    break;
-  }
-  case Type::Enum8: {
-    auto enum8_col = col->As<ColumnEnum8>();
-    // Handle Enum8 columns - return string names
-    for (size_t i = 0; i < count; i++) {
-      std::string_view name = enum8_col->NameAt(i);
-      ErlNifBinary bin;
-      enif_alloc_binary(name.size(), &bin);
-      std::memcpy(bin.data, name.data(), name.size());
-      values.push_back(enif_make_binary(env, &bin));
-    }
-    break;
-  }
-  case Type::Enum16: {
-    auto enum16_col = col->As<ColumnEnum16>();
-    // Handle Enum16 columns - return string names
-    for (size_t i = 0; i < count; i++) {
-      std::string_view name = enum16_col->NameAt(i);
-      ErlNifBinary bin;
-      enif_alloc_binary(name.size(), &bin);
-      std::memcpy(bin.data, name.data(), name.size());
-      values.push_back(enif_make_binary(env, &bin));
-    }
-    break;
-  }
-  case Type::LowCardinality: {
-    auto lc_col = col->As<ColumnLowCardinality>();
-    // Handle LowCardinality columns - decode values from dictionary
-    // For each row, get the decoded value by calling GetItem
-    // GetItem internally looks up the dictionary index and returns the value
-    for (size_t i = 0; i < count; i++) {
-      auto item = lc_col->GetItem(i);
-
-      // Convert ItemView to Elixir term based on type
-      if (item.type == Type::String) {
-        auto val = item.get<std::string_view>();
-        ErlNifBinary bin;
-        enif_alloc_binary(val.size(), &bin);
-        std::memcpy(bin.data, val.data(), val.size());
-        values.push_back(enif_make_binary(env, &bin));
-      } else if (item.type == Type::Void) {
-        // Null value
-        values.push_back(enif_make_atom(env, "nil"));
-      } else {
-        // For other types, would need more handling
-        // For now, throw an error
-        throw std::runtime_error("Unsupported LowCardinality inner type");
-      }
-    }
-    break;
-  }
-  case Type::Nullable: {
-    auto nullable_col = col->As<ColumnNullable>();
-    auto nested = nullable_col->Nested();
-
-    // Optimized: Check nested type ONCE outside loop, then direct extraction
-    if (auto uint64_col = nested->As<ColumnUInt64>()) {
-      for (size_t i = 0; i < count; i++) {
-        if (nullable_col->IsNull(i)) {
-          values.push_back(enif_make_atom(env, "nil"));
-        } else {
-          values.push_back(enif_make_uint64(env, uint64_col->At(i)));
-        }
-      }
-    } else if (auto int64_col = nested->As<ColumnInt64>()) {
-      for (size_t i = 0; i < count; i++) {
-        if (nullable_col->IsNull(i)) {
-          values.push_back(enif_make_atom(env, "nil"));
-        } else {
-          values.push_back(enif_make_int64(env, int64_col->At(i)));
-        }
-      }
-    } else if (auto float64_col = nested->As<ColumnFloat64>()) {
-      for (size_t i = 0; i < count; i++) {
-        if (nullable_col->IsNull(i)) {
-          values.push_back(enif_make_atom(env, "nil"));
-        } else {
-          values.push_back(enif_make_double(env, float64_col->At(i)));
-        }
-      }
-    } else if (auto string_col = nested->As<ColumnString>()) {
-      for (size_t i = 0; i < count; i++) {
-        if (nullable_col->IsNull(i)) {
-          values.push_back(enif_make_atom(env, "nil"));
-        } else {
-          std::string_view val_view = string_col->At(i);
-          ErlNifBinary bin;
-          enif_alloc_binary(val_view.size(), &bin);
-          std::memcpy(bin.data, val_view.data(), val_view.size());
-          values.push_back(enif_make_binary(env, &bin));
-        }
-      }
-    } else {
-      // Fallback for complex/uncommon types: use Slice approach
-      for (size_t i = 0; i < count; i++) {
-        if (nullable_col->IsNull(i)) {
-          values.push_back(enif_make_atom(env, "nil"));
-        } else {
-          auto single_value_col = nested->Slice(i, 1);
-          ERL_NIF_TERM elem_list = column_to_elixir_list(env, single_value_col);
-          ERL_NIF_TERM head, tail;
-          if (enif_get_list_cell(env, elem_list, &head, &tail)) {
-            values.push_back(head);
-          } else {
-            values.push_back(enif_make_atom(env, "error"));
-          }
-        }
-      }
-    }
-    break;
-  }
-  default:
-    // Unsupported or unknown type
-    throw std::runtime_error("Unsupported column type in column_to_elixir_list");
-  }
-
-  return enif_make_list_from_array(env, values.data(), values.size());
-}
-
-// Helper to convert Block to maps and append to output vector
-void block_to_maps_impl(ErlNifEnv *env, std::shared_ptr<Block> block, std::vector<ERL_NIF_TERM>& out_maps) {
-  size_t col_count = block->GetColumnCount();
-  size_t row_count = block->GetRowCount();
+// Convert a Block to one row term per row with `plan` and append them to the
+// output vector. `row_from_values(values)` builds a row from its column
+// values.
+template <typename RowFromValues>
+static void block_to_rows_impl(ErlNifEnv *env, const ConversionPlan &plan, const Block &block,
+                               RowFromValues row_from_values, std::vector<ERL_NIF_TERM> &out_rows) {
+  size_t col_count = block.GetColumnCount();
+  size_t row_count = block.GetRowCount();
 
   if (row_count == 0) {
     return;  // Nothing to add
   }
 
-  // Extract column names and data
-  std::vector<std::string> col_names;
-  std::vector<std::vector<ERL_NIF_TERM>> col_data;
-
-  for (size_t c = 0; c < col_count; c++) {
-    col_names.push_back(block->GetColumnName(c));
-
-    ColumnRef col = (*block)[c];
-    std::vector<ERL_NIF_TERM> column_values;
-    column_values.reserve(row_count);
+  // Convert every column once, in parallel for large blocks
+  std::vector<std::vector<ERL_NIF_TERM>> col_data(col_count);
+  convert_block_columns(env, plan, block, col_data);
 
-    // Extract column data based on type
-    if (auto uint64_col = col->As<ColumnUInt64>()) {
-      for (size_t i = 0; i < row_count; i++) {
-        column_values.push_back(enif_make_uint64(env, uint64_col->At(i)));
-      }
-    } else if (auto uint32_col = col->As<ColumnUInt32>()) {
-      for (size_t i = 0; i < row_count; i++) {
-        column_values.push_back(enif_make_uint64(env, uint32_col->At(i)));
-      }
-    } else if (auto uint16_col = col->As<ColumnUInt16>()) {
-      for (size_t i = 0; i < row_count; i++) {
-        column_values.push_back(enif_make_uint64(env, uint16_col->At(i)));
-      }
-    } else if (auto uint8_col = col->As<ColumnUInt8>()) {
-      for (size_t i = 0; i < row_count; i++) {
-        column_values.push_back(enif_make_uint64(env, uint8_col->At(i)));
-      }
-    } else if (auto int64_col = col->As<ColumnInt64>()) {
-      for (size_t i = 0; i < row_count; i++) {
-        column_values.push_back(enif_make_int64(env, int64_col->At(i)));
-      }
-    } else if (auto int32_col = col->As<ColumnInt32>()) {
-      for (size_t i = 0; i < row_count; i++) {
-        column_values.push_back(enif_make_int64(env, int32_col->At(i)));
-      }
-    } else if (auto int16_col = col->As<ColumnInt16>()) {
-      for (size_t i = 0; i < row_count; i++) {
-        column_values.push_back(enif_make_int64(env, int16_col->At(i)));
-      }
-    } else if (auto int8_col = col->As<ColumnInt8>()) {
-      for (size_t i = 0; i < row_count; i++) {
-        column_values.push_back(enif_make_int64(env, int8_col->At(i)));
-      }
-    } else if (auto float64_col = col->As<ColumnFloat64>()) {
-      for (size_t i = 0; i < row_count; i++) {
-        column_values.push_back(enif_make_double(env, float64_col->At(i)));
-      }
-    } else if (auto float32_col = col->As<ColumnFloat32>()) {
-      for (size_t i = 0; i < row_count; i++) {
-        column_values.push_back(enif_make_double(env, float32_col->At(i)));
-      }
-    } else if (auto string_col = col->As<ColumnString>()) {
-      for (size_t i = 0; i < row_count; i++) {
-        std::string_view val_view = string_col->At(i);
-        ErlNifBinary bin;
-        enif_alloc_binary(val_view.size(), &bin);
-        std::memcpy(bin.data, val_view.data(), val_view.size());
-        column_values.push_back(enif_make_binary(env, &bin));
-      }
-    } else if (auto datetime_col = col->As<ColumnDateTime>()) {
-      for (size_t i = 0; i < row_count; i++) {
-        column_values.push_back(enif_make_uint64(env, datetime_col->At(i)));
-      }
-    } else if (auto datetime64_col = col->As<ColumnDateTime64>()) {
-      for (size_t i = 0; i < row_count; i++) {
-        column_values.push_back(enif_make_int64(env, datetime64_col->At(i)));
-      }
-    } else if (auto date_col = col->As<ColumnDate>()) {
-      for (size_t i = 0; i < row_count; i++) {
-        column_values.push_back(enif_make_uint64(env, date_col->RawAt(i)));
-      }
-    } else if (auto uuid_col = col->As<ColumnUUID>()) {
-      for (size_t i = 0; i < row_count; i++) {
-        UUID uuid = uuid_col->At(i);
-        char uuid_buf[37];
-        format_uuid_to_buffer(uuid, uuid_buf);
-        ErlNifBinary bin;
-        enif_alloc_binary(36, &bin);
-        std::memcpy(bin.data, uuid_buf, 36);
-        column_values.push_back(enif_make_binary(env, &bin));
-      }
-    } else if (auto decimal_col = col->As<ColumnDecimal>()) {
-      for (size_t i = 0; i < row_count; i++) {
-        Int128 value = decimal_col->At(i);
-        // Convert Int128 to int64 for Elixir (assumes value fits in int64)
-        // Elixir will convert back to Decimal by dividing by 10^scale
-        int64_t scaled_value = static_cast<int64_t>(value);
-        column_values.push_back(enif_make_int64(env, scaled_value));
-      }
-    } else if (auto array_col = col->As<ColumnArray>()) {
-      // Handle array columns - recursively converts nested arrays to Elixir lists
-      for (size_t i = 0; i < row_count; i++) {
-        auto nested = array_col->GetAsColumn(i);
-        column_values.push_back(column_to_elixir_list(env, nested));
-      }
-    } else if (auto map_col = col->As<ColumnMap>()) {
-      // Handle map columns - use column_to_elixir_list for complex nested structure
-      for (size_t i = 0; i < row_count; i++) {
-        auto kv_tuples = map_col->GetAsColumn(i);
-
-        if (auto tuple_col = kv_tuples->As<ColumnTuple>()) {
-          auto keys_col = tuple_col->At(0);
-          auto values_col = tuple_col->At(1);
-          size_t map_size = keys_col->Size();
-
-          // Optimized: Convert columns to vectors directly, then build map in O(M)
-          std::vector<ERL_NIF_TERM> key_terms;
-          std::vector<ERL_NIF_TERM> value_terms;
-          key_terms.reserve(map_size);
-          value_terms.reserve(map_size);
-
-          // Convert keys column to vector
-          ERL_NIF_TERM keys_list = column_to_elixir_list(env, keys_col);
-          ERL_NIF_TERM key_tail = keys_list;
-          for (size_t j = 0; j < map_size; j++) {
-            ERL_NIF_TERM key;
-            if (enif_get_list_cell(env, key_tail, &key, &key_tail)) {
-              key_terms.push_back(key);
-            }
-          }
-
-          // Convert values column to vector
-          ERL_NIF_TERM values_list = column_to_elixir_list(env, values_col);
-          ERL_NIF_TERM value_tail = values_list;
-          for (size_t j = 0; j < map_size; j++) {
-            ERL_NIF_TERM value;
-            if (enif_get_list_cell(env, value_tail, &value, &value_tail)) {
-              value_terms.push_back(value);
-            }
-          }
-
-          // Build map in O(M) with enif_make_map_from_arrays
-          ERL_NIF_TERM elixir_map;
-          enif_make_map_from_arrays(env, key_terms.data(), value_terms.data(), map_size, &elixir_map);
-
-          column_values.push_back(elixir_map);
-        } else {
-          column_values.push_back(enif_make_new_map(env));
-        }
-      }
-    } else if (auto tuple_col = col->As<ColumnTuple>()) {
-      // Handle tuple columns - use column_to_elixir_list for complex logic
-      size_t tuple_size = tuple_col->TupleSize();
-
-      // Optimized: Pre-convert each element column ONCE, then index directly
-      std::vector<std::vector<ERL_NIF_TERM>> element_columns;
-      element_columns.reserve(tuple_size);
-
-      for (size_t j = 0; j < tuple_size; j++) {
-        auto element_col = tuple_col->At(j);
-        // Convert entire element column to Elixir list, then extract to vector
-        ERL_NIF_TERM elem_list = column_to_elixir_list(env, element_col);
-        std::vector<ERL_NIF_TERM> elem_vec;
-        elem_vec.reserve(row_count);
-        ERL_NIF_TERM tail = elem_list;
-        for (size_t i = 0; i < row_count; i++) {
-          ERL_NIF_TERM head;
-          if (enif_get_list_cell(env, tail, &head, &tail)) {
-            elem_vec.push_back(head);
-          } else {
-            elem_vec.push_back(enif_make_atom(env, "error"));
-          }
-        }
-        element_columns.push_back(std::move(elem_vec));
-      }
-
-      // Now build tuples by indexing pre-converted columns
-      for (size_t i = 0; i < row_count; i++) {
-        std::vector<ERL_NIF_TERM> tuple_elements;
-        tuple_elements.reserve(tuple_size);
-        for (size_t j = 0; j < tuple_size; j++) {
-          tuple_elements.push_back(element_columns[j][i]);
-        }
-        column_values.push_back(enif_make_tuple_from_array(env, tuple_elements.data(), tuple_elements.size()));
-      }
-    } else if (auto enum8_col = col->As<ColumnEnum8>()) {
-      // Handle Enum8 columns
-      for (size_t i = 0; i < row_count; i++) {
-        std::string_view name = enum8_col->NameAt(i);
-        ErlNifBinary bin;
-        enif_alloc_binary(name.size(), &bin);
-        std::memcpy(bin.data, name.data(), name.size());
-        column_values.push_back(enif_make_binary(env, &bin));
-      }
-    } else if (auto enum16_col = col->As<ColumnEnum16>()) {
-      // Handle Enum16 columns
-      for (size_t i = 0; i < row_count; i++) {
-        std::string_view name = enum16_col->NameAt(i);
-        ErlNifBinary bin;
-        enif_alloc_binary(name.size(), &bin);
-        std::memcpy(bin.data, name.data(), name.size());
-        column_values.push_back(enif_make_binary(env, &bin));
-      }
-    } else if (auto lc_col = col->As<ColumnLowCardinality>()) {
-      // Handle LowCardinality columns
-      for (size_t i = 0; i < row_count; i++) {
-        auto item = lc_col->GetItem(i);
-        if (item.type == Type::String) {
-          auto val = item.get<std::string_view>();
-          ErlNifBinary bin;
-          enif_alloc_binary(val.size(), &bin);
-          std::memcpy(bin.data, val.data(), val.size());
-          column_values.push_back(enif_make_binary(env, &bin));
-        } else if (item.type == Type::Void) {
-          column_values.push_back(enif_make_atom(env, "nil"));
-        } else {
-          throw std::runtime_error("Unsupported LowCardinality inner type");
-        }
-      }
-    } else if (auto nullable_col = col->As<ColumnNullable>()) {
-      auto nested = nullable_col->Nested();
-
-      // Optimized: Check nested type ONCE outside loop, then direct extraction
-      if (auto uint64_col = nested->As<ColumnUInt64>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          if (nullable_col->IsNull(i)) {
-            column_values.push_back(enif_make_atom(env, "nil"));
-          } else {
-            column_values.push_back(enif_make_uint64(env, uint64_col->At(i)));
-          }
-        }
-      } else if (auto int64_col = nested->As<ColumnInt64>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          if (nullable_col->IsNull(i)) {
-            column_values.push_back(enif_make_atom(env, "nil"));
-          } else {
-            column_values.push_back(enif_make_int64(env, int64_col->At(i)));
-          }
-        }
-      } else if (auto float64_col = nested->As<ColumnFloat64>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          if (nullable_col->IsNull(i)) {
-            column_values.push_back(enif_make_atom(env, "nil"));
-          } else {
-            column_values.push_back(enif_make_double(env, float64_col->At(i)));
-          }
-        }
-      } else if (auto string_col = nested->As<ColumnString>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          if (nullable_col->IsNull(i)) {
-            column_values.push_back(enif_make_atom(env, "nil"));
-          } else {
-            std::string_view val_view = string_col->At(i);
-            ErlNifBinary bin;
-            enif_alloc_binary(val_view.size(), &bin);
-            std::memcpy(bin.data, val_view.data(), val_view.size());
-            column_values.push_back(enif_make_binary(env, &bin));
-          }
-        }
-      } else {
-        // Fallback for complex/uncommon types: use Slice approach
-        for (size_t i = 0; i < row_count; i++) {
-          if (nullable_col->IsNull(i)) {
-            column_values.push_back(enif_make_atom(env, "nil"));
-          } else {
-            auto single_value_col = nested->Slice(i, 1);
-            ERL_NIF_TERM elem_list = column_to_elixir_list(env, single_value_col);
-            ERL_NIF_TERM head, tail;
-            if (enif_get_list_cell(env, elem_list, &head, &tail)) {
-              column_values.push_back(head);
-            } else {
-              column_values.push_back(enif_make_atom(env, "error"));
-            }
-          }
-        }
-      }
-    }
-
-    col_data.push_back(column_values);
-  }
-
-  // Pre-create column name atoms once (major optimization)
-  std::vector<ERL_NIF_TERM> key_atoms;
-  key_atoms.reserve(col_count);
-  for (size_t c = 0; c < col_count; c++) {
-    key_atoms.push_back(enif_make_atom(env, col_names[c].c_str()));
-  }
-
-  // Build maps in local vector first for better cache locality
-  std::vector<ERL_NIF_TERM> rows;
-  rows.reserve(row_count);
-
-  // Build maps row by row, reusing the pre-created key atoms
+  // Build rows by indexing the converted columns
+  out_rows.reserve(out_rows.size() + row_count);
+  std::vector<ERL_NIF_TERM> values(col_count);
   for (size_t r = 0; r < row_count; r++) {
-    ERL_NIF_TERM values[col_count];
-
     for (size_t c = 0; c < col_count; c++) {
       values[c] = col_data[c][r];
     }
-
-    ERL_NIF_TERM map;
-    enif_make_map_from_arrays(env, key_atoms.data(), values, col_count, &map);
-    rows.push_back(map);
+    out_rows.push_back(row_from_values(values.data()));
   }
+}
 
-  // Append all rows at once to output vector
-  out_maps.insert(out_maps.end(), rows.begin(), rows.end());
+// Helper to convert Block to maps and append to output vector
+void block_to_maps_impl(ErlNifEnv *env, const HeaderPlan &header, std::shared_ptr<Block> block,
+                        std::vector<ERL_NIF_TERM>& out_maps) {
+  if (block->GetRowCount() == 0) {
+    return;
+  }
+  const auto &key_atoms = header.names;
+  block_to_rows_impl(env, header.plan, *block, [&](const ERL_NIF_TERM *values) {
+    return make_row(env, RowFormat::Maps, key_atoms.data(), values, key_atoms.size());
+  }, out_maps);
 }
 
 // Wrapper struct to return list of maps from FINE NIF
@@ -729,58 +97,214 @@ namespace fine {
   };
 }
 
-// Execute SELECT query and return list of maps
-SelectResult client_select(
-    ErlNifEnv *env,
-    fine::ResourcePtr<Client> client,
-    std::string query) {
+// Run a SELECT and collect every block as a list of maps built in `env`.
+// Shared by the synchronous NIFs and the async worker.
+// With RowFormat::Tuples or Lists the result is {column_names, rows}, with
+// the names taken from the header block so empty results still have them.
+// The header's plan (returning enum names in `enums` format) and name atoms
+// come from `plans`.
+ERL_NIF_TERM select_rows_format_impl(ErlNifEnv *env, Client &client, Query query,
+                                     RowFormat format, EnumFormat enums, PlanCache &plans) {
+  // Collect all result rows immediately in the callback
+  std::vector<ERL_NIF_TERM> all_rows;
+  std::vector<ERL_NIF_TERM> key_atoms;
+  std::shared_ptr<const HeaderPlan> header;
+
+  query.OnData([&](const Block &block) {
+    if (!header) {
+      header = plans.get(env, block, enums);
+      key_atoms = header->names;
+    }
+    block_to_rows_impl(env, header->plan, block, [&](const ERL_NIF_TERM *values) {
+      return make_row(env, format, key_atoms.data(), values, key_atoms.size());
+    }, all_rows);
+  });
+
+  client.Select(query);
 
-  // Collect all result maps immediately in the callback
-  std::vector<ERL_NIF_TERM> all_maps;
+  ERL_NIF_TERM rows = enif_make_list_from_array(env, all_rows.data(), all_rows.size());
+  return rows_result(env, format, key_atoms, rows);
+}
 
-  client->Select(query, [&](const Block &block) {
-    // Convert this block to maps and append directly to all_maps
-    auto block_ptr = std::make_shared<Block>(block);
-    block_to_maps_impl(env, block_ptr, all_maps);
+// Run a SELECT and build each row as a struct (see StructRowBuilder). The
+// columns are resolved to struct fields once, from the header block.
+static ERL_NIF_TERM select_structs_impl(ErlNifEnv *env, Client &client, Query query,
+                                        StructRowBuilder &structs, EnumFormat enums,
+                                        PlanCache &plans) {
+  std::vector<ERL_NIF_TERM> all_rows;
+  std::shared_ptr<const HeaderPlan> header;
+  // A column that matches no field cancels the query instead of throwing
+  // from the callback, so the rest of the result is still drained and the
+  // connection stays usable. The error is rethrown once Select returns.
+  std::exception_ptr bind_error;
+
+  query.OnDataCancelable([&](const Block &block) {
+    if (!header) {
+      header = plans.get(env, block, enums);
+      try {
+        structs.bind(env, header->names);
+      } catch (...) {
+        bind_error = std::current_exception();
+      }
+    }
+    if (bind_error) {
+      return false;
+    }
+    block_to_rows_impl(env, header->plan, block, [&](const ERL_NIF_TERM *values) {
+      return structs.make(env, values);
+    }, all_rows);
+    return true;
   });
 
-  // Build final list from all maps
-  if (all_maps.empty()) {
-    return SelectResult(enif_make_list(env, 0));
+  client.Select(query);
+  if (bind_error) {
+    std::rethrow_exception(bind_error);
   }
 
-  return SelectResult(enif_make_list_from_array(env, all_maps.data(), all_maps.size()));
+  return enif_make_list_from_array(env, all_rows.data(), all_rows.size());
+}
+
+static StructRowBuilder struct_builder(
+    ErlNifEnv *env,
+    fine::Atom module,
+    const std::vector<std::tuple<fine::Atom, fine::Term>> &fields,
+    const std::vector<std::tuple<fine::Atom, fine::Atom>> &mapping) {
+  std::vector<std::pair<ERL_NIF_TERM, ERL_NIF_TERM>> field_terms;
+  for (const auto &[field, default_value] : fields) {
+    field_terms.emplace_back(fine::encode(env, field), default_value);
+  }
+  std::vector<std::pair<ERL_NIF_TERM, ERL_NIF_TERM>> mapping_terms;
+  for (const auto &[column, field] : mapping) {
+    mapping_terms.emplace_back(fine::encode(env, column), fine::encode(env, field));
+  }
+  return StructRowBuilder(env, fine::encode(env, module), field_terms, mapping_terms);
+}
+
+ERL_NIF_TERM select_rows_impl(ErlNifEnv *env, Client &client, Query query, PlanCache &plans) {
+  return select_rows_format_impl(env, client, query, RowFormat::Maps, EnumFormat::Binaries,
+                                 plans);
 }
 
-FINE_NIF(client_select, 0);
+// Execute SELECT query and return list of maps
+SelectResult client_select(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ClientResource> client,
+    std::string query) {
+  try {
+    ClientLock lock(*client);
+    return SelectResult(select_rows_impl(env, *client->ptr, Query(query), client->plans));
+  } catch (const std::exception& e) {
+    throw std::runtime_error(encode_clickhouse_error(e));
+  }
+}
+
+FINE_NIF(client_select, NATCH_DIRTY_IO);
 
 // Execute parameterized SELECT query and return list of maps
 SelectResult client_select_parameterized(
     ErlNifEnv *env,
-    fine::ResourcePtr<Client> client,
+    fine::ResourcePtr<ClientResource> client,
     fine::ResourcePtr<Query> query) {
+  try {
+    ClientLock lock(*client);
+    return SelectResult(select_rows_impl(env, *client->ptr, *query, client->plans));
+  } catch (const std::exception& e) {
+    throw std::runtime_error(encode_clickhouse_error(e));
+  }
+}
 
-  // Collect all result maps immediately in the callback
-  std::vector<ERL_NIF_TERM> all_maps;
+FINE_NIF(client_select_parameterized, NATCH_DIRTY_IO);
 
-  // Set callback on the Query object before calling Select
-  query->OnData([&](const Block &block) {
-    // Convert this block to maps and append directly to all_maps
-    auto block_ptr = std::make_shared<Block>(block);
-    block_to_maps_impl(env, block_ptr, all_maps);
-  });
+// Execute SELECT query and return rows as maps, or {column_names, rows} of
+// tuples or lists, with enum names as binaries or atoms (enum_format)
+SelectResult client_select_rows_format(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ClientResource> client,
+    std::string query,
+    fine::Atom format,
+    fine::Atom enum_format) {
+  try {
+    ClientLock lock(*client);
+    return SelectResult(select_rows_format_impl(env, *client->ptr, Query(query),
+                                                row_format_from_name(format.to_string()),
+                                                enum_format_from_name(enum_format.to_string()),
+                                                client->plans));
+  } catch (const std::exception& e) {
+    throw std::runtime_error(encode_clickhouse_error(e));
+  }
+}
 
-  client->Select(*query);
+FINE_NIF(client_select_rows_format, NATCH_DIRTY_IO);
 
-  // Build final list from all maps
-  if (all_maps.empty()) {
-    return SelectResult(enif_make_list(env, 0));
+// Parameterized variant of client_select_rows_format
+SelectResult client_select_rows_format_parameterized(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ClientResource> client,
+    fine::ResourcePtr<Query> query,
+    fine::Atom format,
+    fine::Atom enum_format) {
+  try {
+    ClientLock lock(*client);
+    return SelectResult(select_rows_format_impl(env, *client->ptr, *query,
+                                                row_format_from_name(format.to_string()),
+                                                enum_format_from_name(enum_format.to_string()),
+                                                client->plans));
+  } catch (const std::exception& e) {
+    throw std::runtime_error(encode_clickhouse_error(e));
   }
+}
 
-  return SelectResult(enif_make_list_from_array(env, all_maps.data(), all_maps.size()));
+FINE_NIF(client_select_rows_format_parameterized, NATCH_DIRTY_IO);
+
+/// Execute SELECT query and return each row as a struct
+///
+/// @param module The struct module
+/// @param fields The struct's fields with their defaults, as {field, default}
+/// @param mapping {column, field} pairs for columns named differently from
+///   their field
+/// @param enum_format :binary or :atom, how enum names are returned
+SelectResult client_select_structs(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ClientResource> client,
+    std::string query,
+    fine::Atom module,
+    std::vector<std::tuple<fine::Atom, fine::Term>> fields,
+    std::vector<std::tuple<fine::Atom, fine::Atom>> mapping,
+    fine::Atom enum_format) {
+  try {
+    ClientLock lock(*client);
+    StructRowBuilder structs = struct_builder(env, module, fields, mapping);
+    return SelectResult(select_structs_impl(env, *client->ptr, Query(query), structs,
+                                            enum_format_from_name(enum_format.to_string()),
+                                            client->plans));
+  } catch (const std::exception& e) {
+    throw std::runtime_error(encode_clickhouse_error(e));
+  }
+}
+
+FINE_NIF(client_select_structs, NATCH_DIRTY_IO);
+
+// Parameterized variant of client_select_structs
+SelectResult client_select_structs_parameterized(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ClientResource> client,
+    fine::ResourcePtr<Query> query,
+    fine::Atom module,
+    std::vector<std::tuple<fine::Atom, fine::Term>> fields,
+    std::vector<std::tuple<fine::Atom, fine::Atom>> mapping,
+    fine::Atom enum_format) {
+  try {
+    ClientLock lock(*client);
+    StructRowBuilder structs = struct_builder(env, module, fields, mapping);
+    return SelectResult(select_structs_impl(env, *client->ptr, *query, structs,
+                                            enum_format_from_name(enum_format.to_string()),
+                                            client->plans));
+  } catch (const std::exception& e) {
+    throw std::runtime_error(encode_clickhouse_error(e));
+  }
 }
 
-FINE_NIF(client_select_parameterized, 0);
+FINE_NIF(client_select_structs_parameterized, NATCH_DIRTY_IO);
 
 // Wrapper struct to return columnar map from FINE NIF
 struct ColumnarResult {
@@ -806,19 +330,18 @@ namespace fine {
   };
 }
 
-// Execute SELECT query and return columnar format: %{column_name => [values]}
-ColumnarResult client_select_cols(
-    ErlNifEnv *env,
-    fine::ResourcePtr<Client> client,
-    std::string query) {
+// Run a SELECT and collect the result as %{column_name => [values]} built in
+// `env`, with enum names in `enums` format. Shared by the synchronous NIFs
+// and the async worker.
+ERL_NIF_TERM select_cols_impl(ErlNifEnv *env, Client &client, Query query, EnumFormat enums,
+                              PlanCache &plans) {
 
   // Pre-create column structure on first block (indexed vectors for O(1) access)
-  std::vector<std::string> col_names;
   std::vector<ERL_NIF_TERM> key_atoms;
   std::vector<std::vector<ERL_NIF_TERM>> all_columns;
-  bool first_block = true;
+  std::shared_ptr<const HeaderPlan> header;
 
-  client->Select(query, [&](const Block &block) {
+  query.OnData([&](const Block &block) {
     size_t col_count = block.GetColumnCount();
     size_t row_count = block.GetRowCount();
 
@@ -827,291 +350,24 @@ ColumnarResult client_select_cols(
     }
 
     // Initialize column structure on first block
-    if (first_block) {
-      col_names.reserve(col_count);
-      key_atoms.reserve(col_count);
-      all_columns.reserve(col_count);
-
-      for (size_t c = 0; c < col_count; c++) {
-        std::string col_name = block.GetColumnName(c);
-        col_names.push_back(col_name);
-        key_atoms.push_back(enif_make_atom(env, col_name.c_str()));
-
+    if (!header) {
+      header = plans.get(env, block, enums);
+      key_atoms = header->names;
+      all_columns.resize(col_count);
+      for (auto &col_vec : all_columns) {
         // Estimate capacity: assume 10 blocks total (heuristic)
-        std::vector<ERL_NIF_TERM> col_vec;
         col_vec.reserve(row_count * 10);
-        all_columns.push_back(std::move(col_vec));
       }
-
-      first_block = false;
     }
 
-    // Extract each column's data using index-based access
-    for (size_t c = 0; c < col_count; c++) {
-      ColumnRef col = block[c];
-      std::vector<ERL_NIF_TERM> column_values;
-      column_values.reserve(row_count);
-
-      // Extract column data based on type (reuse logic from block_to_maps_impl)
-      if (auto uint64_col = col->As<ColumnUInt64>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          column_values.push_back(enif_make_uint64(env, uint64_col->At(i)));
-        }
-      } else if (auto uint32_col = col->As<ColumnUInt32>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          column_values.push_back(enif_make_uint64(env, uint32_col->At(i)));
-        }
-      } else if (auto uint16_col = col->As<ColumnUInt16>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          column_values.push_back(enif_make_uint64(env, uint16_col->At(i)));
-        }
-      } else if (auto uint8_col = col->As<ColumnUInt8>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          column_values.push_back(enif_make_uint64(env, uint8_col->At(i)));
-        }
-      } else if (auto int64_col = col->As<ColumnInt64>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          column_values.push_back(enif_make_int64(env, int64_col->At(i)));
-        }
-      } else if (auto int32_col = col->As<ColumnInt32>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          column_values.push_back(enif_make_int64(env, int32_col->At(i)));
-        }
-      } else if (auto int16_col = col->As<ColumnInt16>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          column_values.push_back(enif_make_int64(env, int16_col->At(i)));
-        }
-      } else if (auto int8_col = col->As<ColumnInt8>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          column_values.push_back(enif_make_int64(env, int8_col->At(i)));
-        }
-      } else if (auto float64_col = col->As<ColumnFloat64>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          column_values.push_back(enif_make_double(env, float64_col->At(i)));
-        }
-      } else if (auto float32_col = col->As<ColumnFloat32>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          column_values.push_back(enif_make_double(env, float32_col->At(i)));
-        }
-      } else if (auto string_col = col->As<ColumnString>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          std::string_view val_view = string_col->At(i);
-          ErlNifBinary bin;
-          enif_alloc_binary(val_view.size(), &bin);
-          std::memcpy(bin.data, val_view.data(), val_view.size());
-          column_values.push_back(enif_make_binary(env, &bin));
-        }
-      } else if (auto datetime_col = col->As<ColumnDateTime>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          column_values.push_back(enif_make_uint64(env, datetime_col->At(i)));
-        }
-      } else if (auto datetime64_col = col->As<ColumnDateTime64>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          column_values.push_back(enif_make_int64(env, datetime64_col->At(i)));
-        }
-      } else if (auto date_col = col->As<ColumnDate>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          column_values.push_back(enif_make_uint64(env, date_col->RawAt(i)));
-        }
-      } else if (auto uuid_col = col->As<ColumnUUID>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          UUID uuid = uuid_col->At(i);
-          char uuid_buf[37];
-          format_uuid_to_buffer(uuid, uuid_buf);
-          ErlNifBinary bin;
-          enif_alloc_binary(36, &bin);
-          std::memcpy(bin.data, uuid_buf, 36);
-          column_values.push_back(enif_make_binary(env, &bin));
-        }
-      } else if (auto decimal_col = col->As<ColumnDecimal>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          Int128 value = decimal_col->At(i);
-          int64_t scaled_value = static_cast<int64_t>(value);
-          column_values.push_back(enif_make_int64(env, scaled_value));
-        }
-      } else if (auto array_col = col->As<ColumnArray>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          auto nested = array_col->GetAsColumn(i);
-          column_values.push_back(column_to_elixir_list(env, nested));
-        }
-      } else if (auto map_col = col->As<ColumnMap>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          auto kv_tuples = map_col->GetAsColumn(i);
-          if (auto tuple_col = kv_tuples->As<ColumnTuple>()) {
-            auto keys_col = tuple_col->At(0);
-            auto values_col = tuple_col->At(1);
-            size_t map_size = keys_col->Size();
-
-            // Optimized: Convert columns to vectors directly, then build map in O(M)
-            std::vector<ERL_NIF_TERM> key_terms;
-            std::vector<ERL_NIF_TERM> value_terms;
-            key_terms.reserve(map_size);
-            value_terms.reserve(map_size);
-
-            // Convert keys column to vector
-            ERL_NIF_TERM keys_list = column_to_elixir_list(env, keys_col);
-            ERL_NIF_TERM key_tail = keys_list;
-            for (size_t j = 0; j < map_size; j++) {
-              ERL_NIF_TERM key;
-              if (enif_get_list_cell(env, key_tail, &key, &key_tail)) {
-                key_terms.push_back(key);
-              }
-            }
-
-            // Convert values column to vector
-            ERL_NIF_TERM values_list = column_to_elixir_list(env, values_col);
-            ERL_NIF_TERM value_tail = values_list;
-            for (size_t j = 0; j < map_size; j++) {
-              ERL_NIF_TERM value;
-              if (enif_get_list_cell(env, value_tail, &value, &value_tail)) {
-                value_terms.push_back(value);
-              }
-            }
-
-            // Build map in O(M) with enif_make_map_from_arrays
-            ERL_NIF_TERM elixir_map;
-            enif_make_map_from_arrays(env, key_terms.data(), value_terms.data(), map_size, &elixir_map);
-
-            column_values.push_back(elixir_map);
-          } else {
-            column_values.push_back(enif_make_new_map(env));
-          }
-        }
-      } else if (auto tuple_col = col->As<ColumnTuple>()) {
-        size_t tuple_size = tuple_col->TupleSize();
-
-        // Optimized: Pre-convert each element column ONCE, then index directly
-        std::vector<std::vector<ERL_NIF_TERM>> element_columns;
-        element_columns.reserve(tuple_size);
-
-        for (size_t j = 0; j < tuple_size; j++) {
-          auto element_col = tuple_col->At(j);
-          // Convert entire element column to Elixir list, then extract to vector
-          ERL_NIF_TERM elem_list = column_to_elixir_list(env, element_col);
-          std::vector<ERL_NIF_TERM> elem_vec;
-          elem_vec.reserve(row_count);
-          ERL_NIF_TERM tail = elem_list;
-          for (size_t i = 0; i < row_count; i++) {
-            ERL_NIF_TERM head;
-            if (enif_get_list_cell(env, tail, &head, &tail)) {
-              elem_vec.push_back(head);
-            } else {
-              elem_vec.push_back(enif_make_atom(env, "error"));
-            }
-          }
-          element_columns.push_back(std::move(elem_vec));
-        }
-
-        // Now build tuples by indexing pre-converted columns
-        for (size_t i = 0; i < row_count; i++) {
-          std::vector<ERL_NIF_TERM> tuple_elements;
-          tuple_elements.reserve(tuple_size);
-          for (size_t j = 0; j < tuple_size; j++) {
-            tuple_elements.push_back(element_columns[j][i]);
-          }
-          column_values.push_back(enif_make_tuple_from_array(env, tuple_elements.data(), tuple_elements.size()));
-        }
-      } else if (auto enum8_col = col->As<ColumnEnum8>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          std::string_view name = enum8_col->NameAt(i);
-          ErlNifBinary bin;
-          enif_alloc_binary(name.size(), &bin);
-          std::memcpy(bin.data, name.data(), name.size());
-          column_values.push_back(enif_make_binary(env, &bin));
-        }
-      } else if (auto enum16_col = col->As<ColumnEnum16>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          std::string_view name = enum16_col->NameAt(i);
-          ErlNifBinary bin;
-          enif_alloc_binary(name.size(), &bin);
-          std::memcpy(bin.data, name.data(), name.size());
-          column_values.push_back(enif_make_binary(env, &bin));
-        }
-      } else if (auto lc_col = col->As<ColumnLowCardinality>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          auto item = lc_col->GetItem(i);
-          if (item.type == Type::String) {
-            auto val = item.get<std::string_view>();
-            ErlNifBinary bin;
-            enif_alloc_binary(val.size(), &bin);
-            std::memcpy(bin.data, val.data(), val.size());
-            column_values.push_back(enif_make_binary(env, &bin));
-          } else if (item.type == Type::Void) {
-            column_values.push_back(enif_make_atom(env, "nil"));
-          } else {
-            throw std::runtime_error("Unsupported LowCardinality inner type");
-          }
-        }
-      } else if (auto nullable_col = col->As<ColumnNullable>()) {
-        auto nested = nullable_col->Nested();
-
-        // Optimized: Check nested type ONCE outside loop, then direct extraction
-        if (auto uint64_col = nested->As<ColumnUInt64>()) {
-          for (size_t i = 0; i < row_count; i++) {
-            if (nullable_col->IsNull(i)) {
-              column_values.push_back(enif_make_atom(env, "nil"));
-            } else {
-              column_values.push_back(enif_make_uint64(env, uint64_col->At(i)));
-            }
-          }
-        } else if (auto int64_col = nested->As<ColumnInt64>()) {
-          for (size_t i = 0; i < row_count; i++) {
-            if (nullable_col->IsNull(i)) {
-              column_values.push_back(enif_make_atom(env, "nil"));
-            } else {
-              column_values.push_back(enif_make_int64(env, int64_col->At(i)));
-            }
-          }
-        } else if (auto float64_col = nested->As<ColumnFloat64>()) {
-          for (size_t i = 0; i < row_count; i++) {
-            if (nullable_col->IsNull(i)) {
-              column_values.push_back(enif_make_atom(env, "nil"));
-            } else {
-              column_values.push_back(enif_make_double(env, float64_col->At(i)));
-            }
-          }
-        } else if (auto string_col = nested->As<ColumnString>()) {
-          for (size_t i = 0; i < row_count; i++) {
-            if (nullable_col->IsNull(i)) {
-              column_values.push_back(enif_make_atom(env, "nil"));
-            } else {
-              std::string_view val_view = string_col->At(i);
-              ErlNifBinary bin;
-              enif_alloc_binary(val_view.size(), &bin);
-              std::memcpy(bin.data, val_view.data(), val_view.size());
-              column_values.push_back(enif_make_binary(env, &bin));
-            }
-          }
-        } else {
-          // Fallback for complex/uncommon types: use Slice approach
-          for (size_t i = 0; i < row_count; i++) {
-            if (nullable_col->IsNull(i)) {
-              column_values.push_back(enif_make_atom(env, "nil"));
-            } else {
-              auto single_value_col = nested->Slice(i, 1);
-              ERL_NIF_TERM elem_list = column_to_elixir_list(env, single_value_col);
-              ERL_NIF_TERM head, tail;
-              if (enif_get_list_cell(env, elem_list, &head, &tail)) {
-                column_values.push_back(head);
-              } else {
-                column_values.push_back(enif_make_atom(env, "error"));
-              }
-            }
-          }
-        }
-      }
-
-      // Append this block's column values to accumulated data (indexed access - O(1))
-      all_columns[c].insert(
-        all_columns[c].end(),
-        column_values.begin(),
-        column_values.end()
-      );
-    }
+    // Append this block's column values to the accumulated columns
+    convert_block_columns(env, header->plan, block, all_columns);
   });
 
+  client.Select(query);
+
   // Build Elixir map: %{column_name => [values]}
-  // Atoms already created during first block processing
+  // Atoms come with the header plan
   size_t num_columns = all_columns.size();
   std::vector<ERL_NIF_TERM> values;
   values.reserve(num_columns);
@@ -1123,325 +379,390 @@ ColumnarResult client_select_cols(
   ERL_NIF_TERM columns_map;
   enif_make_map_from_arrays(env, key_atoms.data(), values.data(), num_columns, &columns_map);
 
-  return ColumnarResult(columns_map);
+  return columns_map;
+}
+
+// Execute SELECT query and return columnar format: %{column_name => [values]}
+// with enum names as binaries or atoms (enum_format)
+ColumnarResult client_select_cols(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ClientResource> client,
+    std::string query,
+    fine::Atom enum_format) {
+  try {
+    ClientLock lock(*client);
+    return ColumnarResult(select_cols_impl(env, *client->ptr, Query(query),
+                                           enum_format_from_name(enum_format.to_string()),
+                                           client->plans));
+  } catch (const std::exception& e) {
+    throw std::runtime_error(encode_clickhouse_error(e));
+  }
 }
 
-FINE_NIF(client_select_cols, 0);
+FINE_NIF(client_select_cols, NATCH_DIRTY_IO);
 
 // Execute parameterized SELECT query and return columnar format
 ColumnarResult client_select_cols_parameterized(
     ErlNifEnv *env,
-    fine::ResourcePtr<Client> client,
-    fine::ResourcePtr<Query> query) {
+    fine::ResourcePtr<ClientResource> client,
+    fine::ResourcePtr<Query> query,
+    fine::Atom enum_format) {
+  try {
+    ClientLock lock(*client);
+    return ColumnarResult(select_cols_impl(env, *client->ptr, *query,
+                                           enum_format_from_name(enum_format.to_string()),
+                                           client->plans));
+  } catch (const std::exception& e) {
+    throw std::runtime_error(encode_clickhouse_error(e));
+  }
+}
 
-  // Pre-create column structure on first block (indexed vectors for O(1) access)
-  std::vector<std::string> col_names;
-  std::vector<ERL_NIF_TERM> key_atoms;
-  std::vector<std::vector<ERL_NIF_TERM>> all_columns;
-  bool first_block = true;
+FINE_NIF(client_select_cols_parameterized, NATCH_DIRTY_IO);
 
-  // Set callback on the Query object before calling Select
-  query->OnData([&](const Block &block) {
-    size_t col_count = block.GetColumnCount();
-    size_t row_count = block.GetRowCount();
+// ============================================================================
+// Packed binary columnar results (format: :binary)
+// ============================================================================
 
-    if (row_count == 0) {
-      return;
+// Owns the storage behind a packed column binary. Columns backed by a
+// contiguous clickhouse-cpp vector are exposed in place (`column` keeps that
+// buffer alive); types whose storage is not accessible are converted once
+// into `bytes`.
+struct PackedColumnResource {
+  ColumnRef column;
+  std::vector<uint8_t> bytes;
+};
+
+FINE_RESOURCE(PackedColumnResource);
+
+static ERL_NIF_TERM make_packed_binary(
+    ErlNifEnv *env,
+    fine::ResourcePtr<PackedColumnResource> res,
+    const void *data,
+    size_t size) {
+  if (size == 0) {
+    ERL_NIF_TERM empty;
+    enif_make_new_binary(env, 0, &empty);
+    return empty;
+  }
+  return fine::make_resource_binary(env, res, static_cast<const char*>(data), size);
+}
+
+// Zero-copy binary over a column's own vector storage
+template <typename T>
+static ERL_NIF_TERM column_storage_binary(ErlNifEnv *env, const ColumnRef &col, std::vector<T> &data) {
+  auto res = fine::make_resource<PackedColumnResource>();
+  res->column = col;
+  return make_packed_binary(env, res, data.data(), data.size() * sizeof(T));
+}
+
+// Binary built by converting each value once into resource-owned memory
+template <typename T, typename ValueAt>
+static ERL_NIF_TERM converted_binary(ErlNifEnv *env, size_t count, ValueAt value_at) {
+  auto res = fine::make_resource<PackedColumnResource>();
+  res->bytes.resize(count * sizeof(T));
+  T *out = reinterpret_cast<T*>(res->bytes.data());
+  for (size_t i = 0; i < count; i++) {
+    out[i] = value_at(i);
+  }
+  return make_packed_binary(env, res, res->bytes.data(), res->bytes.size());
+}
+
+template <typename T>
+static bool try_vector_binary(ErlNifEnv *env, const ColumnRef &col, ERL_NIF_TERM *out) {
+  if (auto typed = col->As<ColumnVector<T>>()) {
+    *out = column_storage_binary(env, col, typed->GetWritableData());
+    return true;
+  }
+  return false;
+}
+
+// Packs a fixed-width column into one native-endian binary. Returns false
+// for variable-width and nested types.
+static bool fixed_width_binary(ErlNifEnv *env, const ColumnRef &col, ERL_NIF_TERM *out) {
+  if (try_vector_binary<uint64_t>(env, col, out) ||
+      try_vector_binary<uint32_t>(env, col, out) ||
+      try_vector_binary<uint16_t>(env, col, out) ||
+      try_vector_binary<uint8_t>(env, col, out) ||
+      try_vector_binary<int64_t>(env, col, out) ||
+      try_vector_binary<int32_t>(env, col, out) ||
+      try_vector_binary<int16_t>(env, col, out) ||
+      try_vector_binary<int8_t>(env, col, out) ||
+      try_vector_binary<double>(env, col, out) ||
+      try_vector_binary<float>(env, col, out)) {
+    return true;
+  }
+
+  if (auto date_col = col->As<ColumnDate>()) {
+    // UInt16 days since epoch
+    *out = column_storage_binary(env, col, date_col->GetWritableData());
+  } else if (auto datetime_col = col->As<ColumnDateTime>()) {
+    // UInt32 seconds since epoch
+    *out = column_storage_binary(env, col, datetime_col->GetWritableData());
+  } else if (auto datetime64_col = col->As<ColumnDateTime64>()) {
+    // Int64 ticks at the column's precision
+    *out = converted_binary<int64_t>(env, col->Size(), [&](size_t i) {
+      return datetime64_col->At(i);
+    });
+  } else if (auto decimal_col = col->As<ColumnDecimal>()) {
+    // Int64 scaled value, same narrowing as the list format
+    *out = converted_binary<int64_t>(env, col->Size(), [&](size_t i) {
+      return static_cast<int64_t>(decimal_col->At(i));
+    });
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// Converts one accumulated result column for format: :binary.
+// Fixed-width columns become a binary, Nullable fixed-width columns become
+// {values, null_map} where null_map holds one byte per row (1 = NULL, same
+// layout as ClickHouse's own null map), LowCardinality columns become
+// {dictionary, indices} with one UInt32 dictionary index per row, everything
+// else falls back to a list.
+static ERL_NIF_TERM packed_column_to_term(ErlNifEnv *env, const ColumnRef &col) {
+  ERL_NIF_TERM packed;
+  if (fixed_width_binary(env, col, &packed)) {
+    return packed;
+  }
+
+  if (auto lc_col = col->As<ColumnLowCardinality>()) {
+    ERL_NIF_TERM dictionary =
+        column_to_elixir_list(env, ColumnLowCardinalityAccess::dictionary(*lc_col));
+    ERL_NIF_TERM indices = converted_binary<uint32_t>(env, col->Size(), [&](size_t i) {
+      return static_cast<uint32_t>(ColumnLowCardinalityAccess::index(*lc_col, i));
+    });
+    return enif_make_tuple2(env, dictionary, indices);
+  }
+
+  if (auto nullable_col = col->As<ColumnNullable>()) {
+    ERL_NIF_TERM values, null_map;
+    if (fixed_width_binary(env, nullable_col->Nested(), &values) &&
+        fixed_width_binary(env, nullable_col->Nulls(), &null_map)) {
+      return enif_make_tuple2(env, values, null_map);
     }
+  }
 
-    // Initialize column structure on first block
-    if (first_block) {
-      col_names.reserve(col_count);
-      key_atoms.reserve(col_count);
-      all_columns.reserve(col_count);
+  return column_to_elixir_list(env, col);
+}
 
+// Run a SELECT and append every block into the first block's columns, so
+// each result column ends up in one contiguous buffer that binaries can
+// point into. Names and empty columns come from the header block, so an
+// empty result still has every column.
+static void select_contiguous(Client &client, Query query, std::vector<std::string> &names,
+                              std::vector<ColumnRef> &columns) {
+  bool has_rows = false;
+  query.OnData([&](const Block &block) {
+    size_t col_count = block.GetColumnCount();
+    if (columns.empty() && col_count > 0) {
+      names.reserve(col_count);
+      columns.reserve(col_count);
       for (size_t c = 0; c < col_count; c++) {
-        std::string col_name = block.GetColumnName(c);
-        col_names.push_back(col_name);
-        key_atoms.push_back(enif_make_atom(env, col_name.c_str()));
-
-        // Estimate capacity: assume 10 blocks total (heuristic)
-        std::vector<ERL_NIF_TERM> col_vec;
-        col_vec.reserve(row_count * 10);
-        all_columns.push_back(std::move(col_vec));
+        names.push_back(block.GetColumnName(c));
+        columns.push_back(block[c]->CloneEmpty());
       }
+    }
 
-      first_block = false;
+    if (block.GetRowCount() == 0) {
+      return;
     }
 
-    // Extract each column's data using index-based access
-    for (size_t c = 0; c < col_count; c++) {
-      ColumnRef col = block[c];
-      std::vector<ERL_NIF_TERM> column_values;
-      column_values.reserve(row_count);
-
-      // Extract column data based on type (reuse logic from client_select_cols)
-      if (auto uint64_col = col->As<ColumnUInt64>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          column_values.push_back(enif_make_uint64(env, uint64_col->At(i)));
-        }
-      } else if (auto uint32_col = col->As<ColumnUInt32>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          column_values.push_back(enif_make_uint64(env, uint32_col->At(i)));
-        }
-      } else if (auto uint16_col = col->As<ColumnUInt16>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          column_values.push_back(enif_make_uint64(env, uint16_col->At(i)));
-        }
-      } else if (auto uint8_col = col->As<ColumnUInt8>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          column_values.push_back(enif_make_uint64(env, uint8_col->At(i)));
-        }
-      } else if (auto int64_col = col->As<ColumnInt64>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          column_values.push_back(enif_make_int64(env, int64_col->At(i)));
-        }
-      } else if (auto int32_col = col->As<ColumnInt32>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          column_values.push_back(enif_make_int64(env, int32_col->At(i)));
-        }
-      } else if (auto int16_col = col->As<ColumnInt16>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          column_values.push_back(enif_make_int64(env, int16_col->At(i)));
-        }
-      } else if (auto int8_col = col->As<ColumnInt8>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          column_values.push_back(enif_make_int64(env, int8_col->At(i)));
-        }
-      } else if (auto float64_col = col->As<ColumnFloat64>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          column_values.push_back(enif_make_double(env, float64_col->At(i)));
-        }
-      } else if (auto float32_col = col->As<ColumnFloat32>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          column_values.push_back(enif_make_double(env, float32_col->At(i)));
-        }
-      } else if (auto string_col = col->As<ColumnString>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          std::string_view val_view = string_col->At(i);
-          ErlNifBinary bin;
-          enif_alloc_binary(val_view.size(), &bin);
-          std::memcpy(bin.data, val_view.data(), val_view.size());
-          column_values.push_back(enif_make_binary(env, &bin));
-        }
-      } else if (auto datetime_col = col->As<ColumnDateTime>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          column_values.push_back(enif_make_uint64(env, datetime_col->At(i)));
-        }
-      } else if (auto datetime64_col = col->As<ColumnDateTime64>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          column_values.push_back(enif_make_int64(env, datetime64_col->At(i)));
-        }
-      } else if (auto date_col = col->As<ColumnDate>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          column_values.push_back(enif_make_uint64(env, date_col->RawAt(i)));
-        }
-      } else if (auto uuid_col = col->As<ColumnUUID>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          UUID uuid = uuid_col->At(i);
-          char uuid_buf[37];
-          format_uuid_to_buffer(uuid, uuid_buf);
-          ErlNifBinary bin;
-          enif_alloc_binary(36, &bin);
-          std::memcpy(bin.data, uuid_buf, 36);
-          column_values.push_back(enif_make_binary(env, &bin));
-        }
-      } else if (auto decimal_col = col->As<ColumnDecimal>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          Int128 value = decimal_col->At(i);
-          int64_t scaled_value = static_cast<int64_t>(value);
-          column_values.push_back(enif_make_int64(env, scaled_value));
-        }
-      } else if (auto array_col = col->As<ColumnArray>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          auto nested = array_col->GetAsColumn(i);
-          column_values.push_back(column_to_elixir_list(env, nested));
-        }
-      } else if (auto map_col = col->As<ColumnMap>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          auto kv_tuples = map_col->GetAsColumn(i);
-          if (auto tuple_col = kv_tuples->As<ColumnTuple>()) {
-            auto keys_col = tuple_col->At(0);
-            auto values_col = tuple_col->At(1);
-            size_t map_size = keys_col->Size();
-
-            std::vector<ERL_NIF_TERM> key_terms;
-            std::vector<ERL_NIF_TERM> value_terms;
-            key_terms.reserve(map_size);
-            value_terms.reserve(map_size);
-
-            ERL_NIF_TERM keys_list = column_to_elixir_list(env, keys_col);
-            ERL_NIF_TERM key_tail = keys_list;
-            for (size_t j = 0; j < map_size; j++) {
-              ERL_NIF_TERM key;
-              if (enif_get_list_cell(env, key_tail, &key, &key_tail)) {
-                key_terms.push_back(key);
-              }
-            }
-
-            ERL_NIF_TERM values_list = column_to_elixir_list(env, values_col);
-            ERL_NIF_TERM value_tail = values_list;
-            for (size_t j = 0; j < map_size; j++) {
-              ERL_NIF_TERM value;
-              if (enif_get_list_cell(env, value_tail, &value, &value_tail)) {
-                value_terms.push_back(value);
-              }
-            }
-
-            ERL_NIF_TERM elixir_map;
-            enif_make_map_from_arrays(env, key_terms.data(), value_terms.data(), map_size, &elixir_map);
-
-            column_values.push_back(elixir_map);
-          } else {
-            column_values.push_back(enif_make_new_map(env));
-          }
-        }
-      } else if (auto tuple_col = col->As<ColumnTuple>()) {
-        size_t tuple_size = tuple_col->TupleSize();
-
-        std::vector<std::vector<ERL_NIF_TERM>> element_columns;
-        element_columns.reserve(tuple_size);
-
-        for (size_t j = 0; j < tuple_size; j++) {
-          auto element_col = tuple_col->At(j);
-          ERL_NIF_TERM elem_list = column_to_elixir_list(env, element_col);
-          std::vector<ERL_NIF_TERM> elem_vec;
-          elem_vec.reserve(row_count);
-          ERL_NIF_TERM tail = elem_list;
-          for (size_t i = 0; i < row_count; i++) {
-            ERL_NIF_TERM head;
-            if (enif_get_list_cell(env, tail, &head, &tail)) {
-              elem_vec.push_back(head);
-            } else {
-              elem_vec.push_back(enif_make_atom(env, "error"));
-            }
-          }
-          element_columns.push_back(std::move(elem_vec));
-        }
-
-        for (size_t i = 0; i < row_count; i++) {
-          std::vector<ERL_NIF_TERM> tuple_elements;
-          tuple_elements.reserve(tuple_size);
-          for (size_t j = 0; j < tuple_size; j++) {
-            tuple_elements.push_back(element_columns[j][i]);
-          }
-          column_values.push_back(enif_make_tuple_from_array(env, tuple_elements.data(), tuple_elements.size()));
-        }
-      } else if (auto enum8_col = col->As<ColumnEnum8>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          std::string_view name = enum8_col->NameAt(i);
-          ErlNifBinary bin;
-          enif_alloc_binary(name.size(), &bin);
-          std::memcpy(bin.data, name.data(), name.size());
-          column_values.push_back(enif_make_binary(env, &bin));
-        }
-      } else if (auto enum16_col = col->As<ColumnEnum16>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          std::string_view name = enum16_col->NameAt(i);
-          ErlNifBinary bin;
-          enif_alloc_binary(name.size(), &bin);
-          std::memcpy(bin.data, name.data(), name.size());
-          column_values.push_back(enif_make_binary(env, &bin));
-        }
-      } else if (auto lc_col = col->As<ColumnLowCardinality>()) {
-        for (size_t i = 0; i < row_count; i++) {
-          auto item = lc_col->GetItem(i);
-          if (item.type == Type::String) {
-            auto val = item.get<std::string_view>();
-            ErlNifBinary bin;
-            enif_alloc_binary(val.size(), &bin);
-            std::memcpy(bin.data, val.data(), val.size());
-            column_values.push_back(enif_make_binary(env, &bin));
-          } else if (item.type == Type::Void) {
-            column_values.push_back(enif_make_atom(env, "nil"));
-          } else {
-            throw std::runtime_error("Unsupported LowCardinality inner type");
-          }
-        }
-      } else if (auto nullable_col = col->As<ColumnNullable>()) {
-        auto nested = nullable_col->Nested();
-
-        if (auto uint64_col = nested->As<ColumnUInt64>()) {
-          for (size_t i = 0; i < row_count; i++) {
-            if (nullable_col->IsNull(i)) {
-              column_values.push_back(enif_make_atom(env, "nil"));
-            } else {
-              column_values.push_back(enif_make_uint64(env, uint64_col->At(i)));
-            }
-          }
-        } else if (auto int64_col = nested->As<ColumnInt64>()) {
-          for (size_t i = 0; i < row_count; i++) {
-            if (nullable_col->IsNull(i)) {
-              column_values.push_back(enif_make_atom(env, "nil"));
-            } else {
-              column_values.push_back(enif_make_int64(env, int64_col->At(i)));
-            }
-          }
-        } else if (auto float64_col = nested->As<ColumnFloat64>()) {
-          for (size_t i = 0; i < row_count; i++) {
-            if (nullable_col->IsNull(i)) {
-              column_values.push_back(enif_make_atom(env, "nil"));
-            } else {
-              column_values.push_back(enif_make_double(env, float64_col->At(i)));
-            }
-          }
-        } else if (auto string_col = nested->As<ColumnString>()) {
-          for (size_t i = 0; i < row_count; i++) {
-            if (nullable_col->IsNull(i)) {
-              column_values.push_back(enif_make_atom(env, "nil"));
-            } else {
-              std::string_view val_view = string_col->At(i);
-              ErlNifBinary bin;
-              enif_alloc_binary(val_view.size(), &bin);
-              std::memcpy(bin.data, val_view.data(), val_view.size());
-              column_values.push_back(enif_make_binary(env, &bin));
-            }
-          }
-        } else {
-          // Fallback for complex/uncommon types
-          for (size_t i = 0; i < row_count; i++) {
-            if (nullable_col->IsNull(i)) {
-              column_values.push_back(enif_make_atom(env, "nil"));
-            } else {
-              auto single_value_col = nested->Slice(i, 1);
-              ERL_NIF_TERM elem_list = column_to_elixir_list(env, single_value_col);
-              ERL_NIF_TERM head, tail;
-              if (enif_get_list_cell(env, elem_list, &head, &tail)) {
-                column_values.push_back(head);
-              } else {
-                column_values.push_back(enif_make_atom(env, "error"));
-              }
-            }
-          }
-        }
+    // The first block with rows is adopted as is instead of copied
+    if (!has_rows) {
+      has_rows = true;
+      for (size_t c = 0; c < col_count; c++) {
+        columns[c] = block[c];
       }
+      return;
+    }
 
-      // Append this block's column values to accumulated data
-      all_columns[c].insert(
-        all_columns[c].end(),
-        column_values.begin(),
-        column_values.end()
-      );
+    for (size_t c = 0; c < columns.size(); c++) {
+      columns[c]->Append(block[c]);
     }
   });
-  // Execute the query with the configured callback
-  client->Select(*query);
 
+  client.Select(query);
+}
 
-  // Build Elixir map: %{column_name => [values]}
-  size_t num_columns = all_columns.size();
+static std::vector<ERL_NIF_TERM> name_atoms(ErlNifEnv *env, const std::vector<std::string> &names) {
+  std::vector<ERL_NIF_TERM> atoms;
+  atoms.reserve(names.size());
+  for (const auto &name : names) {
+    atoms.push_back(enif_make_atom(env, name.c_str()));
+  }
+  return atoms;
+}
+
+// Run a SELECT and return %{column_name => binary | {binary, null_map} | [values]}.
+ERL_NIF_TERM select_cols_binary_impl(ErlNifEnv *env, Client &client, Query query) {
+  std::vector<std::string> names;
+  std::vector<ColumnRef> columns;
+  select_contiguous(client, query, names, columns);
+
+  std::vector<ERL_NIF_TERM> key_atoms = name_atoms(env, names);
   std::vector<ERL_NIF_TERM> values;
-  values.reserve(num_columns);
+  values.reserve(columns.size());
+  for (const auto &col : columns) {
+    values.push_back(packed_column_to_term(env, col));
+  }
 
-  for (size_t c = 0; c < num_columns; c++) {
-    values.push_back(enif_make_list_from_array(env, all_columns[c].data(), all_columns[c].size()));
+  ERL_NIF_TERM columns_map;
+  enif_make_map_from_arrays(env, key_atoms.data(), values.data(), columns.size(), &columns_map);
+  return columns_map;
+}
+
+// Execute SELECT query and return fixed-width columns as packed binaries
+ColumnarResult client_select_cols_binary(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ClientResource> client,
+    std::string query) {
+  try {
+    ClientLock lock(*client);
+    return ColumnarResult(select_cols_binary_impl(env, *client->ptr, Query(query)));
+  } catch (const std::exception& e) {
+    throw std::runtime_error(encode_clickhouse_error(e));
   }
+}
+
+FINE_NIF(client_select_cols_binary, NATCH_DIRTY_IO);
 
+// Execute parameterized SELECT query and return packed binary columns
+ColumnarResult client_select_cols_binary_parameterized(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ClientResource> client,
+    fine::ResourcePtr<Query> query) {
+  try {
+    ClientLock lock(*client);
+    return ColumnarResult(select_cols_binary_impl(env, *client->ptr, *query));
+  } catch (const std::exception& e) {
+    throw std::runtime_error(encode_clickhouse_error(e));
+  }
+}
+
+FINE_NIF(client_select_cols_binary_parameterized, NATCH_DIRTY_IO);
+
+// ============================================================================
+// Tensor columns (Natch.select_tensors)
+// ============================================================================
+
+// {nx_type, binary} for a numeric column, where nx_type is {:s | :u | :f, bits}
+template <typename T>
+static bool try_tensor_column(ErlNifEnv *env, const ColumnRef &col, const char *kind,
+                              ERL_NIF_TERM *out) {
+  auto typed = col->As<ColumnVector<T>>();
+  if (!typed) {
+    return false;
+  }
+  ERL_NIF_TERM type = enif_make_tuple2(env, enif_make_atom(env, kind),
+                                       enif_make_uint(env, sizeof(T) * 8));
+  *out = enif_make_tuple2(env, type, column_storage_binary(env, col, typed->GetWritableData()));
+  return true;
+}
+
+static ERL_NIF_TERM tensor_column_to_term(ErlNifEnv *env, const std::string &name,
+                                          const ColumnRef &col) {
+  ERL_NIF_TERM out;
+  if (try_tensor_column<uint64_t>(env, col, "u", &out) ||
+      try_tensor_column<uint32_t>(env, col, "u", &out) ||
+      try_tensor_column<uint16_t>(env, col, "u", &out) ||
+      try_tensor_column<uint8_t>(env, col, "u", &out) ||
+      try_tensor_column<int64_t>(env, col, "s", &out) ||
+      try_tensor_column<int32_t>(env, col, "s", &out) ||
+      try_tensor_column<int16_t>(env, col, "s", &out) ||
+      try_tensor_column<int8_t>(env, col, "s", &out) ||
+      try_tensor_column<double>(env, col, "f", &out) ||
+      try_tensor_column<float>(env, col, "f", &out)) {
+    return out;
+  }
+  throw ValidationError("column " + name + " of type " + col->GetType().GetName() +
+                        " cannot be returned as a tensor, only (U)Int8..64 and "
+                        "Float32/64 columns are supported");
+}
+
+// Run a SELECT and return %{column_name => {nx_type, binary}}. Binaries
+// point at the column storage, as in format: :binary.
+static ERL_NIF_TERM select_tensors_impl(ErlNifEnv *env, Client &client, Query query) {
+  std::vector<std::string> names;
+  std::vector<ColumnRef> columns;
+  select_contiguous(client, query, names, columns);
+
+  std::vector<ERL_NIF_TERM> values;
+  values.reserve(columns.size());
+  for (size_t c = 0; c < columns.size(); c++) {
+    values.push_back(tensor_column_to_term(env, names[c], columns[c]));
+  }
+
+  std::vector<ERL_NIF_TERM> key_atoms = name_atoms(env, names);
   ERL_NIF_TERM columns_map;
-  enif_make_map_from_arrays(env, key_atoms.data(), values.data(), num_columns, &columns_map);
+  enif_make_map_from_arrays(env, key_atoms.data(), values.data(), columns.size(), &columns_map);
+  return columns_map;
+}
+
+// Execute SELECT query and return numeric columns with their Nx types
+ColumnarResult client_select_tensors(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ClientResource> client,
+    std::string query) {
+  try {
+    ClientLock lock(*client);
+    return ColumnarResult(select_tensors_impl(env, *client->ptr, Query(query)));
+  } catch (const std::exception& e) {
+    throw std::runtime_error(encode_clickhouse_error(e));
+  }
+}
+
+FINE_NIF(client_select_tensors, NATCH_DIRTY_IO);
 
-  return ColumnarResult(columns_map);
+// Execute parameterized SELECT query and return numeric columns with their Nx types
+ColumnarResult client_select_tensors_parameterized(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ClientResource> client,
+    fine::ResourcePtr<Query> query) {
+  try {
+    ClientLock lock(*client);
+    return ColumnarResult(select_tensors_impl(env, *client->ptr, *query));
+  } catch (const std::exception& e) {
+    throw std::runtime_error(encode_clickhouse_error(e));
+  }
 }
 
-FINE_NIF(client_select_cols_parameterized, 0);
+FINE_NIF(client_select_tensors_parameterized, NATCH_DIRTY_IO);
+
 
+// ============================================================================
+// Async SELECT (results delivered by message, see async.h)
+// ============================================================================
+
+/// Queues a SELECT on the client's worker thread and returns a reference
+///
+/// @param format :rows (list of maps) or :columns (%{column => [values]})
+fine::Term client_select_async(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ClientResource> client,
+    std::string sql,
+    fine::Atom format) {
+  bool columnar = format.to_string() == "columns";
+  return submit_async(env, client, [sql, columnar](ErlNifEnv *msg_env, ClientResource &c) {
+    Query query(sql);
+    return columnar ? select_cols_impl(msg_env, *c.ptr, query, EnumFormat::Binaries, c.plans)
+                    : select_rows_impl(msg_env, *c.ptr, query, c.plans);
+  });
+}
+FINE_NIF(client_select_async, 0);
+
+/// Queues a parameterized SELECT on the client's worker thread
+fine::Term client_select_async_parameterized(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ClientResource> client,
+    fine::ResourcePtr<Query> query,
+    fine::Atom format) {
+  bool columnar = format.to_string() == "columns";
+  // Copy the query now: the caller may rebind the resource before the job runs
+  Query q = *query;
+  return submit_async(env, client, [q, columnar](ErlNifEnv *msg_env, ClientResource &c) {
+    return columnar ? select_cols_impl(msg_env, *c.ptr, q, EnumFormat::Binaries, c.plans)
+                    : select_rows_impl(msg_env, *c.ptr, q, c.plans);
+  });
+}
+FINE_NIF(client_select_async_parameterized, 0);
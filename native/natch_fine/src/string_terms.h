@@ -0,0 +1,90 @@
+#pragma once
+
+#include <erl_nif.h>
+#include <cstring>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+// Values up to this size are returned as heap binaries (the VM's own
+// ERL_ONHEAP_BIN_LIMIT): they are cheaper to create than a sub-binary and do
+// not keep a shared buffer alive.
+constexpr size_t HEAP_BINARY_LIMIT = 64;
+
+// Builds binary terms for a run of string values (one column of one block)
+// with a single refc allocation.
+//
+// Values longer than HEAP_BINARY_LIMIT are copied once into one shared refc
+// binary and returned as sub-binaries of it; shorter values become heap
+// binaries. Compared to enif_alloc_binary per value this turns N allocations
+// into at most one. Note that any surviving sub-binary keeps the whole shared
+// buffer alive; use :binary.copy/1 on values retained long-term.
+class StringTermBuilder {
+ public:
+  explicit StringTermBuilder(size_t capacity) {
+    values_.reserve(capacity);
+  }
+
+  void add(std::string_view value) {
+    if (value.size() > HEAP_BINARY_LIMIT) {
+      shared_size_ += value.size();
+    }
+    values_.emplace_back(value);
+  }
+
+  // Placeholder for a NULL row, emitted as the atom nil
+  void add_nil() {
+    values_.emplace_back(std::nullopt);
+  }
+
+  // Appends one term per added value to `out`, in order. The string_views
+  // must still be valid (the source column must be alive).
+  void build(ErlNifEnv *env, std::vector<ERL_NIF_TERM> &out) const {
+    size_t start = out.size();
+    out.resize(start + values_.size());
+    build(env, out.data() + start);
+  }
+
+  // Same, written to out[0..count) for the number of added values
+  void build(ErlNifEnv *env, ERL_NIF_TERM *out) const {
+    ERL_NIF_TERM shared = 0;
+    if (shared_size_ > 0) {
+      ErlNifBinary bin;
+      enif_alloc_binary(shared_size_, &bin);
+      size_t offset = 0;
+      for (const auto &value : values_) {
+        if (value && value->size() > HEAP_BINARY_LIMIT) {
+          std::memcpy(bin.data + offset, value->data(), value->size());
+          offset += value->size();
+        }
+      }
+      shared = enif_make_binary(env, &bin);
+    }
+
+    ERL_NIF_TERM nil = enif_make_atom(env, "nil");
+    size_t offset = 0;
+    for (const auto &value : values_) {
+      if (!value) {
+        *out++ = nil;
+      } else if (value->size() > HEAP_BINARY_LIMIT) {
+        *out++ = enif_make_sub_binary(env, shared, offset, value->size());
+        offset += value->size();
+      } else {
+        *out++ = make_heap_binary(env, *value);
+      }
+    }
+  }
+
+  static ERL_NIF_TERM make_heap_binary(ErlNifEnv *env, std::string_view value) {
+    ERL_NIF_TERM term;
+    unsigned char *data = enif_make_new_binary(env, value.size(), &term);
+    if (value.size() > 0) {
+      std::memcpy(data, value.data(), value.size());
+    }
+    return term;
+  }
+
+ private:
+  std::vector<std::optional<std::string_view>> values_;
+  size_t shared_size_ = 0;
+};
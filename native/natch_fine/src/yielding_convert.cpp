@@ -0,0 +1,193 @@
+// yielding_convert.cpp - Result conversion that yields to the BEAM
+//
+// client_select and client_select_cols convert the whole result inside one
+// dirty NIF call. Here the result is first received into a
+// ResultSetResource (dirty I/O, no term building, see result_set.cpp), then converted by a
+// NIF that runs on a normal scheduler as a resumable state machine: it
+// converts a bounded chunk of rows at a time, reports the time spent with
+// enif_consume_timeslice and, when the timeslice is used up, reschedules
+// itself with enif_schedule_nif to continue from the saved position.
+//
+// The position (block and row) lives in a ConversionState resource. The
+// partially built result is passed to the continuation as an argument
+// instead of being held in the resource, since terms are only kept alive
+// across a reschedule when they are reachable from the arguments. Rows are
+// converted from the last to the first, so each chunk is prepended to the
+// lists built so far and no final concatenation or copy is needed.
+
+#include <fine.hpp>
+#include <clickhouse/block.h>
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "nif_flags.h"
+#include "result_set.h"
+#include "row_terms.h"
+
+using namespace clickhouse;
+
+// Values converted per chunk; the timeslice is checked between chunks
+constexpr size_t CHUNK_VALUES = 16384;
+
+struct ConversionState {
+  fine::ResourcePtr<ResultSetResource> result;
+  bool columnar;
+  // Shape of each row when not columnar
+  RowFormat row_format;
+  // Column name atoms (atoms are not tied to an env)
+  std::vector<ERL_NIF_TERM> keys;
+
+  // Rows [0, row_end) of blocks [0, block) remain to be converted
+  size_t block;
+  size_t row_end;
+
+  ConversionState(fine::ResourcePtr<ResultSetResource> r, bool c, RowFormat f)
+      : result(r), columnar(c), row_format(f), block(r->blocks.size()),
+        row_end(r->blocks.empty() ? 0 : r->blocks.back().GetRowCount()) {}
+};
+
+FINE_RESOURCE(ConversionState);
+
+// Prepend rows [start, start + len) of `block` to the accumulated lists:
+// one list per column (columnar) or a single list of rows
+static void convert_chunk(ErlNifEnv *env, ConversionState &state, const Block &block,
+                          size_t start, size_t len, std::vector<ERL_NIF_TERM> &accs) {
+  size_t col_count = block.GetColumnCount();
+  std::vector<std::vector<ERL_NIF_TERM>> terms(col_count);
+
+  for (size_t c = 0; c < col_count; c++) {
+    ColumnRef col = block[c];
+    if (len != col->Size()) {
+      col = col->Slice(start, len);
+    }
+    state.result->header->plan.convert(env, c, col, terms[c]);
+  }
+
+  if (state.columnar) {
+    for (size_t c = 0; c < col_count; c++) {
+      for (size_t i = len; i-- > 0;) {
+        accs[c] = enif_make_list_cell(env, terms[c][i], accs[c]);
+      }
+    }
+    return;
+  }
+
+  std::vector<ERL_NIF_TERM> values(col_count);
+  for (size_t i = len; i-- > 0;) {
+    for (size_t c = 0; c < col_count; c++) {
+      values[c] = terms[c][i];
+    }
+    ERL_NIF_TERM row = make_row(env, state.row_format, state.keys.data(), values.data(), col_count);
+    accs[0] = enif_make_list_cell(env, row, accs[0]);
+  }
+}
+
+static ERL_NIF_TERM convert_step_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]);
+
+// Convert chunks until the result is complete or the timeslice is used up.
+// `state_term` is the ConversionState resource term, passed on when
+// rescheduling.
+static ERL_NIF_TERM convert_step(ErlNifEnv *env, ERL_NIF_TERM state_term,
+                                 ConversionState &state, std::vector<ERL_NIF_TERM> &accs) {
+  auto &blocks = state.result->blocks;
+  auto slice_start = std::chrono::steady_clock::now();
+
+  while (state.block > 0) {
+    const Block &block = blocks[state.block - 1];
+    size_t chunk_rows = std::max<size_t>(1, CHUNK_VALUES / std::max<size_t>(1, state.keys.size()));
+    size_t start = state.row_end > chunk_rows ? state.row_end - chunk_rows : 0;
+
+    convert_chunk(env, state, block, start, state.row_end - start, accs);
+
+    state.row_end = start;
+    if (state.row_end == 0 && --state.block > 0) {
+      state.row_end = blocks[state.block - 1].GetRowCount();
+    }
+    if (state.block == 0) {
+      break;
+    }
+
+    // A full timeslice is about 1ms
+    auto now = std::chrono::steady_clock::now();
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(now - slice_start).count();
+    int percent = static_cast<int>(std::clamp<long long>(us / 10, 1, 100));
+    slice_start = now;
+
+    if (enif_consume_timeslice(env, percent)) {
+      ERL_NIF_TERM args[2] = {
+          state_term, enif_make_tuple_from_array(env, accs.data(), accs.size())};
+      return enif_schedule_nif(env, "result_blocks_to_terms", 0, convert_step_nif, 2, args);
+    }
+  }
+
+  if (!state.columnar) {
+    return rows_result(env, state.row_format, state.keys, accs[0]);
+  }
+
+  ERL_NIF_TERM columns_map;
+  enif_make_map_from_arrays(env, state.keys.data(), accs.data(), state.keys.size(), &columns_map);
+  return columns_map;
+}
+
+// Raise like a FINE NIF throwing std::runtime_error, so the Elixir side
+// handles errors from every step the same way
+static ERL_NIF_TERM raise_runtime_error(ErlNifEnv *env, const std::string &message) {
+  ERL_NIF_TERM keys[3] = {enif_make_atom(env, "__struct__"), enif_make_atom(env, "__exception__"),
+                          enif_make_atom(env, "message")};
+  ERL_NIF_TERM message_term;
+  unsigned char *data = enif_make_new_binary(env, message.size(), &message_term);
+  std::copy(message.begin(), message.end(), data);
+  ERL_NIF_TERM values[3] = {enif_make_atom(env, "Elixir.RuntimeError"),
+                            enif_make_atom(env, "true"), message_term};
+  ERL_NIF_TERM exception;
+  enif_make_map_from_arrays(env, keys, values, 3, &exception);
+  return enif_raise_exception(env, exception);
+}
+
+// Continuation scheduled by convert_step: argv is {state, accumulated lists}
+static ERL_NIF_TERM convert_step_nif(ErlNifEnv *env, int argc, const ERL_NIF_TERM argv[]) {
+  try {
+    auto state = fine::decode<fine::ResourcePtr<ConversionState>>(env, argv[0]);
+    int arity;
+    const ERL_NIF_TERM *elements;
+    if (!enif_get_tuple(env, argv[1], &arity, &elements)) {
+      throw std::runtime_error("invalid conversion state");
+    }
+    std::vector<ERL_NIF_TERM> accs(elements, elements + arity);
+    return convert_step(env, argv[0], *state, accs);
+  } catch (const std::exception &e) {
+    return raise_runtime_error(env, e.what());
+  }
+}
+
+// ============================================================================
+// Yielding conversion NIF
+// ============================================================================
+
+/// Converts result blocks to a list of maps (:rows), {column_names, rows}
+/// of tuples or lists (:tuples, :lists) or %{column => [values]} (:columns)
+/// on a normal scheduler, yielding between chunks of rows
+///
+/// @param format :rows, :tuples, :lists or :columns
+fine::Term result_blocks_to_terms(
+    ErlNifEnv *env,
+    fine::ResourcePtr<ResultSetResource> result,
+    fine::Atom format) {
+  std::string name = format.to_string();
+  auto state = fine::make_resource<ConversionState>(result, name == "columns",
+                                                    row_format_from_name(name));
+
+  // Keys only when there are rows, so empty results convert to [] and %{}
+  // as in select_rows and select_cols; tuples and lists always carry them
+  if (result->header &&
+      (!result->blocks.empty() || (!state->columnar && state->row_format != RowFormat::Maps))) {
+    state->keys = result->header->names;
+  }
+
+  std::vector<ERL_NIF_TERM> accs(state->columnar ? state->keys.size() : 1,
+                                 enif_make_list(env, 0));
+  return convert_step(env, fine::encode(env, state), *state, accs);
+}
+FINE_NIF(result_blocks_to_terms, 0);
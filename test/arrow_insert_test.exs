@@ -0,0 +1,166 @@
+defmodule Natch.ArrowInsertTest do
+  use ExUnit.Case, async: true
+
+  setup do
+    # Generate unique table name for this test
+    table = "test_#{System.unique_integer([:positive, :monotonic])}_#{:rand.uniform(999_999)}"
+
+    # Start test connection
+    {:ok, conn} = Natch.start_link(host: "localhost", port: 9000)
+
+    Natch.execute!(conn, """
+    CREATE TABLE #{table} (
+      id UInt64,
+      name String,
+      score Nullable(Float64),
+      tags Array(String),
+      kind LowCardinality(String),
+      day Date,
+      ts DateTime64(6),
+      amount Decimal64(9)
+    ) ENGINE = MergeTree ORDER BY id
+    """)
+
+    on_exit(fn ->
+      # Clean up test table if it exists
+      if Process.alive?(conn) do
+        try do
+          Natch.execute(conn, "DROP TABLE IF EXISTS #{table}")
+        catch
+          :exit, _ -> :ok
+        end
+
+        # Use Process.exit to avoid race conditions
+        Process.exit(conn, :normal)
+      end
+    end)
+
+    {:ok, conn: conn, table: table}
+  end
+
+  @schema [
+    id: :uint64,
+    name: :string,
+    score: {:nullable, :float64},
+    tags: {:array, :string},
+    kind: {:low_cardinality, :string},
+    day: :date,
+    ts: :datetime64,
+    amount: :decimal
+  ]
+
+  # Several blocks, so the stream has several record batches. ts is
+  # DateTime64(3) and amount has scale 4, so both are rescaled on insert.
+  @source """
+  SELECT
+    number AS id,
+    toString(number) AS name,
+    if(number % 3 = 0, NULL, number / 2) AS score,
+    arrayMap(x -> toString(x), range(number % 4)) AS tags,
+    toLowCardinality(if(number % 2 = 0, 'even', 'odd')) AS kind,
+    toDate('2024-01-01') + number AS day,
+    toDateTime64('2024-01-01 00:00:00.123', 3, 'UTC') + number AS ts,
+    toDecimal64(number, 4) / 8 AS amount
+  FROM numbers(1000)
+  SETTINGS max_block_size = 300
+  """
+
+  @compare "id, name, score, tags, kind, day, toUnixTimestamp64Milli(ts) AS ts, " <>
+             "toFloat64(amount) AS amount"
+
+  describe "insert_arrow/4" do
+    test "inserts every record batch", %{conn: conn, table: table} do
+      {:ok, ipc} = Natch.select_arrow(conn, @source)
+
+      assert :ok = Natch.insert_arrow(conn, table, ipc, @schema)
+
+      {:ok, expected} =
+        Natch.select_rows(conn, "SELECT #{@compare} FROM (#{@source}) ORDER BY id")
+
+      {:ok, rows} = Natch.select_rows(conn, "SELECT #{@compare} FROM #{table} ORDER BY id")
+
+      assert length(rows) == 1000
+      assert rows == expected
+    end
+
+    test "extra fields are ignored and integers are cast", %{conn: conn, table: table} do
+      {:ok, ipc} =
+        Natch.select_arrow(conn, "SELECT toInt32(number) AS id, 'x' AS other FROM numbers(3)")
+
+      schema = [id: :uint64]
+      assert :ok = Natch.insert_arrow(conn, table, ipc, schema)
+
+      {:ok, rows} = Natch.select_rows(conn, "SELECT id FROM #{table} ORDER BY id")
+      assert rows == [%{id: 0}, %{id: 1}, %{id: 2}]
+    end
+
+    test "NULLs for a non-Nullable column are rejected", %{conn: conn, table: table} do
+      {:ok, ipc} =
+        Natch.select_arrow(conn, "SELECT if(number = 1, NULL, number) AS id FROM numbers(3)")
+
+      assert {:error, %{type: "validation", message: message}} =
+               Natch.insert_arrow(conn, table, ipc, id: :uint64)
+
+      assert message =~ "is not Nullable"
+    end
+
+    test "floats are not truncated into integer columns", %{conn: conn, table: table} do
+      {:ok, ipc} =
+        Natch.select_arrow(conn, "SELECT toFloat64(number) + 0.5 AS id FROM numbers(3)")
+
+      assert {:error, %{type: "validation", message: message}} =
+               Natch.insert_arrow(conn, table, ipc, id: :uint64)
+
+      assert message =~ "cannot insert Arrow"
+    end
+
+    test "values outside the column's range are rejected", %{conn: conn, table: table} do
+      {:ok, ipc} = Natch.select_arrow(conn, "SELECT toInt64(number) - 1 AS id FROM numbers(3)")
+
+      assert {:error, %{type: "validation", message: message}} =
+               Natch.insert_arrow(conn, table, ipc, id: :uint64)
+
+      assert message =~ "value -1 is out of range for UInt64"
+
+      {:ok, ipc} =
+        Natch.select_arrow(conn, "SELECT toDateTime64('2200-01-01 00:00:00', 0, 'UTC') AS day")
+
+      assert {:error, %{type: "validation", message: message}} =
+               Natch.insert_arrow(conn, table, ipc, day: :date)
+
+      assert message =~ "is out of range for Date"
+
+      {:ok, ipc} = Natch.select_arrow(conn, "SELECT toDecimal128(1000000000000000, 4) AS amount")
+
+      assert {:error, %{type: "validation", message: message}} =
+               Natch.insert_arrow(conn, table, ipc, amount: :decimal)
+
+      assert message =~ "is out of range for Decimal"
+
+      {:ok, rows} = Natch.select_rows(conn, "SELECT count() AS n FROM #{table}")
+      assert rows == [%{n: 0}]
+    end
+
+    test "missing fields are rejected", %{conn: conn, table: table} do
+      {:ok, ipc} = Natch.select_arrow(conn, "SELECT number AS other FROM numbers(3)")
+
+      assert {:error, %{type: "validation", message: message}} =
+               Natch.insert_arrow(conn, table, ipc, id: :uint64)
+
+      assert message =~ "Arrow stream has no field id"
+    end
+
+    test "malformed streams are rejected", %{conn: conn, table: table} do
+      {:ok, ipc} = Natch.select_arrow(conn, "SELECT number AS id FROM numbers(3)")
+      truncated = binary_part(ipc, 0, byte_size(ipc) - 20)
+
+      assert {:error, %{type: "validation", message: message}} =
+               Natch.insert_arrow(conn, table, truncated, id: :uint64)
+
+      assert message =~ "invalid Arrow IPC stream"
+
+      assert {:error, %{type: "validation"}} =
+               Natch.insert_arrow(conn, table, "not arrow", id: :uint64)
+    end
+  end
+end
@@ -0,0 +1,177 @@
+defmodule Natch.ArrowTest do
+  use ExUnit.Case, async: true
+
+  setup do
+    # Start test connection
+    {:ok, conn} = Natch.start_link(host: "localhost", port: 9000)
+
+    on_exit(fn ->
+      if Process.alive?(conn) do
+        # Use Process.exit to avoid race conditions
+        Process.exit(conn, :normal)
+      end
+    end)
+
+    {:ok, conn: conn}
+  end
+
+  # Splits an IPC stream into {metadata, body} messages. The body length is
+  # read from the Message flatbuffer: root table -> vtable slot 3 (bodyLength).
+  defp messages(<<0xFFFFFFFF::32-little, 0::32-little>>), do: []
+
+  defp messages(<<0xFFFFFFFF::32-little, size::32-little, rest::binary>>) do
+    <<metadata::binary-size(size), rest::binary>> = rest
+    body_length = body_length(metadata)
+    <<body::binary-size(body_length), rest::binary>> = rest
+    [{metadata, body} | messages(rest)]
+  end
+
+  defp body_length(metadata) do
+    <<root::32-little, _::binary>> = metadata
+    <<_::binary-size(root), vtable_delta::signed-32-little, _::binary>> = metadata
+    vtable = root - vtable_delta
+    <<_::binary-size(vtable), vtable_size::16-little, _::binary>> = metadata
+
+    if vtable_size > 10 do
+      <<_::binary-size(vtable + 10), field::16-little, _::binary>> = metadata
+      <<_::binary-size(root + field), length::signed-64-little, _::binary>> = metadata
+      length
+    else
+      0
+    end
+  end
+
+  describe "select_arrow/3" do
+    test "returns a schema, one batch and the end-of-stream marker", %{conn: conn} do
+      assert {:ok, ipc} = Natch.select_arrow(conn, "SELECT number FROM numbers(3)")
+
+      assert [{schema, <<>>}, {_batch, body}] = messages(ipc)
+      assert :binary.match(schema, "number") != :nomatch
+      assert :binary.match(body, <<0::64-little, 1::64-little, 2::64-little>>) != :nomatch
+      assert binary_part(ipc, byte_size(ipc), -8) == <<255, 255, 255, 255, 0, 0, 0, 0>>
+    end
+
+    test "one record batch per block", %{conn: conn} do
+      sql = "SELECT number FROM numbers(1000) SETTINGS max_block_size = 300"
+      assert {:ok, ipc} = Natch.select_arrow(conn, sql)
+
+      assert [_schema | batches] = messages(ipc)
+      assert length(batches) == 4
+    end
+
+    test "strings, nullables and arrays", %{conn: conn} do
+      sql = """
+      SELECT
+        toString(number) AS s,
+        if(number = 1, NULL, toInt32(number)) AS n,
+        range(number) AS a
+      FROM numbers(3)
+      """
+
+      assert {:ok, ipc} = Natch.select_arrow(conn, sql)
+      assert [_schema, {_batch, body}] = messages(ipc)
+
+      # Utf8 offsets and data
+      assert :binary.match(body, <<0::32-little, 1::32-little, 2::32-little, 3::32-little>>) !=
+               :nomatch
+
+      assert :binary.match(body, "012") != :nomatch
+      # Validity bitmap for n: rows 0 and 2 are valid
+      assert :binary.match(body, <<0b101, 0::56>>) != :nomatch
+      # List offsets for a: [], [0], [0, 1]
+      assert :binary.match(body, <<0::32-little, 0::32-little, 1::32-little, 3::32-little>>) !=
+               :nomatch
+    end
+
+    test "LowCardinality columns are dictionary encoded", %{conn: conn} do
+      sql = """
+      SELECT toLowCardinality(if(number % 2 = 0, 'even', 'odd')) AS parity
+      FROM numbers(4)
+      """
+
+      assert {:ok, ipc} = Natch.select_arrow(conn, sql)
+
+      # Schema, one dictionary batch, one record batch
+      assert [_schema, {_dictionary, dictionary_body}, {_batch, body}] = messages(ipc)
+      assert :binary.match(dictionary_body, "evenodd") != :nomatch
+
+      assert :binary.match(body, <<0::32-little, 1::32-little, 0::32-little, 1::32-little>>) !=
+               :nomatch
+    end
+
+    test "dates and timestamps", %{conn: conn} do
+      sql = """
+      SELECT
+        toDate('1970-01-11') AS d,
+        toDateTime('1970-01-01 00:01:40', 'UTC') AS dt,
+        toDateTime64('1970-01-01 00:00:01.5', 1, 'UTC') AS dt64
+      """
+
+      assert {:ok, ipc} = Natch.select_arrow(conn, sql)
+      assert [{schema, _}, {_batch, body}] = messages(ipc)
+
+      assert :binary.match(schema, "UTC") != :nomatch
+      assert :binary.match(body, <<10::32-little>>) != :nomatch
+      assert :binary.match(body, <<100::64-little>>) != :nomatch
+      # DateTime64(1) is exported in milliseconds
+      assert :binary.match(body, <<1500::64-little>>) != :nomatch
+    end
+
+    test "parameterized query", %{conn: conn} do
+      assert {:ok, ipc} = Natch.select_arrow(conn, "SELECT number FROM numbers({n})", n: 2)
+
+      assert [_schema, {_batch, body}] = messages(ipc)
+      assert :binary.match(body, <<0::64-little, 1::64-little>>) != :nomatch
+    end
+
+    test "empty result has a schema and no batches", %{conn: conn} do
+      assert {:ok, ipc} = Natch.select_arrow(conn, "SELECT number FROM numbers(0)")
+      assert [{schema, <<>>}] = messages(ipc)
+      assert :binary.match(schema, "number") != :nomatch
+    end
+
+    test "unsupported types return a validation error", %{conn: conn} do
+      assert {:error, %{type: "validation", message: message}} =
+               Natch.select_arrow(conn, "SELECT map('a', 1) AS m")
+
+      assert message =~ "unsupported column type for Arrow export"
+    end
+
+    test "server errors are returned", %{conn: conn} do
+      assert {:error, %{type: "server"}} = Natch.select_arrow(conn, "SELECT * FROM no_such_table")
+    end
+  end
+
+  # Explorer is not a dependency; these run when it is available
+  if Code.ensure_loaded?(Explorer.DataFrame) do
+    describe "with Explorer" do
+      test "load_ipc_stream! reads every column and block", %{conn: conn} do
+        sql = """
+        SELECT
+          number AS id,
+          toString(number) AS name,
+          if(number % 2 = 0, NULL, number / 2) AS score,
+          arrayMap(x -> toString(x), range(number % 3)) AS tags,
+          toLowCardinality(if(number % 2 = 0, 'even', 'odd')) AS kind,
+          toDate('2024-01-01') + number AS day
+        FROM numbers(5)
+        SETTINGS max_block_size = 2
+        """
+
+        {:ok, ipc} = Natch.select_arrow(conn, sql)
+        df = Explorer.DataFrame.load_ipc_stream!(ipc)
+
+        assert Explorer.DataFrame.n_rows(df) == 5
+
+        assert Explorer.DataFrame.to_columns(df) == %{
+                 "id" => [0, 1, 2, 3, 4],
+                 "name" => ["0", "1", "2", "3", "4"],
+                 "score" => [nil, 0.5, nil, 1.5, nil],
+                 "tags" => [[], ["0"], ["0", "1"], [], ["0"]],
+                 "kind" => ["even", "odd", "even", "odd", "even"],
+                 "day" => Enum.map(0..4, &Date.add(~D[2024-01-01], &1))
+               }
+      end
+    end
+  end
+end
@@ -0,0 +1,115 @@
+defmodule Natch.AsyncTest do
+  use ExUnit.Case, async: true
+
+  alias Natch.Async
+
+  setup do
+    # Generate unique table name for this test
+    table = "test_#{System.unique_integer([:positive, :monotonic])}_#{:rand.uniform(999_999)}"
+
+    # Start test connection
+    {:ok, conn} = Natch.start_link(host: "localhost", port: 9000)
+
+    on_exit(fn ->
+      # Clean up test table if it exists
+      if Process.alive?(conn) do
+        try do
+          Natch.execute(conn, "DROP TABLE IF EXISTS #{table}")
+        catch
+          :exit, _ -> :ok
+        end
+
+        # Use Process.exit to avoid race conditions
+        Process.exit(conn, :normal)
+      end
+    end)
+
+    {:ok, conn: conn, table: table}
+  end
+
+  describe "select" do
+    test "select_rows returns a reference and replies with rows", %{conn: conn} do
+      ref = Async.select_rows(conn, "SELECT number AS n FROM numbers(3)")
+      assert is_reference(ref)
+      assert {:ok, [%{n: 0}, %{n: 1}, %{n: 2}]} = Async.await(ref)
+    end
+
+    test "select_cols replies with columns", %{conn: conn} do
+      ref = Async.select_cols(conn, "SELECT number AS n, toString(number) AS s FROM numbers(3)")
+      assert {:ok, %{n: [0, 1, 2], s: ["0", "1", "2"]}} = Async.await(ref)
+    end
+
+    test "supports params and Query structs", %{conn: conn} do
+      ref = Async.select_rows(conn, "SELECT {x} AS x", x: 42)
+      assert {:ok, [%{x: 42}]} = Async.await(ref)
+
+      query = Natch.Query.new("SELECT {y:String} AS y") |> Natch.Query.bind(:y, "hi")
+      assert {:ok, [%{y: "hi"}]} = conn |> Async.select_rows(query) |> Async.await()
+    end
+
+    test "reply is a plain message", %{conn: conn} do
+      ref = Async.select_rows(conn, "SELECT 1 AS one")
+      assert_receive {:natch_async, ^ref, {:ok, [%{one: 1}]}}, 5_000
+    end
+
+    test "pipelines requests in submission order", %{conn: conn} do
+      refs = for i <- 1..20, do: Async.select_rows(conn, "SELECT #{i} AS i")
+
+      results = Enum.map(refs, &Async.await/1)
+      assert results == for(i <- 1..20, do: {:ok, [%{i: i}]})
+    end
+
+    test "many processes share one connection", %{conn: conn} do
+      tasks =
+        for i <- 1..10 do
+          Task.async(fn ->
+            conn |> Async.select_cols("SELECT #{i} AS i") |> Async.await()
+          end)
+        end
+
+      assert Task.await_many(tasks) == for(i <- 1..10, do: {:ok, %{i: [i]}})
+    end
+  end
+
+  describe "execute and insert" do
+    test "execute and insert_cols reply :ok", %{conn: conn, table: table} do
+      assert :ok =
+               conn
+               |> Async.execute("CREATE TABLE #{table} (id UInt64, name String) ENGINE = Memory")
+               |> Async.await()
+
+      assert :ok =
+               conn
+               |> Async.insert_cols(table, %{id: [1, 2], name: ["a", "b"]},
+                 id: :uint64,
+                 name: :string
+               )
+               |> Async.await()
+
+      assert {:ok, %{id: [1, 2], name: ["a", "b"]}} =
+               Natch.select_cols(conn, "SELECT * FROM #{table} ORDER BY id")
+    end
+
+    test "sync and async requests interleave", %{conn: conn} do
+      ref = Async.select_rows(conn, "SELECT sleep(0.2) AS s")
+      assert :ok = Natch.ping(conn)
+      assert {:ok, [_]} = Async.await(ref)
+    end
+  end
+
+  describe "errors" do
+    test "server errors are returned from await", %{conn: conn} do
+      ref = Async.select_rows(conn, "SELECT * FROM table_that_does_not_exist")
+      assert {:error, %{type: "server", message: message}} = Async.await(ref)
+      assert message =~ "table_that_does_not_exist"
+
+      # Connection still usable
+      assert {:ok, [%{x: 1}]} = conn |> Async.select_rows("SELECT 1 AS x") |> Async.await()
+    end
+
+    test "await times out", %{conn: conn} do
+      ref = Async.select_rows(conn, "SELECT sleep(1)")
+      assert catch_exit(Async.await(ref, 10)) == {:timeout, {Async, :await, [ref, 10]}}
+    end
+  end
+end
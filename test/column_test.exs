@@ -658,6 +658,37 @@ defmodule Natch.ColumnTest do
       :ok = Column.append_bulk(col, [1.5, 2.5, 3.5])
       assert Column.size(col) == 3
     end
+
+    test "can append values with nils to Nullable of any inner type" do
+      for {type, values} <- [
+            {:uint8, [1, nil, 3]},
+            {:int32, [nil, -2, nil]},
+            {:float32, [1.5, nil, 2]},
+            {:bool, [true, nil, false]},
+            {:date, [~D[2024-01-01], nil, 19_723]},
+            {:datetime, [nil, ~U[2024-01-01 10:00:00Z], nil]},
+            {:datetime64, [~U[2024-01-01 10:00:00.123456Z], nil, nil]},
+            {:uuid, ["550e8400-e29b-41d4-a716-446655440000", nil, <<1::128>>]},
+            {:decimal, [Decimal.new("1.5"), nil, 2]},
+            {{:enum8, [{"a", 1}, {"b", 2}]}, [nil, "b", "a"]},
+            {{:enum16, [{"a", 1}, {"b", 2}]}, [nil, 2, 1]}
+          ] do
+        col = Column.new({:nullable, type})
+        assert :ok = Column.append_bulk(col, values)
+        assert :ok = Column.append_bulk(col, [nil])
+        assert Column.size(col) == 4
+      end
+    end
+
+    test "validates the non-nil values with the inner type" do
+      col = Column.new({:nullable, :uint16})
+
+      assert_raise ArgumentError, ~r/0..65535 for UInt16 column/, fn ->
+        Column.append_bulk(col, [1, nil, 70_000])
+      end
+
+      assert Column.size(col) == 0
+    end
   end
 
   describe "Mixed operations" do
@@ -1143,6 +1174,103 @@ defmodule Natch.ColumnTest do
       assert_raise ArgumentError, ~r/Unknown enum name: maybe/, fn ->
         Column.append_bulk(col, ["yes", "maybe"])
       end
+
+      # Nothing is appended when a name is unknown
+      assert Column.size(col) == 0
+    end
+
+    test "appends Enum names given as atoms" do
+      col = Column.new({:enum16, [{"alpha", 100}, {"beta", 200}]})
+      Column.append_bulk(col, [:alpha, "beta", :beta])
+      assert Column.size(col) == 3
+
+      assert_raise ArgumentError, ~r/Unknown enum name: gamma/, fn ->
+        Column.append_bulk(col, [:gamma])
+      end
+    end
+  end
+
+  describe "Packed binary append" do
+    test "appends native-endian integers and floats" do
+      col = Column.new(:uint64)
+      assert :ok = Column.append_binary(col, <<1::unsigned-native-64, 2::unsigned-native-64>>)
+      assert :ok = Column.append_binary(col, <<3::unsigned-native-64>>)
+      assert Column.size(col) == 3
+
+      col = Column.new(:int16)
+      assert :ok = Column.append_binary(col, <<-1::signed-native-16, 7::signed-native-16>>)
+      assert Column.size(col) == 2
+
+      col = Column.new(:float32)
+      assert :ok = Column.append_binary(col, <<1.5::float-native-32>>)
+      assert Column.size(col) == 1
+    end
+
+    test "mixes with append_bulk" do
+      col = Column.new(:float64)
+      Column.append_bulk(col, [1.0, 2.0])
+      Column.append_binary(col, <<3.0::float-native-64, 4.0::float-native-64>>)
+      assert Column.size(col) == 4
+    end
+
+    test "appends dates, datetimes, decimals and bools" do
+      for {type, bin, count} <- [
+            {:date, <<19_723::unsigned-native-16>>, 1},
+            {:datetime, <<1_704_067_200::unsigned-native-32>>, 1},
+            {:datetime64, <<1::signed-native-64, 2::signed-native-64>>, 2},
+            {:decimal, <<123_000_000_000::signed-native-64>>, 1},
+            {:bool, <<1, 0, 1>>, 3}
+          ] do
+        col = Column.new(type)
+        assert :ok = Column.append_binary(col, bin)
+        assert Column.size(col) == count
+      end
+    end
+
+    test "empty binary appends nothing" do
+      col = Column.new(:int32)
+      assert :ok = Column.append_binary(col, <<>>)
+      assert Column.size(col) == 0
+    end
+
+    test "rejects a partial trailing value" do
+      col = Column.new(:uint32)
+
+      assert_raise Natch.ValidationError, ~r/not a multiple of the 4-byte value width/, fn ->
+        Column.append_binary(col, <<1, 2, 3, 4, 5>>)
+      end
+    end
+
+    test "appends {values, null_map} to Nullable columns" do
+      col = Column.new({:nullable, :int32})
+      values = <<1::signed-native-32, 0::signed-native-32, 3::signed-native-32>>
+      assert :ok = Column.append_binary(col, {values, <<0, 1, 0>>})
+      assert Column.size(col) == 3
+      assert Column.binary_type?({:nullable, :int32})
+      refute Column.binary_type?({:nullable, :string})
+    end
+
+    test "rejects a null map that does not match the values" do
+      col = Column.new({:nullable, :uint64})
+
+      assert_raise Natch.ValidationError, ~r/null map has 1 rows but 16 bytes of values/, fn ->
+        Column.append_binary(col, {<<1::native-64, 2::native-64>>, <<0>>})
+      end
+
+      # Nothing was appended, so the column is still consistent
+      assert Column.size(col) == 0
+      :ok = Column.append_binary(col, {<<1::native-64, 2::native-64>>, <<0, 1>>})
+      assert Column.size(col) == 2
+    end
+
+    test "rejects unsupported types and non-binaries" do
+      assert_raise ArgumentError, ~r/does not support column type :string/, fn ->
+        Column.append_binary(Column.new(:string), "abc")
+      end
+
+      assert_raise ArgumentError, ~r/requires a binary/, fn ->
+        Column.append_binary(Column.new(:uint64), [1, 2])
+      end
     end
   end
 end
@@ -0,0 +1,118 @@
+defmodule Natch.ConversionPlanTest do
+  use ExUnit.Case, async: true
+
+  setup do
+    # Start test connection
+    {:ok, conn} = Natch.start_link(host: "localhost", port: 9000)
+
+    on_exit(fn ->
+      if Process.alive?(conn) do
+        # Use Process.exit to avoid race conditions
+        Process.exit(conn, :normal)
+      end
+    end)
+
+    {:ok, conn: conn}
+  end
+
+  # Every supported type, nested types included, over several blocks
+  @sql """
+  SELECT
+    number AS u64,
+    toInt8(number % 100 - 50) AS i8,
+    toFloat32(number) / 4 AS f32,
+    toString(number) AS s,
+    toDate(number) AS d,
+    toDateTime(number, 'UTC') AS dt,
+    toDateTime64(number, 3, 'UTC') AS dt64,
+    toDecimal64(number, 2) AS dec,
+    toUUID('61f0c404-5cb3-11e7-907b-a6006ad3dba0') AS uuid,
+    CAST(number % 2, 'Enum8(\\'a\\' = 0, \\'b\\' = 1)') AS e,
+    toLowCardinality(toString(number % 3)) AS lc,
+    if(number % 2 = 0, NULL, toDate(number)) AS nd,
+    if(number % 2 = 0, NULL, toString(number)) AS ns,
+    [toNullable(number), NULL] AS arr,
+    tuple(number, [toString(number)]) AS t,
+    map(toString(number), number) AS m
+  FROM numbers(10000)
+  SETTINGS max_block_size = 3000
+  """
+
+  test "every select path converts the same result identically", %{conn: conn} do
+    {:ok, cols} = Natch.select_cols(conn, @sql)
+    names = Map.keys(cols)
+    to_columns = fn rows -> Map.new(names, fn name -> {name, Enum.map(rows, & &1[name])} end) end
+
+    {:ok, rows} = Natch.select_rows(conn, @sql)
+    assert to_columns.(rows) == cols
+
+    assert {:ok, ^cols} = Natch.select_cols(conn, @sql, [], convert: :yielding)
+    assert conn |> Natch.stream(@sql) |> Enum.to_list() |> List.flatten() == rows
+
+    {:ok, result} = Natch.select_result(conn, @sql)
+    for name <- names, do: assert(Natch.ResultSet.column(result, name) == cols[name])
+  end
+
+  test "Nullable of every scalar type writes nil for NULL rows", %{conn: conn} do
+    exprs = [
+      i32: "toInt32(number)",
+      u16: "toUInt16(number)",
+      f32: "toFloat32(number)",
+      d: "toDate(number)",
+      dt: "toDateTime(number, 'UTC')",
+      dt64: "toDateTime64(number, 3, 'UTC')",
+      dec: "toDecimal32(number, 2)",
+      uuid: "toUUID('61f0c404-5cb3-11e7-907b-a6006ad3dba0')",
+      e: "CAST(number % 2, 'Enum8(\\'a\\' = 0, \\'b\\' = 1)')",
+      s: "toString(number)"
+    ]
+
+    select = fn wrap ->
+      columns = Enum.map_join(exprs, ", ", fn {name, expr} -> "#{wrap.(expr)} AS #{name}" end)
+      Natch.select_cols(conn, "SELECT #{columns} FROM numbers(6)")
+    end
+
+    {:ok, values} = select.(& &1)
+    {:ok, nullable} = select.(&"if(number % 2 = 0, NULL, #{&1})")
+
+    for {name, _} <- exprs do
+      expected =
+        values[name]
+        |> Enum.with_index()
+        |> Enum.map(fn {value, i} -> if rem(i, 2) == 0, do: nil, else: value end)
+
+      assert nullable[name] == expected
+    end
+  end
+
+  test "cached plans are keyed by column types as well as names", %{conn: conn} do
+    for _ <- 1..3 do
+      assert {:ok, [%{x: 1}]} = Natch.select_rows(conn, "SELECT toUInt8(1) AS x")
+      assert {:ok, [%{x: "1"}]} = Natch.select_rows(conn, "SELECT '1' AS x")
+      nullable = "SELECT CAST(NULL, 'Nullable(Int32)') AS x"
+      assert {:ok, %{x: [nil]}} = Natch.select_cols(conn, nullable)
+      assert {:ok, %{x: [[1]]}} = Natch.select_cols(conn, "SELECT [1] AS x")
+    end
+  end
+
+  test "maps of varying sizes are sliced from the flattened keys and values", %{conn: conn} do
+    sql = """
+    SELECT
+      mapFromArrays(
+        arrayMap(i -> toString(i), range(number)),
+        arrayMap(i -> CAST(i % 2, 'Enum8(\\'a\\' = 0, \\'b\\' = 1)'), range(number))
+      ) AS m
+    FROM numbers(4)
+    """
+
+    expected = [%{}, %{"0" => :a}, %{"0" => :a, "1" => :b}, %{"0" => :a, "1" => :b, "2" => :a}]
+
+    for _ <- 1..2 do
+      assert {:ok, %{m: ^expected}} = Natch.select_cols(conn, sql, [], enum: :atom)
+    end
+  end
+
+  test "unsupported types only fail once there are rows to convert", %{conn: conn} do
+    assert {:ok, []} = Natch.select_rows(conn, "SELECT toIPv4('1.2.3.4') AS ip WHERE 0")
+  end
+end
@@ -0,0 +1,57 @@
+defmodule Natch.EnumFormatTest do
+  use ExUnit.Case, async: true
+
+  setup do
+    {:ok, conn} = Natch.start_link(host: "localhost", port: 9000)
+
+    on_exit(fn ->
+      if Process.alive?(conn) do
+        # Use Process.exit to avoid race conditions
+        Process.exit(conn, :normal)
+      end
+    end)
+
+    {:ok, conn: conn}
+  end
+
+  @sql """
+  SELECT
+    CAST(number % 2 + 1, 'Enum8(\\'small\\' = 1, \\'large\\' = 2)') AS size,
+    CAST(if(number = 1, NULL, 300), 'Nullable(Enum16(\\'wide\\' = 300))') AS width
+  FROM numbers(3)
+  """
+
+  test "enum values are binaries by default", %{conn: conn} do
+    assert {:ok, %{size: ["small", "large", "small"], width: ["wide", nil, "wide"]}} =
+             Natch.select_cols(conn, @sql)
+  end
+
+  test "enum: :atom returns atoms", %{conn: conn} do
+    assert {:ok, %{size: [:small, :large, :small], width: [:wide, nil, :wide]}} =
+             Natch.select_cols(conn, @sql, [], enum: :atom)
+
+    assert {:ok, [%{size: :small, width: :wide} | _]} =
+             Natch.select_rows(conn, @sql, [], enum: :atom)
+
+    assert {:ok, {[:size, :width], [{:small, :wide} | _]}} =
+             Natch.select_rows(conn, @sql, [], format: :tuples, enum: :atom)
+
+    assert {:ok, %{size: [:small, :large, :small]}} =
+             Natch.select_cols(conn, @sql, [], enum: :atom, convert: :yielding)
+  end
+
+  test "the enum format is per call on the same connection", %{conn: conn} do
+    assert {:ok, %{size: [:small | _]}} = Natch.select_cols(conn, @sql, [], enum: :atom)
+    assert {:ok, %{size: ["small" | _]}} = Natch.select_cols(conn, @sql)
+    assert {:ok, %{size: ["small" | _]}} = Natch.select_cols(conn, @sql, [], enum: :binary)
+    assert {:ok, [%{size: :small} | _]} = Natch.select_rows(conn, @sql, [], enum: :atom)
+  end
+
+  test "rejects unknown enum formats", %{conn: conn} do
+    assert_raise ArgumentError, fn -> Natch.select_cols(conn, @sql, [], enum: :string) end
+
+    assert_raise ArgumentError, fn ->
+      Natch.select_cols(conn, @sql, [], format: :binary, enum: :atom)
+    end
+  end
+end
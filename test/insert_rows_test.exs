@@ -0,0 +1,242 @@
+defmodule Natch.InsertRowsTest do
+  use ExUnit.Case, async: true
+
+  alias Natch.Block
+
+  setup do
+    # Generate unique table name for this test
+    table = "test_#{System.unique_integer([:positive, :monotonic])}_#{:rand.uniform(999_999)}"
+
+    # Start test connection
+    {:ok, conn} = Natch.start_link(host: "localhost", port: 9000)
+
+    on_exit(fn ->
+      # Clean up test table if it exists
+      if Process.alive?(conn) do
+        try do
+          Natch.execute(conn, "DROP TABLE IF EXISTS #{table}")
+        catch
+          :exit, _ -> :ok
+        end
+
+        # Use Process.exit to avoid race conditions
+        Process.exit(conn, :normal)
+      end
+    end)
+
+    {:ok, conn: conn, table: table}
+  end
+
+  describe "build_block_from_rows/2" do
+    test "map rows with atom or string keys and tuple rows" do
+      rows = [%{id: 1, name: "a"}, %{"id" => 2, "name" => "b"}, {3, "c"}]
+      block = Block.build_block_from_rows(rows, id: :uint64, name: :string)
+
+      assert Natch.Native.block_row_count(block) == 3
+      assert Natch.Native.block_column_count(block) == 2
+    end
+
+    test "empty rows build an empty block" do
+      block = Block.build_block_from_rows([], id: :uint64)
+      assert Natch.Native.block_row_count(block) == 0
+      assert Natch.Native.block_column_count(block) == 1
+    end
+
+    test "missing keys raise a validation error" do
+      assert_raise Natch.ValidationError, ~r/row 1 is missing column name/, fn ->
+        Block.build_block_from_rows([%{id: 1, name: "a"}, %{id: 2}], id: :uint64, name: :string)
+      end
+    end
+
+    test "wrong tuple sizes raise a validation error" do
+      assert_raise Natch.ValidationError, ~r/has 1 elements, expected 2/, fn ->
+        Block.build_block_from_rows([{1}], id: :uint64, name: :string)
+      end
+    end
+
+    test "values of the wrong type raise a validation error" do
+      assert_raise Natch.ValidationError, ~r/invalid value for column id .* at row 0/, fn ->
+        Block.build_block_from_rows([%{id: "one"}], id: :uint64)
+      end
+
+      assert_raise Natch.ValidationError, ~r/invalid value for column small/, fn ->
+        Block.build_block_from_rows([%{small: 300}], small: :int8)
+      end
+    end
+  end
+
+  describe "insert_rows/4" do
+    test "scalar types round-trip", %{conn: conn, table: table} do
+      Natch.execute!(conn, """
+      CREATE TABLE #{table} (
+        id UInt64, i32 Int32, i8 Int8, f64 Float64, f32 Float32, flag Bool,
+        name String, day Date, ts DateTime, ts64 DateTime64(6), uid UUID
+      ) ENGINE = Memory
+      """)
+
+      schema = [
+        id: :uint64,
+        i32: :int32,
+        i8: :int8,
+        f64: :float64,
+        f32: :float32,
+        flag: :bool,
+        name: :string,
+        day: :date,
+        ts: :datetime,
+        ts64: :datetime64,
+        uid: :uuid
+      ]
+
+      rows = [
+        %{
+          id: 1,
+          i32: -5,
+          i8: -128,
+          f64: 1.5,
+          f32: 2,
+          flag: true,
+          name: "Alice",
+          day: ~D[2024-02-29],
+          ts: ~U[2024-01-01 10:00:00Z],
+          ts64: ~U[2024-01-01 10:00:00.123456Z],
+          uid: "550e8400-e29b-41d4-a716-446655440000"
+        },
+        {2, 7, 127, 0.25, 0.5, false, "Bob", 19_000, 1_700_000_000, 1_700_000_000_000_001,
+         <<0::128>>}
+      ]
+
+      assert :ok = Natch.insert_rows(conn, table, rows, schema)
+
+      {:ok, [first, second]} = Natch.select_rows(conn, "SELECT * FROM #{table} ORDER BY id")
+
+      assert %{id: 1, i32: -5, i8: -128, f64: 1.5, f32: 2.0, flag: 1, name: "Alice"} = first
+      # Date, DateTime and DateTime64 are returned as days, seconds and ticks
+      assert first.day == Date.diff(~D[2024-02-29], ~D[1970-01-01])
+      assert first.ts == 1_704_103_200
+      assert first.ts64 == 1_704_103_200_123_456
+      assert first.uid == "550e8400-e29b-41d4-a716-446655440000"
+
+      assert %{id: 2, i32: 7, i8: 127, f64: 0.25, f32: 0.5, flag: 0, name: "Bob"} = second
+      assert %{day: 19_000, ts: 1_700_000_000, ts64: 1_700_000_000_000_001} = second
+      assert second.uid == "00000000-0000-0000-0000-000000000000"
+    end
+
+    test "non-UTC DateTime values are converted to Unix time", %{conn: conn, table: table} do
+      Natch.execute!(conn, "CREATE TABLE #{table} (ts DateTime('UTC')) ENGINE = Memory")
+
+      # 12:00 at +02:00 is 10:00 UTC
+      ts = %DateTime{
+        year: 2024,
+        month: 6,
+        day: 1,
+        hour: 12,
+        minute: 0,
+        second: 0,
+        microsecond: {0, 0},
+        time_zone: "Etc/GMT-2",
+        zone_abbr: "+02",
+        utc_offset: 7200,
+        std_offset: 0
+      }
+
+      assert :ok = Natch.insert_rows(conn, table, [%{ts: ts}], ts: :datetime)
+      expected = DateTime.to_unix(~U[2024-06-01 10:00:00Z])
+      assert {:ok, [%{ts: ^expected}]} = Natch.select_rows(conn, "SELECT ts FROM #{table}")
+    end
+
+    test "nullable columns", %{conn: conn, table: table} do
+      Natch.execute!(conn, """
+      CREATE TABLE #{table} (id UInt64, n Nullable(UInt32), s Nullable(String)) ENGINE = Memory
+      """)
+
+      rows = [%{id: 1, n: 5, s: nil}, %{id: 2, n: nil, s: "x"}]
+      schema = [id: :uint64, n: {:nullable, :uint32}, s: :nullable_string]
+
+      assert :ok = Natch.insert_rows(conn, table, rows, schema)
+
+      assert {:ok, [%{id: 1, n: 5, s: nil}, %{id: 2, n: nil, s: "x"}]} =
+               Natch.select_rows(conn, "SELECT * FROM #{table} ORDER BY id")
+    end
+
+    test "enum columns take names, atoms or values", %{conn: conn, table: table} do
+      Natch.execute!(conn, """
+      CREATE TABLE #{table} (
+        id UInt64,
+        size Enum8('small' = 1, 'large' = 2),
+        color Nullable(Enum16('red' = 100, 'blue' = 200))
+      ) ENGINE = Memory
+      """)
+
+      rows = [%{id: 1, size: "small", color: :blue}, {2, 2, nil}]
+
+      schema = [
+        id: :uint64,
+        size: {:enum8, [{"small", 1}, {"large", 2}]},
+        color: {:nullable, {:enum16, [{"red", 100}, {"blue", 200}]}}
+      ]
+
+      assert Natch.Column.row_type?(schema[:color])
+      assert :ok = Natch.insert_rows(conn, table, rows, schema)
+
+      assert {:ok, [%{size: "small", color: "blue"}, %{size: "large", color: nil}]} =
+               Natch.select_rows(conn, "SELECT * FROM #{table} ORDER BY id")
+
+      assert_raise Natch.ValidationError, ~r/invalid value for column size/, fn ->
+        Block.build_block_from_rows([%{id: 3, size: "medium", color: nil}], schema)
+      end
+    end
+
+    test "nested columns use the columnar fallback", %{conn: conn, table: table} do
+      Natch.execute!(conn, """
+      CREATE TABLE #{table} (id UInt64, tags Array(String), point Tuple(String, UInt64))
+      ENGINE = Memory
+      """)
+
+      rows = [
+        %{id: 1, tags: ["a", "b"], point: {"x", 1}},
+        {2, [], {"y", 2}}
+      ]
+
+      schema = [id: :uint64, tags: {:array, :string}, point: {:tuple, [:string, :uint64]}]
+
+      assert :ok = Natch.insert_rows(conn, table, rows, schema)
+
+      {:ok, [first, second]} = Natch.select_rows(conn, "SELECT * FROM #{table} ORDER BY id")
+      assert %{id: 1, tags: ["a", "b"], point: {"x", 1}} = first
+      assert %{id: 2, tags: [], point: {"y", 2}} = second
+    end
+
+    test "fallback columns keep their schema position", %{conn: conn, table: table} do
+      Natch.execute!(conn, """
+      CREATE TABLE #{table} (tags Array(String), id UInt64, point Tuple(String, UInt64))
+      ENGINE = Memory
+      """)
+
+      rows = [{["a"], 1, {"x", 1}}, %{tags: [], id: 2, point: {"y", 2}}]
+      schema = [tags: {:array, :string}, id: :uint64, point: {:tuple, [:string, :uint64]}]
+
+      block = Block.build_block_from_rows(rows, schema)
+      assert Natch.Native.block_column_count(block) == 3
+
+      assert :ok = Natch.insert_rows(conn, table, rows, schema)
+
+      {:ok, [first, second]} = Natch.select_rows(conn, "SELECT * FROM #{table} ORDER BY id")
+      assert %{tags: ["a"], id: 1, point: {"x", 1}} = first
+      assert %{tags: [], id: 2, point: {"y", 2}} = second
+    end
+
+    test "invalid rows return an error and keep the connection usable", %{
+      conn: conn,
+      table: table
+    } do
+      Natch.execute!(conn, "CREATE TABLE #{table} (id UInt64) ENGINE = Memory")
+
+      assert {:error, message} = Natch.insert_rows(conn, table, [%{id: -1}], id: :uint64)
+      assert message =~ "invalid value for column id"
+
+      assert :ok = Natch.insert_rows(conn, table, [%{id: 1}], id: :uint64)
+      assert {:ok, [%{id: 1}]} = Natch.select_rows(conn, "SELECT id FROM #{table}")
+    end
+  end
+end
@@ -0,0 +1,171 @@
+defmodule Natch.InsertStreamTest do
+  use ExUnit.Case, async: true
+
+  setup do
+    # Generate unique table name for this test
+    table = "test_#{System.unique_integer([:positive, :monotonic])}_#{:rand.uniform(999_999)}"
+
+    # Start test connection
+    {:ok, conn} = Natch.start_link(host: "localhost", port: 9000)
+
+    Natch.execute!(
+      conn,
+      "CREATE TABLE #{table} (id UInt64, name String) ENGINE = MergeTree ORDER BY id"
+    )
+
+    on_exit(fn ->
+      # Clean up test table if it exists
+      if Process.alive?(conn) do
+        try do
+          Natch.execute(conn, "DROP TABLE IF EXISTS #{table}")
+        catch
+          :exit, _ -> :ok
+        end
+
+        # Use Process.exit to avoid race conditions
+        Process.exit(conn, :normal)
+      end
+    end)
+
+    {:ok, conn: conn, table: table}
+  end
+
+  @schema [id: :uint64, name: :string]
+
+  defp count(conn, table) do
+    {:ok, [%{c: c}]} = Natch.select_rows(conn, "SELECT count() AS c FROM #{table}")
+    c
+  end
+
+  describe "insert_stream/5" do
+    test "rows are sent in batches over one INSERT", %{conn: conn, table: table} do
+      rows = Stream.map(1..10_000, fn i -> %{id: i, name: "row_#{i}"} end)
+
+      assert :ok = Natch.insert_stream(conn, table, rows, @schema, batch_size: 1_000)
+      assert count(conn, table) == 10_000
+
+      # One INSERT statement creates one part, not one per block
+      {:ok, [%{parts: parts}]} =
+        Natch.select_rows(conn, """
+        SELECT count() AS parts FROM system.parts
+        WHERE database = currentDatabase() AND table = '#{table}' AND active
+        """)
+
+      assert parts == 1
+    end
+
+    test "tuple rows and columnar chunks", %{conn: conn, table: table} do
+      assert :ok = Natch.insert_stream(conn, table, [{1, "a"}, {2, "b"}], @schema)
+
+      chunks = [%{id: [3, 4], name: ["c", "d"]}, %{name: ["e"], id: [5]}]
+      assert :ok = Natch.insert_stream(conn, table, chunks, @schema, format: :columns)
+
+      assert {:ok, %{id: [1, 2, 3, 4, 5], name: ["a", "b", "c", "d", "e"]}} =
+               Natch.select_cols(conn, "SELECT * FROM #{table} ORDER BY id")
+    end
+
+    test "empty enumerable", %{conn: conn, table: table} do
+      assert :ok = Natch.insert_stream(conn, table, [], @schema)
+      assert count(conn, table) == 0
+    end
+
+    test "the connection is busy while the insert is open", %{conn: conn, table: table} do
+      parent = self()
+
+      # The second row is produced after the first block has been sent
+      rows =
+        Stream.map(1..2, fn
+          1 ->
+            %{id: 1, name: "x"}
+
+          2 ->
+            send(parent, :inserting)
+            Process.sleep(200)
+            %{id: 2, name: "x"}
+        end)
+
+      task = Task.async(fn -> Natch.insert_stream(conn, table, rows, @schema, batch_size: 1) end)
+
+      assert_receive :inserting
+
+      assert {:error, %{type: "validation", message: message}} =
+               Natch.select_rows(conn, "SELECT 1")
+
+      assert message =~ "busy"
+
+      assert :ok = Task.await(task)
+      assert count(conn, table) == 2
+    end
+
+    test "requests waiting for the connection do not run inside a new insert", %{
+      conn: conn,
+      table: table
+    } do
+      {:ok, client} = Natch.Connection.get_client(conn)
+
+      # Holds the connection on the async worker while the next two wait for it
+      slow = Natch.Async.select_rows(conn, "SELECT sleep(1) AS s")
+      Process.sleep(100)
+      waiting = Task.async(fn -> Natch.select_rows(conn, "SELECT 1 AS one") end)
+      Process.sleep(100)
+
+      session =
+        Task.async(fn -> Natch.Native.client_insert_begin(client, table, ["id", "name"]) end)
+        |> Task.await()
+
+      block = Natch.Block.build_block_from_rows([%{id: 1, name: "x"}], @schema)
+      :ok = Natch.Native.insert_session_send_block(session, block)
+      assert Natch.Native.insert_session_finish(session) == 1
+
+      assert {:ok, [%{s: 0}]} = Natch.Async.await(slow)
+
+      # Whichever request got the connection first, the other one either ran
+      # before the INSERT was opened or failed fast as busy
+      case Task.await(waiting) do
+        {:ok, [%{one: 1}]} -> :ok
+        {:error, %{type: "validation", message: message}} -> assert message =~ "busy"
+      end
+
+      assert count(conn, table) == 1
+    end
+  end
+
+  describe "errors" do
+    test "invalid rows abort the insert", %{conn: conn, table: table} do
+      rows = Stream.concat([%{id: 1, name: "ok"}], [%{id: "bad", name: "x"}])
+
+      assert {:error, message} = Natch.insert_stream(conn, table, rows, @schema, batch_size: 1)
+      assert message =~ "invalid value for column id"
+
+      # The connection is released; only the block sent before the failure
+      # may have been written
+      assert count(conn, table) <= 1
+    end
+
+    test "exceptions from the enumerable abort the insert", %{conn: conn, table: table} do
+      rows =
+        Stream.map(1..3, fn
+          3 -> raise "source failed"
+          i -> %{id: i, name: "x"}
+        end)
+
+      assert {:error, "source failed"} =
+               Natch.insert_stream(conn, table, rows, @schema, batch_size: 1)
+
+      assert count(conn, table) <= 2
+    end
+
+    test "unknown tables return a server error", %{conn: conn} do
+      assert {:error, %{type: "server"}} =
+               Natch.insert_stream(conn, "table_that_does_not_exist", [{1, "a"}], @schema)
+
+      assert {:ok, [%{x: 1}]} = Natch.select_rows(conn, "SELECT 1 AS x")
+    end
+
+    test "invalid format raises", %{conn: conn, table: table} do
+      assert_raise ArgumentError, fn ->
+        Natch.insert_stream(conn, table, [], @schema, format: :nope)
+      end
+    end
+  end
+end
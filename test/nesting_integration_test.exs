@@ -474,4 +474,84 @@ defmodule Natch.NestingIntegrationTest do
              ]
     end
   end
+
+  describe "Array conversion by offsets" do
+    test "empty arrays and varying lengths in every select path", %{conn: conn} do
+      sql = "SELECT range(number % 4) AS a FROM numbers(6)"
+      expected = [[], [0], [0, 1], [0, 1, 2], [], [0]]
+
+      assert {:ok, %{a: ^expected}} = Natch.select_cols(conn, sql)
+      assert {:ok, rows} = Natch.select_rows(conn, sql)
+      assert Enum.map(rows, & &1.a) == expected
+      assert Natch.stream(conn, sql) |> Enum.map(& &1.a) == expected
+    end
+
+    test "Array(Array(T)) with empty inner and outer arrays", %{conn: conn} do
+      {:ok, %{a: a}} =
+        Natch.select_cols(
+          conn,
+          "SELECT arrayMap(x -> range(x), range(number)) AS a FROM numbers(4)"
+        )
+
+      assert a == [[], [[]], [[], [0]], [[], [0], [0, 1]]]
+    end
+
+    test "Array(Nullable(T)) for types without a dedicated nullable path", %{conn: conn} do
+      {:ok, %{a: a, d: d}} =
+        Natch.select_cols(conn, """
+        SELECT [toInt32(number), NULL] AS a,
+               [NULL, toDate('1970-01-01') + number] AS d
+        FROM numbers(2)
+        """)
+
+      assert a == [[0, nil], [1, nil]]
+      assert d == [[nil, 0], [nil, 1]]
+    end
+
+    test "arrays across multiple blocks", %{conn: conn} do
+      {:ok, %{a: a}} =
+        Natch.select_cols(
+          conn,
+          "SELECT [number, number * 2] AS a FROM numbers(30000) SETTINGS max_block_size = 4000"
+        )
+
+      assert length(a) == 30_000
+      assert Enum.at(a, 29_999) == [29_999, 59_998]
+    end
+  end
+
+  describe "Tuple and Map conversion in one pass" do
+    test "Tuple(Map, Tuple) and Map(String, Tuple)", %{conn: conn} do
+      sql = """
+      SELECT tuple(map('k', number), tuple(toString(number), [number])) AS t,
+             map('a', tuple(number, toNullable(toString(number)))) AS m
+      FROM numbers(3)
+      """
+
+      {:ok, %{t: t, m: m}} = Natch.select_cols(conn, sql)
+
+      assert t == [
+               {%{"k" => 0}, {"0", [0]}},
+               {%{"k" => 1}, {"1", [1]}},
+               {%{"k" => 2}, {"2", [2]}}
+             ]
+
+      assert m == [%{"a" => {0, "0"}}, %{"a" => {1, "1"}}, %{"a" => {2, "2"}}]
+      assert {:ok, rows} = Natch.select_rows(conn, sql)
+      assert Enum.map(rows, & &1.t) == t
+    end
+
+    test "empty maps and tuples of nullable elements", %{conn: conn} do
+      sql = """
+      SELECT mapFromArrays(arrayMap(x -> toString(x), range(number)), range(number)) AS m,
+             tuple(if(number = 1, NULL, number)) AS t
+      FROM numbers(3)
+      """
+
+      {:ok, %{m: m, t: t}} = Natch.select_cols(conn, sql)
+
+      assert m == [%{}, %{"0" => 0}, %{"0" => 0, "1" => 1}]
+      assert t == [{0}, {nil}, {2}]
+    end
+  end
 end
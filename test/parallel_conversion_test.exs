@@ -0,0 +1,87 @@
+defmodule Natch.ParallelConversionTest do
+  # Conversion settings are process-wide
+  use ExUnit.Case, async: false
+
+  setup do
+    # Generate unique table name for this test
+    table = "test_#{System.unique_integer([:positive, :monotonic])}_#{:rand.uniform(999_999)}"
+
+    # Start test connection
+    {:ok, conn} = Natch.start_link(host: "localhost", port: 9000)
+
+    Natch.execute!(conn, """
+    CREATE TABLE #{table} ENGINE = Memory AS
+    SELECT
+      number AS id,
+      toInt32(number) - 50000 AS i32,
+      number / 3 AS f64,
+      concat('name_', toString(number)) AS name,
+      if(number % 3 = 0, NULL, number) AS maybe,
+      toDate(number % 20000) AS d,
+      [number, number + 1] AS arr,
+      toLowCardinality(toString(number % 7)) AS lc
+    FROM numbers(100000)
+    """)
+
+    on_exit(fn ->
+      # Restore the default settings
+      Natch.Native.set_parallel_conversion(20_000, min(System.schedulers_online(), 8))
+
+      # Clean up test table if it exists
+      if Process.alive?(conn) do
+        try do
+          Natch.execute(conn, "DROP TABLE IF EXISTS #{table}")
+        catch
+          :exit, _ -> :ok
+        end
+
+        # Use Process.exit to avoid race conditions
+        Process.exit(conn, :normal)
+      end
+    end)
+
+    {:ok, conn: conn, table: table}
+  end
+
+  defp select_both(conn, sql) do
+    Natch.Native.set_parallel_conversion(0, 1)
+    {:ok, sequential} = Natch.select_cols(conn, sql)
+    {:ok, sequential_rows} = Natch.select_rows(conn, sql)
+
+    Natch.Native.set_parallel_conversion(1, 4)
+    {:ok, parallel} = Natch.select_cols(conn, sql)
+    {:ok, parallel_rows} = Natch.select_rows(conn, sql)
+
+    {sequential, parallel, sequential_rows, parallel_rows}
+  end
+
+  test "parallel and sequential conversion return the same result", %{conn: conn, table: table} do
+    {sequential, parallel, sequential_rows, parallel_rows} =
+      select_both(conn, "SELECT * FROM #{table} ORDER BY id")
+
+    assert parallel == sequential
+    assert parallel_rows == sequential_rows
+    assert length(parallel.id) == 100_000
+    assert Enum.take(parallel.maybe, 4) == [nil, 1, 2, nil]
+    assert Enum.at(parallel.arr, 10) == [10, 11]
+  end
+
+  test "single large columns are split into row ranges", %{conn: conn} do
+    sql = "SELECT number AS n FROM numbers(200000) SETTINGS max_block_size = 200000"
+    {sequential, parallel, _, _} = select_both(conn, sql)
+
+    assert parallel == sequential
+    assert parallel.n == Enum.to_list(0..199_999)
+  end
+
+  test "streams convert blocks in parallel", %{conn: conn, table: table} do
+    Natch.Native.set_parallel_conversion(1, 4)
+
+    ids =
+      conn
+      |> Natch.stream("SELECT id, name FROM #{table} ORDER BY id", format: :columns)
+      |> Enum.flat_map(& &1.id)
+
+    assert ids == Enum.to_list(0..99_999)
+  end
+end
@@ -0,0 +1,107 @@
+defmodule Natch.PoolTest do
+  use ExUnit.Case, async: true
+
+  alias Natch.Pool
+
+  setup do
+    # Generate unique table name for this test
+    table = "test_#{System.unique_integer([:positive, :monotonic])}_#{:rand.uniform(999_999)}"
+
+    # Start test pool
+    {:ok, pool} = Pool.start_link(host: "localhost", port: 9000, size: 4)
+
+    on_exit(fn ->
+      # Clean up test table if it exists
+      if Process.alive?(pool) do
+        Pool.execute(pool, "DROP TABLE IF EXISTS #{table}")
+
+        # Use Process.exit to avoid race conditions
+        Process.exit(pool, :normal)
+      end
+    end)
+
+    {:ok, pool: pool, table: table}
+  end
+
+  describe "queries" do
+    test "select_rows and select_cols", %{pool: pool} do
+      assert {:ok, [%{n: 0}, %{n: 1}]} = Pool.select_rows(pool, "SELECT number AS n FROM numbers(2)")
+      assert {:ok, %{n: [0, 1]}} = Pool.select_cols(pool, "SELECT number AS n FROM numbers(2)")
+    end
+
+    test "supports params and Query structs", %{pool: pool} do
+      assert {:ok, [%{x: 42}]} = Pool.select_rows(pool, "SELECT {x} AS x", x: 42)
+
+      query = Natch.Query.new("SELECT {y:String} AS y") |> Natch.Query.bind(:y, "hi")
+      assert {:ok, %{y: ["hi"]}} = Pool.select_cols(pool, query)
+    end
+
+    test "execute and insert_cols", %{pool: pool, table: table} do
+      assert :ok =
+               Pool.execute(pool, "CREATE TABLE #{table} (id UInt64, name String) ENGINE = Memory")
+
+      assert :ok =
+               Pool.insert_cols(pool, table, %{id: [1, 2], name: ["a", "b"]},
+                 id: :uint64,
+                 name: :string
+               )
+
+      assert {:ok, %{id: [1, 2], name: ["a", "b"]}} =
+               Pool.select_cols(pool, "SELECT * FROM #{table} ORDER BY id")
+    end
+  end
+
+  describe "concurrency" do
+    test "concurrent callers share the pool", %{pool: pool} do
+      tasks =
+        for i <- 1..20 do
+          Task.async(fn -> Pool.select_rows(pool, "SELECT #{i} AS i") end)
+        end
+
+      assert Task.await_many(tasks) == for(i <- 1..20, do: {:ok, [%{i: i}]})
+      assert %{size: 4, in_use: 0} = Pool.status(pool)
+    end
+
+    test "queries run in parallel across connections", %{pool: pool} do
+      {elapsed, results} =
+        :timer.tc(fn ->
+          1..4
+          |> Enum.map(fn _ -> Task.async(fn -> Pool.select_rows(pool, "SELECT sleep(0.5)") end) end)
+          |> Task.await_many()
+        end)
+
+      assert Enum.all?(results, &match?({:ok, [_]}, &1))
+      # Serialized execution would take at least 2 seconds
+      assert elapsed < 1_500_000
+    end
+
+    test "checkout times out when every connection is busy" do
+      {:ok, pool} = Pool.start_link(host: "localhost", port: 9000, size: 1, checkout_timeout: 100)
+
+      task = Task.async(fn -> Pool.select_rows(pool, "SELECT sleep(1)") end)
+      Process.sleep(100)
+
+      assert {:error, %{type: "validation", message: message}} =
+               Pool.select_rows(pool, "SELECT 1")
+
+      assert message =~ "pool checkout timed out"
+      assert {:ok, _} = Task.await(task)
+      Pool.stop(pool)
+    end
+  end
+
+  describe "errors" do
+    test "server errors leave the connection usable", %{pool: pool} do
+      assert {:error, %{type: "server"}} =
+               Pool.select_rows(pool, "SELECT * FROM table_that_does_not_exist")
+
+      assert {:ok, [%{x: 1}]} = Pool.select_rows(pool, "SELECT 1 AS x")
+      assert %{in_use: 0} = Pool.status(pool)
+    end
+
+    test "connection failures stop the pool from starting" do
+      Process.flag(:trap_exit, true)
+      assert {:error, _} = Pool.start_link(host: "localhost", port: 1, size: 2)
+    end
+  end
+end
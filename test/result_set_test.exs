@@ -0,0 +1,91 @@
+defmodule Natch.ResultSetTest do
+  use ExUnit.Case, async: true
+
+  alias Natch.ResultSet
+
+  setup do
+    # Start test connection
+    {:ok, conn} = Natch.start_link(host: "localhost", port: 9000)
+
+    on_exit(fn ->
+      if Process.alive?(conn) do
+        # Use Process.exit to avoid race conditions
+        Process.exit(conn, :normal)
+      end
+    end)
+
+    {:ok, conn: conn}
+  end
+
+  # Several blocks, so ranges cross block boundaries
+  @sql """
+  SELECT number AS id, toString(number) AS name, if(number % 2 = 0, NULL, number) AS odd
+  FROM numbers(1000)
+  SETTINGS max_block_size = 300
+  """
+
+  describe "select_result/3" do
+    test "row count and column names", %{conn: conn} do
+      assert {:ok, result} = Natch.select_result(conn, @sql)
+      assert ResultSet.row_count(result) == 1000
+      assert ResultSet.column_names(result) == [:id, :name, :odd]
+    end
+
+    test "column decodes one column across blocks", %{conn: conn} do
+      {:ok, result} = Natch.select_result(conn, @sql)
+      {:ok, cols} = Natch.select_cols(conn, @sql)
+
+      assert ResultSet.column(result, :id) == cols.id
+      assert ResultSet.column(result, "odd") == cols.odd
+    end
+
+    test "slice spans block boundaries", %{conn: conn} do
+      {:ok, result} = Natch.select_result(conn, @sql)
+      {:ok, rows} = Natch.select_rows(conn, @sql)
+
+      assert ResultSet.slice(result, 250, 100) == Enum.slice(rows, 250, 100)
+      assert ResultSet.slice(result, 990, 100) == Enum.slice(rows, 990, 10)
+      assert ResultSet.slice(result, 2000, 10) == []
+
+      assert %{id: ids, name: names} = ResultSet.slice(result, 299, 2, format: :columns)
+      assert ids == [299, 300]
+      assert names == ["299", "300"]
+    end
+
+    test "row", %{conn: conn} do
+      {:ok, result} = Natch.select_result(conn, @sql)
+
+      assert ResultSet.row(result, 0) == %{id: 0, name: "0", odd: nil}
+      assert ResultSet.row(result, 601) == %{id: 601, name: "601", odd: 601}
+      assert ResultSet.row(result, 1000) == nil
+    end
+
+    test "parameterized queries", %{conn: conn} do
+      {:ok, result} =
+        Natch.select_result(conn, "SELECT number AS n FROM numbers(10) WHERE n > {min}", min: 7)
+
+      assert ResultSet.column(result, :n) == [8, 9]
+    end
+
+    test "empty results keep the header", %{conn: conn} do
+      {:ok, result} = Natch.select_result(conn, "SELECT number AS n FROM numbers(0)")
+
+      assert ResultSet.row_count(result) == 0
+      assert ResultSet.column_names(result) == [:n]
+      assert ResultSet.column(result, :n) == []
+      assert ResultSet.slice(result, 0, 10, format: :columns) == %{n: []}
+    end
+
+    test "unknown columns raise", %{conn: conn} do
+      {:ok, result} = Natch.select_result(conn, @sql)
+
+      assert_raise Natch.ValidationError, ~r/unknown column/, fn ->
+        ResultSet.column(result, :missing)
+      end
+    end
+
+    test "server errors are returned", %{conn: conn} do
+      assert {:error, %{type: "server"}} = Natch.select_result(conn, "SELECT * FROM missing_xyz")
+    end
+  end
+end
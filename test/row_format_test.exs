@@ -0,0 +1,122 @@
+defmodule Natch.RowFormatTest do
+  use ExUnit.Case, async: true
+
+  defmodule User do
+    defstruct [:id, :name, active: true]
+  end
+
+  setup do
+    # Start test connection
+    {:ok, conn} = Natch.start_link(host: "localhost", port: 9000)
+
+    on_exit(fn ->
+      if Process.alive?(conn) do
+        # Use Process.exit to avoid race conditions
+        Process.exit(conn, :normal)
+      end
+    end)
+
+    {:ok, conn: conn}
+  end
+
+  @sql "SELECT number AS id, toString(number) AS name FROM numbers(3)"
+
+  describe "select_rows/4 :format" do
+    test ":tuples returns the column names once and tuple rows", %{conn: conn} do
+      assert {:ok, {[:id, :name], [{0, "0"}, {1, "1"}, {2, "2"}]}} =
+               Natch.select_rows(conn, @sql, [], format: :tuples)
+    end
+
+    test ":lists returns list rows", %{conn: conn} do
+      assert {:ok, {[:id, :name], [[0, "0"], [1, "1"], [2, "2"]]}} =
+               Natch.select_rows(conn, @sql, [], format: :lists)
+    end
+
+    test ":maps matches select_rows/3", %{conn: conn} do
+      assert Natch.select_rows(conn, @sql, [], format: :maps) == Natch.select_rows(conn, @sql)
+    end
+
+    test "empty results keep the column names", %{conn: conn} do
+      assert {:ok, {[:number], []}} =
+               Natch.select_rows(conn, "SELECT number FROM numbers(0)", [], format: :tuples)
+    end
+
+    test "multiple blocks and parameters", %{conn: conn} do
+      sql = "SELECT number FROM numbers({n}) SETTINGS max_block_size = 300"
+      assert {:ok, {[:number], rows}} = Natch.select_rows(conn, sql, [n: 1000], format: :tuples)
+      assert rows == Enum.map(0..999, &{&1})
+    end
+
+    test "yielding conversion supports the same formats", %{conn: conn} do
+      for format <- [:tuples, :lists] do
+        assert Natch.select_rows(conn, @sql, [], format: format, convert: :yielding) ==
+                 Natch.select_rows(conn, @sql, [], format: format)
+      end
+
+      assert {:ok, {[:number], []}} =
+               Natch.select_rows(conn, "SELECT number FROM numbers(0)", [],
+                 format: :lists,
+                 convert: :yielding
+               )
+    end
+
+    test "invalid format raises", %{conn: conn} do
+      assert_raise ArgumentError, fn ->
+        Natch.select_rows(conn, @sql, [], format: :columns)
+      end
+    end
+
+    test "server errors are returned", %{conn: conn} do
+      assert {:error, _} =
+               Natch.select_rows(conn, "SELECT * FROM no_such_table", [], format: :tuples)
+    end
+  end
+
+  describe "select_rows/4 :struct" do
+    test "builds structs with defaults for fields without a column", %{conn: conn} do
+      assert {:ok, [%User{id: 0, name: "0", active: true}, %User{id: 1} | _]} =
+               Natch.select_rows(conn, @sql, [], struct: User)
+    end
+
+    test ":fields maps columns to differently named fields", %{conn: conn} do
+      sql = "SELECT number AS user_id, number = 1 AS is_active FROM numbers({n})"
+
+      assert {:ok, [%User{id: 0, active: 0, name: nil}, %User{id: 1, active: 1}]} =
+               Natch.select_rows(conn, sql, [n: 2],
+                 struct: User,
+                 fields: [user_id: :id, is_active: :active]
+               )
+    end
+
+    test "columns without a field return a validation error", %{conn: conn} do
+      sql = "SELECT number AS id, 1 AS extra FROM numbers(1)"
+
+      assert {:error, %{type: "validation", message: message}} =
+               Natch.select_rows(conn, sql, [], struct: User)
+
+      assert message =~ "column extra is not a field of Elixir.Natch.RowFormatTest.User"
+    end
+
+    test "the connection stays usable after a field error", %{conn: conn} do
+      sql = "SELECT number AS id, 1 AS extra FROM numbers(100000) SETTINGS max_block_size = 1000"
+
+      assert {:error, %{type: "validation"}} = Natch.select_rows(conn, sql, [], struct: User)
+
+      assert {:ok, [%User{id: 0}, %User{id: 1}]} =
+               Natch.select_rows(conn, "SELECT number AS id FROM numbers(2)", [], struct: User)
+    end
+
+    test "empty results", %{conn: conn} do
+      assert {:ok, []} =
+               Natch.select_rows(conn, "SELECT number AS id FROM numbers(0)", [], struct: User)
+    end
+
+    test "invalid struct options raise", %{conn: conn} do
+      assert_raise ArgumentError, fn -> Natch.select_rows(conn, @sql, [], struct: String) end
+
+      assert_raise ArgumentError, fn ->
+        Natch.select_rows(conn, @sql, [], struct: User, format: :tuples)
+      end
+    end
+  end
+end
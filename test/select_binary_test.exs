@@ -0,0 +1,232 @@
+defmodule Natch.SelectBinaryTest do
+  use ExUnit.Case, async: true
+
+  setup do
+    # Generate unique table name for this test
+    table = "test_#{System.unique_integer([:positive, :monotonic])}_#{:rand.uniform(999_999)}"
+
+    # Start test connection
+    {:ok, conn} = Natch.start_link(host: "localhost", port: 9000)
+
+    on_exit(fn ->
+      # Clean up test table if it exists
+      if Process.alive?(conn) do
+        try do
+          Natch.execute(conn, "DROP TABLE IF EXISTS #{table}")
+        catch
+          :exit, _ -> :ok
+        end
+
+        # Use Process.exit to avoid race conditions
+        Process.exit(conn, :normal)
+      end
+    end)
+
+    {:ok, conn: conn, table: table}
+  end
+
+  defp select_binary(conn, sql, params \\ []) do
+    Natch.select_cols(conn, sql, params, format: :binary)
+  end
+
+  describe "fixed-width columns" do
+    test "integers are packed at their native width", %{conn: conn} do
+      {:ok, cols} =
+        select_binary(conn, """
+        SELECT toUInt8(number) AS u8, toUInt16(number) AS u16, toUInt32(number) AS u32,
+               toUInt64(number) AS u64, toInt8(-number) AS i8, toInt16(-number) AS i16,
+               toInt32(-number) AS i32, toInt64(-number) AS i64
+        FROM numbers(3)
+        """)
+
+      assert cols.u8 == <<0, 1, 2>>
+      assert for(<<v::unsigned-native-16 <- cols.u16>>, do: v) == [0, 1, 2]
+      assert for(<<v::unsigned-native-32 <- cols.u32>>, do: v) == [0, 1, 2]
+      assert for(<<v::unsigned-native-64 <- cols.u64>>, do: v) == [0, 1, 2]
+      assert for(<<v::signed-native-8 <- cols.i8>>, do: v) == [0, -1, -2]
+      assert for(<<v::signed-native-16 <- cols.i16>>, do: v) == [0, -1, -2]
+      assert for(<<v::signed-native-32 <- cols.i32>>, do: v) == [0, -1, -2]
+      assert for(<<v::signed-native-64 <- cols.i64>>, do: v) == [0, -1, -2]
+    end
+
+    test "floats", %{conn: conn} do
+      {:ok, cols} =
+        select_binary(
+          conn,
+          "SELECT toFloat64(number) / 2 AS f64, toFloat32(number) AS f32 FROM numbers(3)"
+        )
+
+      assert for(<<v::float-native-64 <- cols.f64>>, do: v) == [0.0, 0.5, 1.0]
+      assert for(<<v::float-native-32 <- cols.f32>>, do: v) == [0.0, 1.0, 2.0]
+    end
+
+    test "dates, datetimes and decimals", %{conn: conn} do
+      {:ok, cols} =
+        select_binary(conn, """
+        SELECT toDate('1970-01-02') AS d, toDateTime('1970-01-01 00:01:00', 'UTC') AS dt,
+               toDateTime64('1970-01-01 00:00:01.5', 3, 'UTC') AS dt64,
+               toDecimal64(12.34, 2) AS dec
+        """)
+
+      assert <<1::unsigned-native-16>> == cols.d
+      assert <<60::unsigned-native-32>> == cols.dt
+      assert <<1500::signed-native-64>> == cols.dt64
+      assert <<1234::signed-native-64>> == cols.dec
+    end
+
+    test "multiple blocks are concatenated into one binary", %{conn: conn} do
+      {:ok, %{n: n}} =
+        select_binary(
+          conn,
+          "SELECT number AS n FROM numbers(200000) SETTINGS max_block_size = 10000"
+        )
+
+      assert byte_size(n) == 200_000 * 8
+      assert <<0::unsigned-native-64, 1::unsigned-native-64, _::binary>> = n
+      assert binary_part(n, byte_size(n) - 8, 8) == <<199_999::unsigned-native-64>>
+    end
+
+    test "empty result", %{conn: conn} do
+      assert {:ok, %{n: <<>>}} = select_binary(conn, "SELECT number AS n FROM numbers(0)")
+    end
+  end
+
+  describe "nullable and fallback columns" do
+    test "nullable fixed-width columns return values and a null map", %{conn: conn} do
+      {:ok, %{v: {values, null_map}}} =
+        select_binary(conn, "SELECT if(number = 1, NULL, toInt32(number)) AS v FROM numbers(3)")
+
+      assert for(<<v::signed-native-32 <- values>>, do: v) == [0, 0, 2]
+      assert null_map == <<0, 1, 0>>
+    end
+
+    test "variable-width columns are returned as lists", %{conn: conn} do
+      {:ok, cols} =
+        select_binary(conn, "SELECT number AS n, toString(number) AS s FROM numbers(2)")
+
+      assert is_binary(cols.n)
+      assert cols.s == ["0", "1"]
+    end
+  end
+
+  describe "LowCardinality columns" do
+    test "decode through the dictionary for any inner type", %{conn: conn} do
+      {:ok, cols} =
+        Natch.select_cols(conn, """
+        SELECT
+          toLowCardinality(toString(number % 2)) AS s,
+          toLowCardinality(number % 3) AS n,
+          CAST(if(number = 1, NULL, toString(number % 2)), 'LowCardinality(Nullable(String))')
+            AS ns
+        FROM numbers(4)
+        """)
+
+      assert cols.s == ["0", "1", "0", "1"]
+      assert cols.n == [0, 1, 2, 0]
+      assert cols.ns == ["0", nil, "0", "1"]
+    end
+
+    test "binary format returns {dictionary, indices}", %{conn: conn} do
+      {:ok, %{s: {dictionary, indices}, ns: {nullable_dictionary, nullable_indices}}} =
+        select_binary(
+          conn,
+          """
+          SELECT
+            toLowCardinality(if(number % 2 = 0, 'even', 'odd')) AS s,
+            CAST(if(number = 1, NULL, 'x'), 'LowCardinality(Nullable(String))') AS ns
+          FROM numbers(1000)
+          SETTINGS max_block_size = 300
+          """
+        )
+
+      decode = fn dictionary, indices ->
+        for <<i::unsigned-native-32 <- indices>>, do: Enum.at(dictionary, i)
+      end
+
+      assert byte_size(indices) == 4000
+      assert "even" in dictionary and "odd" in dictionary
+      assert decode.(dictionary, indices) ==
+               Enum.map(0..999, &if(rem(&1, 2) == 0, do: "even", else: "odd"))
+      assert nil in nullable_dictionary
+
+      assert decode.(nullable_dictionary, nullable_indices) ==
+               Enum.map(0..999, &if(&1 == 1, do: nil, else: "x"))
+    end
+  end
+
+  describe "query forms" do
+    test "parameters and Query structs", %{conn: conn, table: table} do
+      Natch.execute(conn, "CREATE TABLE #{table} (id UInt64, value Float64) ENGINE = Memory")
+
+      :ok =
+        Natch.insert_cols(conn, table, %{id: [1, 2, 3], value: [1.5, 2.5, 3.5]},
+          id: :uint64,
+          value: :float64
+        )
+
+      {:ok, %{value: values}} =
+        select_binary(conn, "SELECT value FROM #{table} WHERE id > {id} ORDER BY id", id: 1)
+
+      assert for(<<v::float-native-64 <- values>>, do: v) == [2.5, 3.5]
+
+      query = Natch.Query.new("SELECT id FROM #{table} ORDER BY id")
+      assert {:ok, %{id: ids}} = Natch.select_cols(conn, query, [], format: :binary)
+      assert for(<<v::unsigned-native-64 <- ids>>, do: v) == [1, 2, 3]
+    end
+
+    test "packed binaries round-trip through insert_cols", %{conn: conn, table: table} do
+      Natch.execute(conn, "CREATE TABLE #{table} (id UInt32, value Float64) ENGINE = Memory")
+
+      ids = for i <- 1..1000, into: <<>>, do: <<i::unsigned-native-32>>
+      values = for i <- 1..1000, into: <<>>, do: <<i / 4::float-native-64>>
+
+      assert :ok =
+               Natch.insert_cols(conn, table, %{id: ids, value: values},
+                 id: :uint32,
+                 value: :float64
+               )
+
+      assert {:ok, %{id: ^ids, value: ^values}} =
+               select_binary(conn, "SELECT id, value FROM #{table} ORDER BY id")
+    end
+
+    test "nullable {values, null_map} round-trips through insert_cols", %{
+      conn: conn,
+      table: table
+    } do
+      Natch.execute(conn, "CREATE TABLE #{table} (id UInt32, d Nullable(Date)) ENGINE = Memory")
+
+      ids = for i <- 1..1000, into: <<>>, do: <<i::unsigned-native-32>>
+      days = for i <- 1..1000, into: <<>>, do: <<i::unsigned-native-16>>
+      null_map = for i <- 1..1000, into: <<>>, do: <<if(rem(i, 3) == 0, do: 1, else: 0)>>
+
+      assert :ok =
+               Natch.insert_cols(conn, table, %{id: ids, d: {days, null_map}},
+                 id: :uint32,
+                 d: {:nullable, :date}
+               )
+
+      {:ok, %{d: dates}} = Natch.select_cols(conn, "SELECT d FROM #{table} ORDER BY id")
+
+      assert dates ==
+               Enum.map(1..1000, fn i ->
+                 if rem(i, 3) == 0, do: nil, else: Date.add(~D[1970-01-01], i)
+               end)
+    end
+
+    test ":lists format matches select_cols/3", %{conn: conn} do
+      assert Natch.select_cols(conn, "SELECT {x} AS x", [x: 7], format: :lists) ==
+               Natch.select_cols(conn, "SELECT {x} AS x", x: 7)
+    end
+
+    test "invalid format raises", %{conn: conn} do
+      assert_raise ArgumentError, fn ->
+        Natch.select_cols(conn, "SELECT 1", [], format: :nope)
+      end
+    end
+
+    test "server errors are returned", %{conn: conn} do
+      assert {:error, _} = select_binary(conn, "SELECT * FROM table_that_does_not_exist")
+    end
+  end
+end
@@ -0,0 +1,179 @@
+defmodule Natch.StreamTest do
+  use ExUnit.Case, async: true
+
+  setup do
+    # Generate unique table name for this test
+    table = "test_#{System.unique_integer([:positive, :monotonic])}_#{:rand.uniform(999_999)}"
+
+    # Start test connection
+    {:ok, conn} = Natch.start_link(host: "localhost", port: 9000)
+
+    on_exit(fn ->
+      # Clean up test table if it exists
+      if Process.alive?(conn) do
+        try do
+          Natch.execute(conn, "DROP TABLE IF EXISTS #{table}")
+        catch
+          :exit, _ -> :ok
+        end
+
+        # Use Process.exit to avoid race conditions
+        Process.exit(conn, :normal)
+      end
+    end)
+
+    {:ok, conn: conn, table: table}
+  end
+
+  describe "stream/3 with :rows format" do
+    test "emits every row as a map", %{conn: conn} do
+      rows =
+        Natch.stream(conn, "SELECT number AS n, toString(number) AS s FROM numbers(10)")
+        |> Enum.to_list()
+
+      assert length(rows) == 10
+      assert hd(rows) == %{n: 0, s: "0"}
+      assert List.last(rows) == %{n: 9, s: "9"}
+    end
+
+    test "spans multiple blocks", %{conn: conn} do
+      count =
+        Natch.stream(
+          conn,
+          "SELECT number FROM numbers(300000) SETTINGS max_block_size = 10000"
+        )
+        |> Enum.reduce(0, fn %{number: _}, acc -> acc + 1 end)
+
+      assert count == 300_000
+    end
+
+    test "is lazy and can be halted early", %{conn: conn} do
+      stream = Natch.stream(conn, "SELECT number FROM system.numbers")
+
+      assert [%{number: 0}, %{number: 1}, %{number: 2}] = Enum.take(stream, 3)
+
+      # Connection is usable again once the stream is halted
+      assert :ok = Natch.ping(conn)
+    end
+
+    test "empty result produces empty stream", %{conn: conn} do
+      stream = Natch.stream(conn, "SELECT number FROM numbers(10) WHERE number > 100")
+      assert [] = Enum.to_list(stream)
+    end
+
+    test "supports params", %{conn: conn} do
+      rows =
+        Natch.stream(conn, "SELECT number FROM numbers(10) WHERE number >= {min}",
+          params: [min: 7]
+        )
+        |> Enum.to_list()
+
+      assert rows == [%{number: 7}, %{number: 8}, %{number: 9}]
+    end
+
+    test "supports Query structs", %{conn: conn} do
+      query =
+        Natch.Query.new("SELECT number FROM numbers(5) WHERE number < {max:UInt64}")
+        |> Natch.Query.bind(:max, 2)
+
+      assert [%{number: 0}, %{number: 1}] = Natch.stream(conn, query) |> Enum.to_list()
+    end
+  end
+
+  describe "stream/3 with :columns format" do
+    test "emits one columnar map per block", %{conn: conn} do
+      blocks =
+        Natch.stream(
+          conn,
+          "SELECT number, toString(number) AS s FROM numbers(25000) SETTINGS max_block_size = 10000",
+          format: :columns
+        )
+        |> Enum.to_list()
+
+      assert length(blocks) >= 3
+      assert Enum.all?(blocks, &match?(%{number: _, s: _}, &1))
+      assert blocks |> Enum.flat_map(& &1.number) == Enum.to_list(0..24_999)
+    end
+
+    test "handles complex types", %{conn: conn, table: table} do
+      Natch.execute!(conn, """
+      CREATE TABLE #{table} (
+        id UInt64,
+        tags Array(String),
+        score Nullable(Float64)
+      ) ENGINE = Memory
+      """)
+
+      Natch.insert_cols!(
+        conn,
+        table,
+        %{id: [1, 2], tags: [["a", "b"], []], score: [1.5, nil]},
+        id: :uint64,
+        tags: {:array, :string},
+        score: {:nullable, :float64}
+      )
+
+      assert [%{id: [1, 2], tags: [["a", "b"], []], score: [1.5, nil]}] =
+               Natch.stream(conn, "SELECT * FROM #{table} ORDER BY id", format: :columns)
+               |> Enum.to_list()
+    end
+  end
+
+  describe "errors" do
+    test "raises server errors while consuming", %{conn: conn} do
+      assert_raise Natch.ServerError, fn ->
+        Natch.stream(conn, "SELECT * FROM table_that_does_not_exist") |> Enum.to_list()
+      end
+
+      assert :ok = Natch.ping(conn)
+    end
+
+    test "connection is busy while a stream is open", %{conn: conn} do
+      stream = Natch.stream(conn, "SELECT number FROM numbers(1000000)")
+
+      result =
+        Enum.reduce_while(stream, nil, fn _row, _acc ->
+          {:halt, Natch.ping(conn)}
+        end)
+
+      assert {:error, %{type: "validation", message: message}} = result
+      assert message =~ "busy"
+      assert :ok = Natch.ping(conn)
+    end
+
+    test "an abandoned cursor releases the connection once collected", %{conn: conn} do
+      {:ok, client} = Natch.Connection.get_client(conn)
+
+      # The cursor is only referenced by the task, so it is collected when the
+      # task exits while its worker is blocked on a full queue
+      Task.async(fn ->
+        sql = "SELECT number FROM numbers(10000000)"
+        cursor = Natch.Native.client_select_open(client, sql, :rows)
+        assert is_list(Natch.Native.cursor_next_block(cursor))
+        :ok
+      end)
+      |> Task.await()
+
+      :erlang.garbage_collect()
+
+      assert :ok = ping_until_free(conn, 50)
+    end
+
+    test "rejects unknown formats", %{conn: conn} do
+      assert_raise ArgumentError, fn -> Natch.stream(conn, "SELECT 1", format: :tuples) end
+    end
+  end
+
+  defp ping_until_free(conn, 0), do: Natch.ping(conn)
+
+  defp ping_until_free(conn, attempts) do
+    case Natch.ping(conn) do
+      :ok ->
+        :ok
+
+      {:error, _} ->
+        Process.sleep(100)
+        ping_until_free(conn, attempts - 1)
+    end
+  end
+end
@@ -0,0 +1,88 @@
+defmodule Natch.StringResultsTest do
+  use ExUnit.Case, async: true
+
+  setup do
+    # Start test connection
+    {:ok, conn} = Natch.start_link(host: "localhost", port: 9000)
+
+    on_exit(fn ->
+      # Use Process.exit to avoid race conditions
+      if Process.alive?(conn), do: Process.exit(conn, :normal)
+    end)
+
+    {:ok, conn: conn}
+  end
+
+  describe "string values" do
+    test "short and long values around the heap binary limit", %{conn: conn} do
+      {:ok, %{s: values}} =
+        Natch.select_cols(conn, "SELECT repeat('a', number) AS s FROM numbers(130)")
+
+      assert values == for(n <- 0..129, do: String.duplicate("a", n))
+    end
+
+    test "long values are independent sub-binaries", %{conn: conn} do
+      {:ok, rows} =
+        Natch.select_rows(
+          conn,
+          "SELECT concat(toString(number), repeat('x', 100)) AS s FROM numbers(3)"
+        )
+
+      assert Enum.map(rows, & &1.s) == for(n <- 0..2, do: "#{n}" <> String.duplicate("x", 100))
+      assert Enum.all?(rows, &(byte_size(:binary.copy(&1.s)) == byte_size(&1.s)))
+    end
+
+    test "nullable strings keep nil in place", %{conn: conn} do
+      {:ok, %{s: values}} =
+        Natch.select_cols(
+          conn,
+          "SELECT if(number % 2 = 0, NULL, repeat('y', number * 20)) AS s FROM numbers(6)"
+        )
+
+      assert values == [
+               nil,
+               String.duplicate("y", 20),
+               nil,
+               String.duplicate("y", 60),
+               nil,
+               String.duplicate("y", 100)
+             ]
+    end
+
+    test "values spanning multiple blocks", %{conn: conn} do
+      {:ok, %{s: values}} =
+        Natch.select_cols(
+          conn,
+          "SELECT repeat(toString(number % 10), 70) AS s FROM numbers(50000) " <>
+            "SETTINGS max_block_size = 7000"
+        )
+
+      assert length(values) == 50_000
+      assert Enum.at(values, 49_999) == String.duplicate("9", 70)
+    end
+  end
+
+  describe "enum and low cardinality" do
+    test "enum names", %{conn: conn} do
+      {:ok, %{e: values}} =
+        Natch.select_cols(
+          conn,
+          "SELECT CAST(number % 2 AS Enum8('off' = 0, 'on' = 1)) AS e FROM numbers(3)"
+        )
+
+      assert values == ["off", "on", "off"]
+    end
+
+    test "low cardinality strings, including nullable", %{conn: conn} do
+      {:ok, %{lc: lc, nlc: nlc}} =
+        Natch.select_cols(conn, """
+        SELECT toLowCardinality(repeat('z', 80 + number)) AS lc,
+               CAST(if(number = 1, NULL, 'v'), 'LowCardinality(Nullable(String))') AS nlc
+        FROM numbers(3)
+        """)
+
+      assert lc == for(n <- 0..2, do: String.duplicate("z", 80 + n))
+      assert nlc == ["v", nil, "v"]
+    end
+  end
+end
@@ -0,0 +1,115 @@
+defmodule Natch.TensorTest do
+  use ExUnit.Case, async: true
+
+  setup do
+    # Generate unique table name for this test
+    table = "test_#{System.unique_integer([:positive, :monotonic])}_#{:rand.uniform(999_999)}"
+
+    # Start test connection
+    {:ok, conn} = Natch.start_link(host: "localhost", port: 9000)
+
+    on_exit(fn ->
+      # Clean up test table if it exists
+      if Process.alive?(conn) do
+        try do
+          Natch.execute(conn, "DROP TABLE IF EXISTS #{table}")
+        catch
+          :exit, _ -> :ok
+        end
+
+        # Use Process.exit to avoid race conditions
+        Process.exit(conn, :normal)
+      end
+    end)
+
+    {:ok, conn: conn, table: table}
+  end
+
+  # Nx is optional, so the raw column buffers are tested without it
+  describe "Connection.select_tensors/2" do
+    test "returns Nx types with native-endian buffers", %{conn: conn} do
+      sql = """
+      SELECT toUInt8(number) AS u8, toInt32(-number) AS i32, toFloat64(number) / 2 AS f64
+      FROM numbers(3)
+      """
+
+      assert {:ok, cols} = Natch.Connection.select_tensors(conn, sql)
+
+      assert cols.u8 == {{:u, 8}, <<0, 1, 2>>}
+      assert {{:s, 32}, i32} = cols.i32
+      assert for(<<v::signed-native-32 <- i32>>, do: v) == [0, -1, -2]
+      assert {{:f, 64}, f64} = cols.f64
+      assert for(<<v::float-native-64 <- f64>>, do: v) == [0.0, 0.5, 1.0]
+    end
+
+    test "blocks are appended into one buffer", %{conn: conn} do
+      sql = "SELECT number FROM numbers(1000) SETTINGS max_block_size = 300"
+      assert {:ok, %{number: {{:u, 64}, data}}} = Natch.Connection.select_tensors(conn, sql)
+
+      assert for(<<v::unsigned-native-64 <- data>>, do: v) == Enum.to_list(0..999)
+    end
+
+    test "empty result", %{conn: conn} do
+      sql = "SELECT number FROM numbers(0)"
+      assert {:ok, %{number: {{:u, 64}, <<>>}}} = Natch.Connection.select_tensors(conn, sql)
+    end
+
+    test "non-numeric columns return a validation error", %{conn: conn} do
+      sql = "SELECT toString(number) AS s FROM numbers(1)"
+
+      assert {:error, %{type: "validation", message: message}} =
+               Natch.Connection.select_tensors(conn, sql)
+
+      assert message =~ "cannot be returned as a tensor"
+    end
+  end
+
+  describe "UInt8 columns" do
+    test "insert_cols accepts lists and packed binaries", %{conn: conn, table: table} do
+      Natch.execute(conn, "CREATE TABLE #{table} (id UInt64, b UInt8) ENGINE = Memory")
+
+      :ok = Natch.insert_cols(conn, table, %{id: [1, 2], b: [0, 255]}, id: :uint64, b: :uint8)
+      :ok = Natch.insert_cols(conn, table, %{id: [3], b: <<7>>}, id: :uint64, b: :uint8)
+
+      {:ok, rows} = Natch.select_rows(conn, "SELECT b FROM #{table} ORDER BY id")
+      assert Enum.map(rows, & &1.b) == [0, 255, 7]
+    end
+
+    test "out of range values are rejected", %{conn: conn, table: table} do
+      Natch.execute(conn, "CREATE TABLE #{table} (b UInt8) ENGINE = Memory")
+
+      assert {:error, _} = Natch.insert_cols(conn, table, %{b: [256]}, b: :uint8)
+    end
+  end
+
+  if Code.ensure_loaded?(Nx) do
+    describe "with Nx" do
+      test "select_tensors/3 returns one tensor per column", %{conn: conn} do
+        sql = "SELECT number AS n, toFloat32(number) AS f FROM numbers({count})"
+        assert {:ok, %{n: n, f: f}} = Natch.select_tensors(conn, sql, count: 4)
+
+        assert Nx.to_flat_list(n) == [0, 1, 2, 3]
+        assert Nx.type(f) == {:f, 32}
+      end
+
+      test "insert_tensors/4 round trips", %{conn: conn, table: table} do
+        Natch.execute(conn, "CREATE TABLE #{table} (x Int64, y Float64) ENGINE = Memory")
+
+        x = Nx.iota({5}, type: {:s, 64})
+        y = Nx.divide(x, 2) |> Nx.as_type({:f, 64})
+        :ok = Natch.insert_tensors(conn, table, %{x: x, y: y})
+
+        {:ok, %{x: x2, y: y2}} =
+          Natch.select_tensors(conn, "SELECT x, y FROM #{table} ORDER BY x")
+        assert Nx.to_flat_list(x2) == Nx.to_flat_list(x)
+        assert Nx.to_flat_list(y2) == Nx.to_flat_list(y)
+      end
+
+      test "insert_tensors/4 rejects mismatched types", %{conn: conn, table: table} do
+        assert_raise ArgumentError, ~r/Nx.as_type/, fn ->
+          Natch.insert_tensors(conn, table, %{x: Nx.iota({3}, type: {:s, 32})}, x: :int64)
+        end
+      end
+    end
+  end
+end
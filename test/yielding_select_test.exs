@@ -0,0 +1,88 @@
+defmodule Natch.YieldingSelectTest do
+  use ExUnit.Case, async: true
+
+  setup do
+    # Start test connection
+    {:ok, conn} = Natch.start_link(host: "localhost", port: 9000)
+
+    on_exit(fn ->
+      if Process.alive?(conn) do
+        # Use Process.exit to avoid race conditions
+        Process.exit(conn, :normal)
+      end
+    end)
+
+    {:ok, conn: conn}
+  end
+
+  @sql """
+  SELECT
+    number AS id,
+    toString(number) AS name,
+    if(number % 3 = 0, NULL, number) AS maybe,
+    [number, number * 2] AS arr
+  FROM numbers(50000)
+  SETTINGS max_block_size = 7000
+  """
+
+  describe "convert: :yielding" do
+    test "returns the same rows and columns as dirty conversion", %{conn: conn} do
+      assert {:ok, dirty_rows} = Natch.select_rows(conn, @sql, [], [])
+      assert {:ok, yielding_rows} = Natch.select_rows(conn, @sql, [], convert: :yielding)
+      assert yielding_rows == dirty_rows
+      assert length(yielding_rows) == 50_000
+
+      assert Enum.at(yielding_rows, 7001) ==
+               %{id: 7001, name: "7001", maybe: 7001, arr: [7001, 14002]}
+
+      assert {:ok, dirty_cols} = Natch.select_cols(conn, @sql, [], [])
+      assert {:ok, yielding_cols} = Natch.select_cols(conn, @sql, [], convert: :yielding)
+      assert yielding_cols == dirty_cols
+      assert yielding_cols.id == Enum.to_list(0..49_999)
+    end
+
+    test "parameterized queries", %{conn: conn} do
+      sql = "SELECT number AS n FROM numbers(10) WHERE number >= {min}"
+
+      assert {:ok, [%{n: 8}, %{n: 9}]} =
+               Natch.select_rows(conn, sql, [min: 8], convert: :yielding)
+
+      assert {:ok, %{n: [8, 9]}} = Natch.select_cols(conn, sql, [min: 8], convert: :yielding)
+    end
+
+    test "empty results", %{conn: conn} do
+      sql = "SELECT number AS n FROM numbers(10) WHERE number > 100"
+
+      assert {:ok, []} = Natch.select_rows(conn, sql, [], convert: :yielding)
+      assert {:ok, cols} = Natch.select_cols(conn, sql, [], convert: :yielding)
+      assert cols == %{}
+    end
+
+    test "large conversions do not hold the scheduler", %{conn: conn} do
+      sql = "SELECT number AS a, number AS b, toString(number) AS c FROM numbers(2000000)"
+
+      :erlang.system_monitor(self(), [{:long_schedule, 100}])
+
+      try do
+        assert {:ok, %{a: a}} = Natch.select_cols(conn, sql, [], convert: :yielding)
+        assert length(a) == 2_000_000
+      after
+        :erlang.system_monitor(:undefined)
+      end
+
+      me = self()
+      refute_received {:monitor, ^me, :long_schedule, _}
+    end
+
+    test "server errors are returned", %{conn: conn} do
+      assert {:error, %{type: "server"}} =
+               Natch.select_rows(conn, "SELECT * FROM missing_table_xyz", [], convert: :yielding)
+    end
+
+    test "invalid :convert raises", %{conn: conn} do
+      assert_raise ArgumentError, fn ->
+        Natch.select_rows(conn, "SELECT 1", [], convert: :nope)
+      end
+    end
+  end
+end